@@ -27,6 +27,10 @@ static llama_context *g_ctx     = nullptr;
 static llama_sampler *g_sampler = nullptr;
 static std::atomic<bool> g_cancel{false};
 
+// Resolved once in JNI_OnLoad (interface method IDs are valid for any implementation)
+static jmethodID g_cb_on_token  = nullptr;  // LlmStreamInternal.onToken(String)
+static jmethodID g_cb_on_error  = nullptr;  // LlmStreamInternal.onError(String)
+
 // ═══════════════════════════════════════════════════════════════
 //                         Helpers
 // ═══════════════════════════════════════════════════════════════
@@ -252,34 +256,19 @@ Java_dev_deviceai_llm_engine_LlmJniEngine_nativeGenerateStream(
     g_cancel = false;
     std::string full = build_prompt(jRoles, jContents, env);
 
-    // Resolve LlmStreamInternal callback methods (onToken + onError only)
-    jclass cbClass      = env->GetObjectClass(jCallback);
-    jmethodID onToken   = env->GetMethodID(cbClass, "onToken", "(Ljava/lang/String;)V");
-    jmethodID onError   = env->GetMethodID(cbClass, "onError", "(Ljava/lang/String;)V");
-
-    if (!onToken || !onError) {
-        LOGE("Failed to find LlmStreamInternal methods");
-        return;
-    }
-
-    jobject globalCb = env->NewGlobalRef(jCallback);
-    JavaVM *jvm;
-    env->GetJavaVM(&jvm);
-
+    // Tokens are produced on this thread, so the caller's env and local
+    // callback ref stay valid for the whole generation — no per-token attach.
     do_generate(
         full, maxTokens, temperature, topP, topK, repeatPenalty,
         [&](const std::string &piece) -> bool {
-            JNIEnv *e;
-            jvm->AttachCurrentThread(&e, nullptr);
-            jstring jPiece = e->NewStringUTF(piece.c_str());
-            e->CallVoidMethod(globalCb, onToken, jPiece);
-            e->DeleteLocalRef(jPiece);
+            jstring jPiece = env->NewStringUTF(piece.c_str());
+            env->CallVoidMethod(jCallback, g_cb_on_token, jPiece);
+            env->DeleteLocalRef(jPiece);
             return !g_cancel.load();
         }
     );
 
     // Flow completes naturally when nativeGenerateStream returns — no onComplete JNI call needed.
-    env->DeleteGlobalRef(globalCb);
 }
 
 JNIEXPORT void JNICALL
@@ -287,4 +276,30 @@ Java_dev_deviceai_llm_engine_LlmJniEngine_nativeCancel(JNIEnv *, jobject) {
     g_cancel = true;
 }
 
+// ═══════════════════════════════════════════════════════════════
+//                    Library load / unload
+// ═══════════════════════════════════════════════════════════════
+
+JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM *vm, void *) {
+    JNIEnv *env = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6) != JNI_OK) {
+        return JNI_ERR;
+    }
+
+    jclass cbClass = env->FindClass("dev/deviceai/llm/engine/LlmStreamInternal");
+    if (!cbClass) {
+        LOGE("Failed to find LlmStreamInternal");
+        return JNI_ERR;
+    }
+    g_cb_on_token = env->GetMethodID(cbClass, "onToken", "(Ljava/lang/String;)V");
+    g_cb_on_error = env->GetMethodID(cbClass, "onError", "(Ljava/lang/String;)V");
+    env->DeleteLocalRef(cbClass);
+
+    if (!g_cb_on_token || !g_cb_on_error) {
+        LOGE("Failed to find LlmStreamInternal methods");
+        return JNI_ERR;
+    }
+    return JNI_VERSION_1_6;
+}
+
 } // extern "C"
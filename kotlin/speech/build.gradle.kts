@@ -293,6 +293,8 @@ extensions.configure<LibraryExtension> {
 
     defaultConfig {
         minSdk = libs.versions.android.minSdk.get().toInt()
+        // Keeps the classes and members JNI_OnLoad looks up by name in minified apps
+        consumerProguardFiles("consumer-rules.pro")
         ndk {
             abiFilters += setOf("arm64-v8a", "x86_64")
         }
@@ -0,0 +1,184 @@
+/**
+ * audio_checks.cpp - Host checks for the audio front end
+ *
+ * Runs without a model: FLAC decoding against the same samples stored as
+ * WAV, resampler gain, and the VAD packed-to-original time mapping.
+ * Usage: audio_checks <fixture dir>. Exits non-zero on the first failure.
+ */
+
+#include "resampler.h"
+#include "vad.h"
+#include "wav_reader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#define CHECK(cond, ...)                                             \
+    do {                                                             \
+        if (!(cond)) {                                               \
+            std::fprintf(stderr, "%s:%d: %s: ", __FILE__, __LINE__, #cond); \
+            std::fprintf(stderr, __VA_ARGS__);                       \
+            std::fprintf(stderr, "\n");                              \
+            std::exit(1);                                            \
+        }                                                            \
+    } while (0)
+
+static constexpr int SAMPLE_RATE = 16000;
+static constexpr int64_t SAMPLES_PER_MS = SAMPLE_RATE / 1000;
+
+// ═══════════════════════════════════════════════════════════════
+//                          FLAC DECODE
+// ═══════════════════════════════════════════════════════════════
+
+static std::vector<float> read_all(WavReader &reader) {
+    std::vector<float> samples;
+    float block[1000];
+    size_t n;
+    while ((n = reader.read_16k(block, 1000)) > 0) samples.insert(samples.end(), block, block + n);
+    return samples;
+}
+
+// The fixtures are 16 kHz, so both readers pass samples through unresampled
+// and the decoded FLAC must match the WAV exactly, per channel and downmixed.
+static void check_flac(const std::string &dir, const char *name) {
+    WavReader flac, wav;
+    CHECK(flac.open(dir + "/" + name + ".flac"), "%s.flac", name);
+    CHECK(wav.open(dir + "/" + name + ".wav"), "%s.wav", name);
+    CHECK(flac.channels() == wav.channels(), "%s: %d vs %d channels", name, flac.channels(), wav.channels());
+    CHECK(flac.total_frames() == wav.total_frames(), "%s: %lld vs %lld frames", name,
+          (long long)flac.total_frames(), (long long)wav.total_frames());
+
+    for (int channel = -1; channel < flac.channels(); channel++) {
+        flac.rewind();
+        wav.rewind();
+        CHECK(flac.select_channel(channel) && wav.select_channel(channel), "%s: channel %d", name, channel);
+        std::vector<float> got = read_all(flac), want = read_all(wav);
+        CHECK(!want.empty() && got.size() == want.size(), "%s ch%d: %zu vs %zu samples",
+              name, channel, got.size(), want.size());
+        for (size_t i = 0; i < got.size(); i++) {
+            CHECK(got[i] == want[i], "%s ch%d: sample %zu is %f, expected %f", name, channel, i, got[i], want[i]);
+        }
+    }
+    std::printf("flac %s: %d channel(s), %lld frames match\n", name, flac.channels(), (long long)flac.total_frames());
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                           RESAMPLER
+// ═══════════════════════════════════════════════════════════════
+
+static std::vector<float> resample_all(int in_rate, const std::vector<float> &in, size_t block) {
+    StreamingResampler resampler(in_rate);
+    std::vector<float> out;
+    for (size_t i = 0; i < in.size(); i += block) {
+        resampler.process(in.data() + i, std::min(block, in.size() - i), out);
+    }
+    resampler.flush(out);
+    return out;
+}
+
+// Unity gain at DC (away from the edges), an impulse that sums to the rate
+// ratio, the expected output length, and the same output whatever the
+// block size.
+static void check_resampler(int in_rate) {
+    const double ratio = (double)SAMPLE_RATE / in_rate;
+
+    std::vector<float> dc((size_t)in_rate, 1.0f);
+    std::vector<float> out = resample_all(in_rate, dc, dc.size());
+    const double want_len = dc.size() * ratio;
+    CHECK(std::fabs((double)out.size() - want_len) <= 1.0, "%d Hz: %zu samples out, expected %.1f",
+          in_rate, out.size(), want_len);
+    for (size_t i = out.size() / 4; i < out.size() * 3 / 4; i++) {
+        CHECK(std::fabs(out[i] - 1.0f) < 1e-3f, "%d Hz: DC gain %f at %zu", in_rate, out[i], i);
+    }
+
+    std::vector<float> impulse((size_t)in_rate / 10, 0.0f);
+    impulse[impulse.size() / 2] = 1.0f;
+    std::vector<float> response = resample_all(in_rate, impulse, impulse.size());
+    double sum = 0.0;
+    for (float v : response) sum += v;
+    CHECK(std::fabs(sum - ratio) < 1e-2 * ratio, "%d Hz: impulse sums to %f, expected %f", in_rate, sum, ratio);
+
+    std::vector<float> blocked = resample_all(in_rate, dc, 317);
+    CHECK(blocked == out, "%d Hz: block-by-block output differs", in_rate);
+    std::printf("resampler %d Hz: %zu samples, impulse sum %.4f\n", in_rate, out.size(), sum);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                          VAD REMAP
+// ═══════════════════════════════════════════════════════════════
+
+// Bursts of tone in low noise: packing drops the pauses, and every time
+// inside a piece maps back to where that sample came from.
+static void check_vad_remap() {
+    const int64_t tone_ms[][2] = {{1000, 2000}, {4000, 4600}, {7000, 8200}};
+    std::vector<float> audio((size_t)(9000 * SAMPLES_PER_MS));
+    uint32_t seed = 1;
+    for (size_t i = 0; i < audio.size(); i++) {
+        seed = seed * 1664525u + 1013904223u;
+        audio[i] = 0.002f * ((float)(seed >> 8) / (float)(1u << 24) - 0.5f);
+    }
+    for (const auto &tone : tone_ms) {
+        for (int64_t i = tone[0] * SAMPLES_PER_MS; i < tone[1] * SAMPLES_PER_MS; i++) {
+            audio[(size_t)i] += 0.3f * std::sin(2.0f * 3.14159265f * 440.0f * (float)i / SAMPLE_RATE);
+        }
+    }
+
+    std::vector<VadRegion> regions = vad_detect(audio.data(), audio.size());
+    CHECK(regions.size() == 3, "%zu speech regions, expected 3", regions.size());
+    for (size_t k = 0; k < regions.size(); k++) {
+        CHECK(regions[k].start <= tone_ms[k][0] * SAMPLES_PER_MS && regions[k].end >= tone_ms[k][1] * SAMPLES_PER_MS,
+              "region %zu [%lld, %lld) misses its tone", k, (long long)regions[k].start, (long long)regions[k].end);
+    }
+
+    VadPacked packed;
+    vad_pack(audio.data(), audio.size(), regions, packed);
+    CHECK(packed.pieces.size() == regions.size(), "%zu pieces", packed.pieces.size());
+    CHECK(packed.n_samples() < audio.size(), "packing kept %zu of %zu samples", packed.n_samples(), audio.size());
+
+    std::vector<SttSegment> segments;
+    for (const VadPacked::Piece &piece : packed.pieces) {
+        CHECK(piece.packed_start % SAMPLES_PER_MS == 0 && piece.orig_start % SAMPLES_PER_MS == 0,
+              "piece not on a millisecond");
+        for (int64_t i = 0; i < piece.length; i++) {
+            CHECK(packed.samples()[piece.packed_start + i] == audio[(size_t)(piece.orig_start + i)],
+                  "packed sample %lld", (long long)(piece.packed_start + i));
+        }
+        for (int64_t ms = 0; ms * SAMPLES_PER_MS < piece.length; ms += 7) {
+            int64_t packed_ms = piece.packed_start / SAMPLES_PER_MS + ms;
+            int64_t want = piece.orig_start / SAMPLES_PER_MS + ms;
+            CHECK(packed.to_original_ms(packed_ms, false) == want, "start %lld ms -> %lld, expected %lld",
+                  (long long)packed_ms, (long long)packed.to_original_ms(packed_ms, false), (long long)want);
+        }
+        // A segment spanning exactly one piece maps onto its region
+        int64_t t0 = piece.packed_start / SAMPLES_PER_MS;
+        segments.push_back({"", t0, t0 + piece.length / SAMPLES_PER_MS});
+    }
+
+    vad_remap(packed, segments);
+    for (size_t k = 0; k < segments.size(); k++) {
+        CHECK(segments[k].t0_ms == regions[k].start / SAMPLES_PER_MS && segments[k].t1_ms == regions[k].end / SAMPLES_PER_MS,
+              "segment %zu -> [%lld, %lld] ms, region [%lld, %lld) ms", k,
+              (long long)segments[k].t0_ms, (long long)segments[k].t1_ms,
+              (long long)(regions[k].start / SAMPLES_PER_MS), (long long)(regions[k].end / SAMPLES_PER_MS));
+    }
+    std::printf("vad: %zu regions, %zu of %zu samples packed, remap round-trips\n",
+                regions.size(), packed.n_samples(), audio.size());
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <fixture dir>\n", argv[0]);
+        return 2;
+    }
+    check_flac(argv[1], "mono16");
+    check_flac(argv[1], "stereo16");
+
+    for (int rate : {8000, 22050, 44100, 48000}) check_resampler(rate);
+
+    check_vad_remap();
+    return 0;
+}
@@ -0,0 +1,21 @@
+# Keep rules applied to apps that consume this library with R8/ProGuard.
+#
+# The native library resolves these classes and members by name in
+# JNI_OnLoad (jni_cache.cpp) and refuses to load if any is missing or renamed.
+
+# JNI entry points: Java_dev_deviceai_SpeechBridge_*
+-keepclasseswithmembernames,includedescriptorclasses class dev.deviceai.SpeechBridge {
+    native <methods>;
+}
+
+# Results constructed from native code
+-keep class dev.deviceai.TranscriptionResult { <init>(...); }
+-keep class dev.deviceai.Segment { <init>(...); }
+-keep class dev.deviceai.LanguageProbability { <init>(...); }
+
+# Callbacks invoked from native code
+-keep interface dev.deviceai.SttStream { <methods>; }
+-keep interface dev.deviceai.SttJobCallback { <methods>; }
+-keep interface dev.deviceai.SttListenerCallback { <methods>; }
+-keep interface dev.deviceai.SttModelCallback { <methods>; }
+-keep interface dev.deviceai.TtsStream { <methods>; }
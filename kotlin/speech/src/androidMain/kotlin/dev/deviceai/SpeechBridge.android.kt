@@ -4,6 +4,9 @@ import android.content.Context
 import androidx.compose.runtime.Composable
 import androidx.compose.ui.platform.LocalContext
 import java.io.File
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import java.util.concurrent.atomic.AtomicLong
 
 @Suppress("EXPECT_ACTUAL_CLASSIFIERS_ARE_IN_BETA_WARNING")
 actual object SpeechBridge {
@@ -16,6 +19,10 @@ actual object SpeechBridge {
     //                    SPEECH-TO-TEXT (STT)
     // ══════════════════════════════════════════════════════════════
 
+    // Phrases recognizeCommand falls back to, as given at init
+    @Volatile
+    private var initCommands: List<String> = emptyList()
+
     actual fun initStt(modelPath: String, config: SttConfig): Boolean =
         nativeInitStt(
             modelPath,
@@ -25,20 +32,199 @@ actual object SpeechBridge {
             config.useGpu,
             config.useVad,
             config.singleSegment,
-            config.noContext
+            config.noContext,
+            config.statePoolSize,
+            config.threadsPerState,
+            config.persistentState,
+            config.longForm,
+            config.warmUp,
+            config.pinDetectedLanguage,
+            config.resultCacheBytes,
+            config.resultCachePath,
+            config.modelMemoryBudgetBytes,
+            config.stopRepetitionLoops,
+            config.commands.toTypedArray()
+        ).also { if (it) initCommands = config.commands }
+
+    actual fun transcribe(audioPath: String, options: SttOptions): String =
+        nativeTranscribe(audioPath, options.modelPath, options.language, options.packedFlags(), options.timeoutMs ?: 0L)
+
+    actual fun transcribeDetailed(audioPath: String, options: SttOptions): TranscriptionResult =
+        nativeTranscribeDetailed(audioPath, options.modelPath, options.language, options.packedFlags(), options.timeoutMs ?: 0L)
+
+    actual fun transcribeAudio(samples: FloatArray, options: SttOptions): String =
+        nativeTranscribeAudio(samples, options.modelPath, options.language, options.packedFlags(), options.timeoutMs ?: 0L)
+
+    /**
+     * Transcribe PCM audio from a direct [ByteBuffer] without copying it into a FloatArray.
+     *
+     * Float32 samples are read in place; int16 samples (e.g. from AudioRecord)
+     * are converted in one SIMD pass. The buffer must be in native byte order
+     * (`ByteOrder.nativeOrder()`) and 16kHz mono. The samples between its
+     * position and limit are read, so a reused buffer filled by
+     * `AudioRecord.read(buffer, n)` and flipped works as is; the position is
+     * not changed.
+     *
+     * @param buffer Direct buffer holding the samples
+     * @param pcm16 True for 16-bit signed PCM, false for float32 in -1.0..1.0
+     * @param options Per-request overrides of the init settings
+     * @return Transcribed text
+     */
+    fun transcribeAudio(
+        buffer: ByteBuffer,
+        pcm16: Boolean = false,
+        options: SttOptions = SttOptions()
+    ): String {
+        require(buffer.isDirect) { "transcribeAudio requires a direct ByteBuffer" }
+        // allocateDirect() defaults to BIG_ENDIAN, which would decode as noise
+        require(buffer.order() == ByteOrder.nativeOrder()) {
+            "transcribeAudio requires a buffer in ByteOrder.nativeOrder()"
+        }
+        return nativeTranscribeAudioBuffer(
+            buffer, buffer.position(), buffer.remaining(), pcm16,
+            options.modelPath, options.language, options.packedFlags(), options.timeoutMs ?: 0L
+        )
+    }
+
+    actual fun detectLanguage(samples: FloatArray, topN: Int, options: SttOptions): List<LanguageProbability> =
+        nativeDetectLanguage(
+            samples, topN, options.modelPath, options.language, options.packedFlags(), options.timeoutMs ?: 0L
+        ).toList()
+
+    actual fun recognizeCommand(samples: FloatArray, commands: List<String>?, options: SttOptions): SttCommandMatch? {
+        val phrases = commands ?: initCommands
+        val index = nativeRecognizeCommand(
+            samples, commands?.toTypedArray(),
+            options.modelPath, options.language, options.packedFlags(), options.timeoutMs ?: 0L
+        )
+        return phrases.getOrNull(index)?.let { SttCommandMatch(index, it) }
+    }
+
+    actual fun transcribeBatch(clips: List<FloatArray>, options: SttOptions): List<TranscriptionResult> =
+        nativeTranscribeBatch(
+            clips.toTypedArray(), options.modelPath, options.language, options.packedFlags(), options.timeoutMs ?: 0L
+        ).toList()
+
+    actual fun transcribeFilesBatch(audioPaths: List<String>, options: SttOptions): List<TranscriptionResult> =
+        nativeTranscribeBatchFiles(
+            audioPaths.toTypedArray(), options.modelPath, options.language, options.packedFlags(), options.timeoutMs ?: 0L
+        ).toList()
+
+    actual fun transcribeAudioTasks(
+        samples: FloatArray,
+        tasks: List<SttTask>,
+        options: SttOptions
+    ): List<TranscriptionResult> =
+        nativeTranscribeAudioTasks(
+            samples,
+            tasks.map { it.language }.toTypedArray(),
+            tasks.map { task -> task.translateToEnglish?.let { if (it) 1 else 0 } ?: -1 }.toIntArray(),
+            tasks.map { it.prompt }.toTypedArray(),
+            options.modelPath, options.language, options.packedFlags(), options.timeoutMs ?: 0L
+        ).toList()
+
+    actual fun transcribeStream(samples: FloatArray, callback: SttStream, options: SttOptions) =
+        nativeTranscribeStream(samples, options.modelPath, options.language, options.packedFlags(), options.timeoutMs ?: 0L, callback)
+
+    actual fun openSttSession(callback: SttStream, options: SttOptions, finalModelPath: String?): SttSession? {
+        val handle = nativeSttSessionOpen(
+            options.modelPath, options.language, options.packedFlags(), finalModelPath, callback
+        )
+        return if (handle != 0L) JniSttSession(handle) else null
+    }
+
+    // Cleared once by close(). A call racing the close may still pass the
+    // old handle down; native code ignores closed handles.
+    private class JniSttSession(handle: Long) : SttSession {
+        private val handle = AtomicLong(handle)
+
+        override fun pushAudio(samples: FloatArray) {
+            val h = handle.get()
+            if (h != 0L) nativeSttSessionPush(h, samples)
+        }
+
+        override fun flush() {
+            val h = handle.get()
+            if (h != 0L) nativeSttSessionFlush(h)
+        }
+
+        override fun stats(): SttSessionStats {
+            val values = nativeSttSessionStats(handle.get())
+            return SttSessionStats(values[0], values[1], values[2], values[3])
+        }
+
+        override fun close() {
+            val h = handle.getAndSet(0L)
+            if (h != 0L) nativeSttSessionClose(h)
+        }
+    }
+
+    actual fun startListening(
+        callback: SttListenerCallback,
+        options: SttOptions,
+        config: SttListenerConfig
+    ): SttListener? {
+        val handle = nativeListenerOpen(
+            options.modelPath, options.language, options.packedFlags(), options.timeoutMs ?: 0L,
+            config.preRollMs, config.endSilenceMs, config.minSpeechMs, config.maxUtteranceMs,
+            callback
         )
+        return if (handle != 0L) JniSttListener(handle) else null
+    }
+
+    // Cleared once by close(), like JniSttSession's handle.
+    private class JniSttListener(handle: Long) : SttListener {
+        private val handle = AtomicLong(handle)
+
+        override fun pushAudio(samples: FloatArray) {
+            val h = handle.get()
+            if (h != 0L) nativeListenerPush(h, samples)
+        }
+
+        override fun close() {
+            val h = handle.getAndSet(0L)
+            if (h != 0L) nativeListenerClose(h)
+        }
+    }
+
+    actual fun submitTranscription(
+        audioPath: String,
+        priority: SttPriority,
+        options: SttOptions,
+        callback: SttJobCallback
+    ): Long = nativeSubmitTranscription(
+        audioPath, priority.ordinal, options.modelPath, options.language, options.packedFlags(), options.timeoutMs ?: 0L, callback
+    )
+
+    actual fun submitTranscriptionAudio(
+        samples: FloatArray,
+        priority: SttPriority,
+        options: SttOptions,
+        callback: SttJobCallback
+    ): Long = nativeSubmitTranscriptionAudio(
+        samples, priority.ordinal, options.modelPath, options.language, options.packedFlags(), options.timeoutMs ?: 0L, callback
+    )
 
-    actual fun transcribe(audioPath: String): String =
-        nativeTranscribe(audioPath)
+    actual fun cancelSttJob(jobId: Long): Boolean = nativeCancelSttJob(jobId)
+
+    actual fun getSttCacheStats(): SttCacheStats {
+        val values = nativeGetSttCacheStats()
+        return SttCacheStats(values[0], values[1], values[2], values[3], values[4])
+    }
+
+    actual fun clearSttCache() = nativeClearSttCache()
+
+    actual fun getSttLoopStats(): SttLoopStats {
+        val values = nativeGetSttLoopStats()
+        return SttLoopStats(values[0], values[1])
+    }
 
-    actual fun transcribeDetailed(audioPath: String): TranscriptionResult =
-        nativeTranscribeDetailed(audioPath)
+    actual fun loadSttModel(modelPath: String, activate: Boolean, callback: SttModelCallback?): Boolean =
+        nativeLoadSttModel(modelPath, activate, callback)
 
-    actual fun transcribeAudio(samples: FloatArray): String =
-        nativeTranscribeAudio(samples)
+    actual fun unloadSttModel(modelPath: String): Boolean = nativeUnloadSttModel(modelPath)
 
-    actual fun transcribeStream(samples: FloatArray, callback: SttStream) =
-        nativeTranscribeStream(samples, callback)
+    actual fun residentSttModels(): List<String> = nativeResidentSttModels().toList()
 
     actual fun cancelStt() = nativeCancelStt()
 
@@ -108,15 +294,151 @@ actual object SpeechBridge {
         useGpu: Boolean,
         useVad: Boolean,
         singleSegment: Boolean,
-        noContext: Boolean
+        noContext: Boolean,
+        statePoolSize: Int,
+        threadsPerState: Int,
+        persistentState: Boolean,
+        longForm: Boolean,
+        warmUp: Boolean,
+        pinLanguage: Boolean,
+        resultCacheBytes: Long,
+        resultCachePath: String,
+        modelBudgetBytes: Long,
+        stopRepetitionLoops: Boolean,
+        commands: Array<String>
     ): Boolean
 
-    private external fun nativeTranscribe(audioPath: String): String
-    private external fun nativeTranscribeDetailed(audioPath: String): TranscriptionResult
-    private external fun nativeTranscribeAudio(samples: FloatArray): String
-    private external fun nativeTranscribeStream(samples: FloatArray, callback: SttStream)
+    // Each transcription takes the SttOptions overrides as (model, language, packedFlags, timeoutMs)
+    private external fun nativeTranscribe(
+        audioPath: String,
+        optModel: String?,
+        optLanguage: String?,
+        optFlags: Int,
+        optTimeoutMs: Long
+    ): String
+    private external fun nativeTranscribeDetailed(
+        audioPath: String,
+        optModel: String?,
+        optLanguage: String?,
+        optFlags: Int,
+        optTimeoutMs: Long
+    ): TranscriptionResult
+    private external fun nativeTranscribeAudio(
+        samples: FloatArray,
+        optModel: String?,
+        optLanguage: String?,
+        optFlags: Int,
+        optTimeoutMs: Long
+    ): String
+    private external fun nativeTranscribeAudioBuffer(
+        buffer: ByteBuffer,
+        byteOffset: Int,
+        byteLength: Int,
+        pcm16: Boolean,
+        optModel: String?,
+        optLanguage: String?,
+        optFlags: Int,
+        optTimeoutMs: Long
+    ): String
+    private external fun nativeTranscribeStream(
+        samples: FloatArray,
+        optModel: String?,
+        optLanguage: String?,
+        optFlags: Int,
+        optTimeoutMs: Long,
+        callback: SttStream
+    )
+    private external fun nativeDetectLanguage(
+        samples: FloatArray,
+        topN: Int,
+        optModel: String?,
+        optLanguage: String?,
+        optFlags: Int,
+        optTimeoutMs: Long
+    ): Array<LanguageProbability>
+    private external fun nativeRecognizeCommand(
+        samples: FloatArray,
+        commands: Array<String>?,
+        optModel: String?,
+        optLanguage: String?,
+        optFlags: Int,
+        optTimeoutMs: Long
+    ): Int
+    private external fun nativeTranscribeBatch(
+        clips: Array<FloatArray>,
+        optModel: String?,
+        optLanguage: String?,
+        optFlags: Int,
+        optTimeoutMs: Long
+    ): Array<TranscriptionResult>
+    private external fun nativeTranscribeBatchFiles(
+        audioPaths: Array<String>,
+        optModel: String?,
+        optLanguage: String?,
+        optFlags: Int,
+        optTimeoutMs: Long
+    ): Array<TranscriptionResult>
+    private external fun nativeTranscribeAudioTasks(
+        samples: FloatArray,
+        taskLanguages: Array<String?>,
+        taskTranslate: IntArray,
+        taskPrompts: Array<String?>,
+        optModel: String?,
+        optLanguage: String?,
+        optFlags: Int,
+        optTimeoutMs: Long
+    ): Array<TranscriptionResult>
+    private external fun nativeSubmitTranscription(
+        audioPath: String,
+        priority: Int,
+        optModel: String?,
+        optLanguage: String?,
+        optFlags: Int,
+        optTimeoutMs: Long,
+        callback: SttJobCallback
+    ): Long
+    private external fun nativeSubmitTranscriptionAudio(
+        samples: FloatArray,
+        priority: Int,
+        optModel: String?,
+        optLanguage: String?,
+        optFlags: Int,
+        optTimeoutMs: Long,
+        callback: SttJobCallback
+    ): Long
+    private external fun nativeCancelSttJob(jobId: Long): Boolean
+    private external fun nativeGetSttCacheStats(): LongArray
+    private external fun nativeClearSttCache()
+    private external fun nativeGetSttLoopStats(): LongArray
+    private external fun nativeLoadSttModel(modelPath: String, activate: Boolean, callback: SttModelCallback?): Boolean
+    private external fun nativeUnloadSttModel(modelPath: String): Boolean
+    private external fun nativeResidentSttModels(): Array<String>
     private external fun nativeCancelStt()
     private external fun nativeShutdownStt()
+    private external fun nativeSttSessionOpen(
+        optModel: String?,
+        optLanguage: String?,
+        optFlags: Int,
+        finalModel: String?,
+        callback: SttStream
+    ): Long
+    private external fun nativeSttSessionPush(handle: Long, samples: FloatArray)
+    private external fun nativeSttSessionFlush(handle: Long)
+    private external fun nativeSttSessionClose(handle: Long)
+    private external fun nativeSttSessionStats(handle: Long): LongArray
+    private external fun nativeListenerOpen(
+        optModel: String?,
+        optLanguage: String?,
+        optFlags: Int,
+        optTimeoutMs: Long,
+        preRollMs: Int,
+        endSilenceMs: Int,
+        minSpeechMs: Int,
+        maxUtteranceMs: Int,
+        callback: SttListenerCallback
+    ): Long
+    private external fun nativeListenerPush(handle: Long, samples: FloatArray)
+    private external fun nativeListenerClose(handle: Long)
 
     // TTS
     private external fun nativeInitTts(
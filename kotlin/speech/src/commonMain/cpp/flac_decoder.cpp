@@ -0,0 +1,477 @@
+/**
+ * flac_decoder.cpp - Streaming FLAC decoder
+ */
+
+#include "flac_decoder.h"
+#include "stt_common.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_ARM64))
+#include <intrin.h>
+#endif
+
+// Leading zero bits of a non-zero word.
+static inline int clz64(uint64_t w) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(w);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long index;
+    _BitScanReverse64(&index, w);
+    return 63 - (int)index;
+#else
+    int n = 0;
+    for (; !(w & 0x8000000000000000ull); w <<= 1) n++;
+    return n;
+#endif
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                          BIT READER
+// ═══════════════════════════════════════════════════════════════
+
+// MSB-first reader over a byte range. Reads past the end return zero bits
+// and make ok() false.
+class FlacBits {
+public:
+    FlacBits(const uint8_t *data, size_t size, size_t byte) : data_(data), size_(size), bit_(byte * 8) {}
+
+    bool ok() const { return bit_ <= size_ * 8; }
+    size_t byte() const { return bit_ >> 3; }
+    void align() { bit_ = (bit_ + 7) & ~(size_t)7; }
+
+    // n in [0, 32]
+    uint32_t read(int n) {
+        if (n == 0) return 0;
+        uint64_t w = load(bit_ >> 3) << (bit_ & 7);
+        bit_ += (size_t)n;
+        return (uint32_t)(w >> (64 - n));
+    }
+
+    int32_t read_signed(int n) {
+        if (n == 0) return 0;
+        uint32_t v = read(n);
+        return n == 32 ? (int32_t)v : (int32_t)(v << (32 - n)) >> (32 - n);
+    }
+
+    // Zeros before the next one bit, which is consumed.
+    uint32_t read_unary() {
+        uint32_t zeros = 0;
+        while (ok()) {
+            const int skip = (int)(bit_ & 7);
+            uint64_t w = load(bit_ >> 3) << skip;
+            if (w == 0) {
+                zeros += (uint32_t)(64 - skip);
+                bit_ += (size_t)(64 - skip);
+                continue;
+            }
+            const int z = clz64(w);
+            bit_ += (size_t)z + 1;
+            return zeros + (uint32_t)z;
+        }
+        return zeros;
+    }
+
+private:
+    // 8 bytes big-endian from `byte`, zero-padded past the end.
+    uint64_t load(size_t byte) const {
+        uint64_t w = 0;
+        if (byte + 8 <= size_) {
+            for (int i = 0; i < 8; i++) w = (w << 8) | data_[byte + i];
+            return w;
+        }
+        for (int i = 0; i < 8; i++) w = (w << 8) | (byte + i < size_ ? data_[byte + i] : 0);
+        return w;
+    }
+
+    const uint8_t *data_;
+    size_t size_;
+    size_t bit_;
+};
+
+// ═══════════════════════════════════════════════════════════════
+//                           SUBFRAMES
+// ═══════════════════════════════════════════════════════════════
+
+// Residual of a predicted subframe, after the `order` warm-up samples.
+static bool decode_residual(FlacBits &bits, size_t block_size, int order, int32_t *out) {
+    const uint32_t method = bits.read(2);
+    if (method > 1) return false;
+    const int param_bits = method == 0 ? 4 : 5;
+    const uint32_t escape = method == 0 ? 15 : 31;
+    const int partition_order = (int)bits.read(4);
+    const size_t per_partition = block_size >> partition_order;
+    if ((per_partition << partition_order) != block_size || per_partition < (size_t)order) return false;
+
+    size_t i = (size_t)order;
+    for (size_t p = 0; p < ((size_t)1 << partition_order); p++) {
+        const size_t n = per_partition - (p == 0 ? (size_t)order : 0);
+        const uint32_t k = bits.read(param_bits);
+        if (k == escape) {
+            const int raw = (int)bits.read(5);
+            for (size_t j = 0; j < n; j++) out[i++] = bits.read_signed(raw);
+        } else {
+            for (size_t j = 0; j < n; j++) {
+                // Two statements: both reads move the cursor, prefix first
+                const uint32_t q = bits.read_unary();
+                const uint32_t v = (q << k) | bits.read((int)k);
+                out[i++] = (int32_t)(v >> 1) ^ -(int32_t)(v & 1);  // zigzag
+            }
+        }
+        if (!bits.ok()) return false;
+    }
+    return true;
+}
+
+static void predict_fixed(int32_t *s, size_t n, int order) {
+    for (size_t i = (size_t)order; i < n; i++) {
+        int64_t p = 0;
+        switch (order) {
+            case 1: p = s[i - 1]; break;
+            case 2: p = 2 * (int64_t)s[i - 1] - s[i - 2]; break;
+            case 3: p = 3 * (int64_t)s[i - 1] - 3 * (int64_t)s[i - 2] + s[i - 3]; break;
+            case 4: p = 4 * (int64_t)s[i - 1] - 6 * (int64_t)s[i - 2] + 4 * (int64_t)s[i - 3] - s[i - 4]; break;
+        }
+        s[i] = (int32_t)(s[i] + p);
+    }
+}
+
+static void predict_lpc(int32_t *s, size_t n, const int32_t *coefs, int order, int shift) {
+    for (size_t i = (size_t)order; i < n; i++) {
+        int64_t sum = 0;
+        for (int j = 0; j < order; j++) sum += (int64_t)coefs[j] * s[i - 1 - (size_t)j];
+        s[i] = (int32_t)(s[i] + (sum >> shift));
+    }
+}
+
+static bool decode_subframe(FlacBits &bits, size_t block_size, int bps, int32_t *out) {
+    if (bits.read(1) != 0) return false;  // padding
+    const uint32_t type = bits.read(6);
+    int wasted = 0;
+    if (bits.read(1)) wasted = (int)bits.read_unary() + 1;
+    bps -= wasted;
+    if (bps <= 0 || bps > 32) return false;
+
+    if (type == 0) {                                   // constant
+        std::fill(out, out + block_size, bits.read_signed(bps));
+    } else if (type == 1) {                            // verbatim
+        for (size_t i = 0; i < block_size; i++) out[i] = bits.read_signed(bps);
+    } else if (type >= 8 && type <= 12) {              // fixed predictor
+        const int order = (int)(type - 8);
+        if ((size_t)order > block_size) return false;
+        for (int i = 0; i < order; i++) out[i] = bits.read_signed(bps);
+        if (!decode_residual(bits, block_size, order, out)) return false;
+        predict_fixed(out, block_size, order);
+    } else if (type >= 32) {                           // LPC
+        const int order = (int)(type - 31);
+        if ((size_t)order > block_size) return false;
+        for (int i = 0; i < order; i++) out[i] = bits.read_signed(bps);
+        const int precision = (int)bits.read(4) + 1;
+        const int shift = bits.read_signed(5);
+        if (precision == 16 || shift < 0) return false;
+        int32_t coefs[32];
+        for (int i = 0; i < order; i++) coefs[i] = bits.read_signed(precision);
+        if (!decode_residual(bits, block_size, order, out)) return false;
+        predict_lpc(out, block_size, coefs, order, shift);
+    } else {
+        return false;                                  // reserved
+    }
+
+    if (wasted > 0) {
+        for (size_t i = 0; i < block_size; i++) out[i] = (int32_t)((uint32_t)out[i] << wasted);
+    }
+    return bits.ok();
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                              MD5
+// ═══════════════════════════════════════════════════════════════
+
+static inline uint32_t rotl(uint32_t x, int c) {
+    return (x << c) | (x >> (32 - c));
+}
+
+void FlacMd5::reset() {
+    h_[0] = 0x67452301;
+    h_[1] = 0xefcdab89;
+    h_[2] = 0x98badcfe;
+    h_[3] = 0x10325476;
+    length_ = 0;
+    used_ = 0;
+}
+
+void FlacMd5::block(const uint8_t *p) {
+    static const uint32_t K[64] = {
+        0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+        0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+        0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+        0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+        0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+        0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+        0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+        0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391};
+    static const int R[16] = {7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21};
+
+    uint32_t m[16];
+    for (int i = 0; i < 16; i++) {
+        m[i] = (uint32_t)p[i * 4] | (uint32_t)p[i * 4 + 1] << 8 | (uint32_t)p[i * 4 + 2] << 16 |
+               (uint32_t)p[i * 4 + 3] << 24;
+    }
+    uint32_t a = h_[0], b = h_[1], c = h_[2], d = h_[3];
+    for (int i = 0; i < 64; i++) {
+        uint32_t f;
+        int g;
+        if (i < 16)      { f = (b & c) | (~b & d); g = i; }
+        else if (i < 32) { f = (d & b) | (~d & c); g = (5 * i + 1) & 15; }
+        else if (i < 48) { f = b ^ c ^ d;          g = (3 * i + 5) & 15; }
+        else             { f = c ^ (b | ~d);       g = (7 * i) & 15; }
+        const uint32_t t = d;
+        d = c;
+        c = b;
+        b += rotl(a + f + K[i] + m[g], R[(i >> 4) * 4 + (i & 3)]);
+        a = t;
+    }
+    h_[0] += a;
+    h_[1] += b;
+    h_[2] += c;
+    h_[3] += d;
+}
+
+void FlacMd5::update(const uint8_t *p, size_t n) {
+    length_ += n;
+    if (used_ > 0) {
+        const size_t take = std::min(n, sizeof(buf_) - used_);
+        std::memcpy(buf_ + used_, p, take);
+        used_ += take;
+        p += take;
+        n -= take;
+        if (used_ < sizeof(buf_)) return;
+        block(buf_);
+        used_ = 0;
+    }
+    for (; n >= 64; p += 64, n -= 64) block(p);
+    std::memcpy(buf_, p, n);
+    used_ = n;
+}
+
+void FlacMd5::finish(uint8_t digest[16]) {
+    const uint64_t bits = length_ * 8;
+    uint8_t pad[72] = {0x80};
+    const size_t pad_len = (used_ < 56 ? 56 : 120) - used_;
+    for (int i = 0; i < 8; i++) pad[pad_len + (size_t)i] = (uint8_t)(bits >> (8 * i));
+    update(pad, pad_len + 8);
+    for (int i = 0; i < 16; i++) digest[i] = (uint8_t)(h_[i / 4] >> (8 * (i % 4)));
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                            FRAMES
+// ═══════════════════════════════════════════════════════════════
+
+static uint8_t crc8(const uint8_t *p, size_t n) {
+    uint8_t crc = 0;
+    for (size_t i = 0; i < n; i++) {
+        crc ^= p[i];
+        for (int b = 0; b < 8; b++) crc = (uint8_t)((crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1);
+    }
+    return crc;
+}
+
+bool FlacDecoder::decode_frame(size_t pos, size_t &end) {
+    FlacBits bits(data_, size_, pos);
+    if (bits.read(15) != 0x7FFC) return false;  // sync code + reserved bit
+    bits.read(1);                                // blocking strategy
+    const uint32_t size_code = bits.read(4);
+    const uint32_t rate_code = bits.read(4);
+    const uint32_t assignment = bits.read(4);
+    const uint32_t depth_code = bits.read(3);
+    if (bits.read(1) != 0 || size_code == 0 || rate_code == 15 || assignment > 10 ||
+        depth_code == 3) {
+        return false;
+    }
+
+    // Frame / sample number, UTF-8 style: only its length matters here
+    const uint32_t lead = bits.read(8);
+    int extra = 0;
+    while (extra < 7 && (lead & (0x80u >> extra))) extra++;
+    if (extra == 1 || extra == 7) return false;
+    for (int i = 1; i < extra; i++) {
+        if (bits.read(8) >> 6 != 2) return false;
+    }
+
+    size_t block_size;
+    if (size_code == 1) block_size = 192;
+    else if (size_code <= 5) block_size = (size_t)576 << (size_code - 2);
+    else if (size_code == 6) block_size = bits.read(8) + 1;
+    else if (size_code == 7) block_size = bits.read(16) + 1;
+    else block_size = (size_t)256 << (size_code - 8);
+
+    if (rate_code == 12) bits.read(8);
+    else if (rate_code == 13 || rate_code == 14) bits.read(16);
+
+    static const int DEPTHS[8] = {0, 8, 12, 0, 16, 20, 24, 32};
+    const int bps = depth_code == 0 ? bits_per_sample_ : DEPTHS[depth_code];
+    const int n_channels = assignment <= 7 ? (int)assignment + 1 : 2;
+    if (n_channels != channels_ || bps <= 0 || (assignment > 7 && bps == 32)) return false;
+
+    const size_t header_end = bits.byte();
+    if (!bits.ok() || header_end >= size_ || crc8(data_ + pos, header_end - pos) != data_[header_end]) {
+        return false;
+    }
+    bits.read(8);
+
+    samples_.resize((size_t)n_channels * block_size);
+    for (int c = 0; c < n_channels; c++) {
+        // The side channel carries one extra bit
+        const bool side = (assignment == 8 && c == 1) || (assignment == 9 && c == 0) ||
+                          (assignment == 10 && c == 1);
+        if (!decode_subframe(bits, block_size, bps + (side ? 1 : 0), samples_.data() + (size_t)c * block_size)) {
+            return false;
+        }
+    }
+
+    int32_t *a = samples_.data();
+    int32_t *b = a + (n_channels > 1 ? block_size : 0);
+    for (size_t i = 0; i < block_size && assignment > 7; i++) {
+        if (assignment == 8) {            // left / side
+            b[i] = a[i] - b[i];
+        } else if (assignment == 9) {     // side / right
+            a[i] += b[i];
+        } else {                          // mid / side
+            const int64_t mid = ((int64_t)a[i] << 1) | (b[i] & 1);
+            a[i] = (int32_t)((mid + b[i]) >> 1);
+            b[i] = (int32_t)((mid - b[i]) >> 1);
+        }
+    }
+
+    bits.align();
+    bits.read(16);  // frame CRC-16
+    if (!bits.ok()) return false;
+
+    end = bits.byte();
+    block_size_ = block_size;
+    block_pos_ = 0;
+    block_bits_ = bps;
+    return true;
+}
+
+// Samples as the encoder hashed them: interleaved, signed little-endian,
+// in whole bytes.
+void FlacDecoder::hash_frame() {
+    const size_t bytes = (size_t)(block_bits_ + 7) / 8;
+    hash_bytes_.resize(block_size_ * (size_t)channels_ * bytes);
+    uint8_t *out = hash_bytes_.data();
+    for (size_t i = 0; i < block_size_; i++) {
+        for (int c = 0; c < channels_; c++) {
+            const uint32_t v = (uint32_t)samples_[(size_t)c * block_size_ + i];
+            for (size_t b = 0; b < bytes; b++) *out++ = (uint8_t)(v >> (8 * b));
+        }
+    }
+    hash_.update(hash_bytes_.data(), hash_bytes_.size());
+}
+
+void FlacDecoder::check_md5() {
+    hashing_ = false;
+    uint8_t digest[16];
+    hash_.finish(digest);
+    if (std::memcmp(digest, md5_, sizeof(digest)) != 0) {
+        LOGE("FLAC: decoded audio does not match the stream's MD5");
+    } else {
+        LOGD("FLAC: decoded audio matches the stream's MD5");
+    }
+}
+
+bool FlacDecoder::next_frame() {
+    while (pos_ + 2 <= size_) {
+        size_t end = 0;
+        if (decode_frame(pos_, end)) {
+            pos_ = end;
+            if (hashing_) hash_frame();
+            return true;
+        }
+        hashing_ = false;  // the damage is reported; the hash cannot match
+        if (!reported_) {
+            LOGE("FLAC: damaged frame at byte %zu, resyncing", pos_);
+            reported_ = true;
+        }
+        // Next sync code (0xFFF8 / 0xFFF9)
+        size_t p = pos_ + 1;
+        while (p + 1 < size_ && !(data_[p] == 0xFF && (data_[p + 1] & 0xFE) == 0xF8)) p++;
+        pos_ = p;
+    }
+    if (hashing_) check_md5();
+    return false;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                          STREAM API
+// ═══════════════════════════════════════════════════════════════
+
+bool FlacDecoder::open(const uint8_t *data, size_t size) {
+    *this = FlacDecoder();
+    if (size < 8 || data[0] != 'f' || data[1] != 'L' || data[2] != 'a' || data[3] != 'C') return false;
+    data_ = data;
+    size_ = size;
+
+    // Metadata blocks: 1 bit last-block flag, 7 bits type, 24 bits length
+    size_t pos = 4;
+    bool have_info = false;
+    bool last = false;
+    while (!last && pos + 4 <= size) {
+        last = (data[pos] & 0x80) != 0;
+        const int type = data[pos] & 0x7F;
+        const size_t length = (size_t)data[pos + 1] << 16 | (size_t)data[pos + 2] << 8 | data[pos + 3];
+        pos += 4;
+        if (pos + length > size) return false;
+        if (type == 0 && length >= 34) {  // STREAMINFO
+            FlacBits bits(data, size, pos + 10);  // past block / frame size bounds
+            sample_rate_ = (int)bits.read(20);
+            channels_ = (int)bits.read(3) + 1;
+            bits_per_sample_ = (int)bits.read(5) + 1;
+            total_frames_ = (int64_t)bits.read(4) << 32;
+            total_frames_ |= bits.read(32);
+            std::memcpy(md5_, data + pos + 18, sizeof(md5_));
+            have_info = true;
+        }
+        pos += length;
+    }
+    if (!have_info || sample_rate_ <= 0 || bits_per_sample_ < 4) return false;
+
+    first_frame_ = pos_ = pos;
+    rewind();
+    return true;
+}
+
+void FlacDecoder::rewind() {
+    pos_ = first_frame_;
+    block_size_ = 0;
+    block_pos_ = 0;
+
+    static const uint8_t UNSET[16] = {};
+    hashing_ = std::memcmp(md5_, UNSET, sizeof(md5_)) != 0;
+    hash_.reset();
+}
+
+size_t FlacDecoder::read(float *dst, size_t count, int channel) {
+    size_t produced = 0;
+    while (produced < count) {
+        if (block_pos_ == block_size_ && !next_frame()) break;
+
+        const size_t n = std::min(count - produced, block_size_ - block_pos_);
+        const float scale = 1.0f / (float)((int64_t)1 << (block_bits_ - 1));
+        if (channel >= 0 || channels_ == 1) {
+            const int32_t *s = samples_.data() + (size_t)std::max(channel, 0) * block_size_ + block_pos_;
+            for (size_t i = 0; i < n; i++) dst[produced + i] = (float)s[i] * scale;
+        } else {
+            const float mix = scale / (float)channels_;
+            for (size_t i = 0; i < n; i++) {
+                int64_t sum = 0;
+                for (int c = 0; c < channels_; c++) sum += samples_[(size_t)c * block_size_ + block_pos_ + i];
+                dst[produced + i] = (float)sum * mix;
+            }
+        }
+        block_pos_ += n;
+        produced += n;
+    }
+    return produced;
+}
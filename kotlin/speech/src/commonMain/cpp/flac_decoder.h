@@ -0,0 +1,94 @@
+/**
+ * flac_decoder.h - Streaming FLAC decoder
+ *
+ * Archives are often kept as FLAC; decoding them to a temporary WAV first
+ * doubles the I/O and needs scratch space. This decoder reads the FLAC
+ * stream in place (WavReader hands it the mapped file) and decodes one
+ * frame at a time, so memory stays at one frame of samples (typically
+ * 4096 per channel) whatever the file length.
+ *
+ * Self-contained: fixed and LPC subframes, Rice / Rice2 residuals, every
+ * stereo decorrelation mode, 4 to 32 bits per sample (32-bit files only
+ * without stereo decorrelation, whose side channel needs 33 bits). Frame
+ * CRCs are not verified; the header CRC-8 is, to find frames again after a
+ * damaged one.
+ *
+ * Round trip: the encoder records an MD5 of the source PCM in STREAMINFO.
+ * A pass that decodes the whole stream from the start hashes what it
+ * decoded and logs an error if the two differ, so a decoder bug or a
+ * damaged file does not pass silently.
+ */
+
+#ifndef FLAC_DECODER_H
+#define FLAC_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Incremental MD5 (RFC 1321), for the STREAMINFO check.
+class FlacMd5 {
+public:
+    FlacMd5() { reset(); }
+    void reset();
+    void update(const uint8_t *p, size_t n);
+    void finish(uint8_t digest[16]);
+
+private:
+    void block(const uint8_t *p);
+
+    uint32_t h_[4];
+    uint64_t length_;
+    uint8_t buf_[64];
+    size_t used_;
+};
+
+class FlacDecoder {
+public:
+    // Parses the "fLaC" marker and STREAMINFO at `data` (other metadata is
+    // skipped). `data` must outlive the decoder.
+    bool open(const uint8_t *data, size_t size);
+
+    int sample_rate() const { return sample_rate_; }
+    int channels() const { return channels_; }
+    int bits_per_sample() const { return bits_per_sample_; }
+    // 0 if the encoder did not record it.
+    int64_t total_frames() const { return total_frames_; }
+
+    // Decodes up to `count` frames as float in [-1, 1]: channel `channel`,
+    // or with -1 the mean of all channels. Returns the number written; less
+    // than `count` only at the end of the stream.
+    size_t read(float *dst, size_t count, int channel);
+
+    // Restarts at the first audio frame.
+    void rewind();
+
+private:
+    bool next_frame();
+    bool decode_frame(size_t pos, size_t &end);
+    void hash_frame();
+    void check_md5();
+
+    const uint8_t *data_ = nullptr;
+    size_t size_ = 0;
+    size_t first_frame_ = 0;   // byte offset of the first audio frame
+    size_t pos_ = 0;           // byte offset of the next frame
+
+    int sample_rate_ = 0;
+    int channels_ = 0;
+    int bits_per_sample_ = 0;
+    int64_t total_frames_ = 0;
+
+    std::vector<int32_t> samples_;  // current frame, planar: channel * block_size_ + i
+    size_t block_size_ = 0;
+    size_t block_pos_ = 0;          // next frame of the block to hand out
+    int block_bits_ = 0;            // bits per sample of the current frame
+    bool reported_ = false;         // a damaged frame was logged
+
+    uint8_t md5_[16] = {};          // from STREAMINFO; all zero if unset
+    bool hashing_ = false;          // this pass started at frame 0, no frame lost
+    FlacMd5 hash_;
+    std::vector<uint8_t> hash_bytes_;  // one frame, interleaved little-endian
+};
+
+#endif // FLAC_DECODER_H
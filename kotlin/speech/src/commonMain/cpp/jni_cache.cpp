@@ -0,0 +1,118 @@
+/**
+ * jni_cache.cpp - Classes and method IDs resolved once in JNI_OnLoad
+ */
+
+#include "jni_cache.h"
+#include "stt_common.h"
+
+JniCache g_jni;
+
+// Detaches a thread that jni_attach_current_thread() attached, at thread exit.
+struct JniThreadDetacher {
+    bool attached = false;
+    ~JniThreadDetacher() {
+        if (attached && g_jni.vm != nullptr) g_jni.vm->DetachCurrentThread();
+    }
+};
+
+static thread_local JniThreadDetacher t_detacher;
+
+JNIEnv *jni_attach_current_thread() {
+    JNIEnv *env = nullptr;
+    if (g_jni.vm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6) == JNI_OK) return env;
+#ifdef __ANDROID__
+    if (g_jni.vm->AttachCurrentThread(&env, nullptr) != JNI_OK) return nullptr;
+#else
+    if (g_jni.vm->AttachCurrentThread(reinterpret_cast<void **>(&env), nullptr) != JNI_OK) return nullptr;
+#endif
+    t_detacher.attached = true;
+    return env;
+}
+
+static jclass find_global_class(JNIEnv *env, const char *name) {
+    jclass local = env->FindClass(name);
+    if (local == nullptr) {
+        LOGE("JNI_OnLoad: class %s not found", name);
+        return nullptr;
+    }
+    auto global = (jclass)env->NewGlobalRef(local);
+    env->DeleteLocalRef(local);
+    return global;
+}
+
+static bool resolve(JNIEnv *env) {
+    g_jni.transcriptionResult = find_global_class(env, "dev/deviceai/TranscriptionResult");
+    g_jni.segment = find_global_class(env, "dev/deviceai/Segment");
+    g_jni.languageProbability = find_global_class(env, "dev/deviceai/LanguageProbability");
+    g_jni.string = find_global_class(env, "java/lang/String");
+    g_jni.arrayList = find_global_class(env, "java/util/ArrayList");
+    if (!g_jni.transcriptionResult || !g_jni.segment || !g_jni.languageProbability || !g_jni.string ||
+        !g_jni.arrayList) {
+        return false;
+    }
+
+    g_jni.transcriptionResultCtor = env->GetMethodID(g_jni.transcriptionResult, "<init>",
+        "(Ljava/lang/String;Ljava/util/List;Ljava/lang/String;JZLjava/lang/String;)V");
+    g_jni.segmentCtor = env->GetMethodID(g_jni.segment, "<init>", "(Ljava/lang/String;JJI)V");
+    g_jni.languageProbabilityCtor = env->GetMethodID(g_jni.languageProbability, "<init>",
+        "(Ljava/lang/String;F)V");
+    g_jni.arrayListCtor = env->GetMethodID(g_jni.arrayList, "<init>", "()V");
+    g_jni.arrayListAdd = env->GetMethodID(g_jni.arrayList, "add", "(Ljava/lang/Object;)Z");
+
+    jclass sttStream = env->FindClass("dev/deviceai/SttStream");
+    jclass sttModelCallback = env->FindClass("dev/deviceai/SttModelCallback");
+    jclass sttJobCallback = env->FindClass("dev/deviceai/SttJobCallback");
+    jclass sttListenerCallback = env->FindClass("dev/deviceai/SttListenerCallback");
+    jclass ttsStream = env->FindClass("dev/deviceai/TtsStream");
+    if (!sttStream || !sttModelCallback || !sttJobCallback || !sttListenerCallback || !ttsStream) {
+        LOGE("JNI_OnLoad: stream callback interfaces not found");
+        return false;
+    }
+    g_jni.sttOnPartialResult = env->GetMethodID(sttStream, "onPartialResult", "(Ljava/lang/String;)V");
+    g_jni.sttOnFinalResult = env->GetMethodID(sttStream, "onFinalResult",
+        "(Ldev/deviceai/TranscriptionResult;)V");
+    g_jni.sttOnError = env->GetMethodID(sttStream, "onError", "(Ljava/lang/String;)V");
+    g_jni.sttOnModelLoaded = env->GetMethodID(sttModelCallback, "onModelLoaded", "(Ljava/lang/String;Z)V");
+    g_jni.sttJobOnResult = env->GetMethodID(sttJobCallback, "onResult",
+        "(JLdev/deviceai/TranscriptionResult;)V");
+    g_jni.sttJobOnError = env->GetMethodID(sttJobCallback, "onError", "(JLjava/lang/String;)V");
+    g_jni.sttListenerOnSpeechStart = env->GetMethodID(sttListenerCallback, "onSpeechStart", "(J)V");
+    g_jni.sttListenerOnUtterance = env->GetMethodID(sttListenerCallback, "onUtterance",
+        "(Ldev/deviceai/TranscriptionResult;)V");
+    g_jni.sttListenerOnError = env->GetMethodID(sttListenerCallback, "onError", "(Ljava/lang/String;)V");
+    g_jni.ttsOnAudioChunk = env->GetMethodID(ttsStream, "onAudioChunk", "([S)V");
+    g_jni.ttsOnComplete = env->GetMethodID(ttsStream, "onComplete", "()V");
+    g_jni.ttsOnError = env->GetMethodID(ttsStream, "onError", "(Ljava/lang/String;)V");
+    env->DeleteLocalRef(sttStream);
+    env->DeleteLocalRef(sttModelCallback);
+    env->DeleteLocalRef(sttJobCallback);
+    env->DeleteLocalRef(sttListenerCallback);
+    env->DeleteLocalRef(ttsStream);
+
+    // GetMethodID leaves a NoSuchMethodError pending on failure
+    return !env->ExceptionCheck();
+}
+
+extern "C" JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM *vm, void *reserved) {
+    JNIEnv *env = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6) != JNI_OK) {
+        return JNI_ERR;
+    }
+    g_jni.vm = vm;
+    if (!resolve(env)) {
+        LOGE("JNI_OnLoad: failed to resolve Kotlin bindings");
+        return JNI_ERR;
+    }
+    return JNI_VERSION_1_6;
+}
+
+extern "C" JNIEXPORT void JNICALL JNI_OnUnload(JavaVM *vm, void *reserved) {
+    JNIEnv *env = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void **>(&env), JNI_VERSION_1_6) != JNI_OK) return;
+    env->DeleteGlobalRef(g_jni.transcriptionResult);
+    env->DeleteGlobalRef(g_jni.segment);
+    env->DeleteGlobalRef(g_jni.languageProbability);
+    env->DeleteGlobalRef(g_jni.string);
+    env->DeleteGlobalRef(g_jni.arrayList);
+    g_jni = JniCache();
+}
@@ -0,0 +1,68 @@
+/**
+ * jni_cache.h - Classes and method IDs resolved once in JNI_OnLoad
+ *
+ * FindClass / GetMethodID are reflective lookups; doing them on every
+ * transcription (and per callback) is measurable on Android. speech_jni
+ * resolves everything it calls into when the library is loaded and keeps
+ * global refs to the classes for the lifetime of the library. Method IDs of
+ * the callback interfaces are valid for any implementing object.
+ */
+
+#ifndef JNI_CACHE_H
+#define JNI_CACHE_H
+
+#include <jni.h>
+
+struct JniCache {
+    JavaVM *vm = nullptr;
+
+    // dev.deviceai.TranscriptionResult(String, List, String, long)
+    jclass transcriptionResult = nullptr;
+    jmethodID transcriptionResultCtor = nullptr;
+
+    // dev.deviceai.Segment(String, long, long, int)
+    jclass segment = nullptr;
+    jmethodID segmentCtor = nullptr;
+
+    // dev.deviceai.LanguageProbability(String, float)
+    jclass languageProbability = nullptr;
+    jmethodID languageProbabilityCtor = nullptr;
+
+    jclass string = nullptr;
+
+    jclass arrayList = nullptr;
+    jmethodID arrayListCtor = nullptr;
+    jmethodID arrayListAdd = nullptr;
+
+    // dev.deviceai.SttStream
+    jmethodID sttOnPartialResult = nullptr;
+    jmethodID sttOnFinalResult = nullptr;
+    jmethodID sttOnError = nullptr;
+
+    // dev.deviceai.SttModelCallback
+    jmethodID sttOnModelLoaded = nullptr;
+
+    // dev.deviceai.SttJobCallback
+    jmethodID sttJobOnResult = nullptr;
+    jmethodID sttJobOnError = nullptr;
+
+    // dev.deviceai.SttListenerCallback
+    jmethodID sttListenerOnSpeechStart = nullptr;
+    jmethodID sttListenerOnUtterance = nullptr;
+    jmethodID sttListenerOnError = nullptr;
+
+    // dev.deviceai.TtsStream
+    jmethodID ttsOnAudioChunk = nullptr;
+    jmethodID ttsOnComplete = nullptr;
+    jmethodID ttsOnError = nullptr;
+};
+
+// Filled by JNI_OnLoad before any native method can run.
+extern JniCache g_jni;
+
+// JNIEnv of the calling thread. Native threads (model loader, job workers, listeners)
+// are attached on first use and detached when they exit. nullptr if the
+// thread cannot be attached.
+JNIEnv *jni_attach_current_thread();
+
+#endif // JNI_CACHE_H
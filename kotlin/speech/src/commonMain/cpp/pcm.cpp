@@ -0,0 +1,127 @@
+/**
+ * pcm.cpp - Sample format conversion for the 16 kHz front end
+ */
+
+#include "pcm.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define PCM_NEON 1
+#elif (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define PCM_AVX2 1
+#endif
+
+static constexpr float PCM16_SCALE = 1.0f / 32768.0f;
+
+static void convert_scalar(const int16_t *src, size_t n, float *dst) {
+    for (size_t i = 0; i < n; i++) dst[i] = (float)src[i] * PCM16_SCALE;
+}
+
+#ifdef PCM_NEON
+static void convert_neon(const int16_t *src, size_t n, float *dst) {
+    const float32x4_t scale = vdupq_n_f32(PCM16_SCALE);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        int16x8_t s = vld1q_s16(src + i);
+        vst1q_f32(dst + i,     vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(s))), scale));
+        vst1q_f32(dst + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(s))), scale));
+    }
+    convert_scalar(src + i, n - i, dst + i);
+}
+#endif
+
+#ifdef PCM_AVX2
+__attribute__((target("avx2")))
+static void convert_avx2(const int16_t *src, size_t n, float *dst) {
+    const __m256 scale = _mm256_set1_ps(PCM16_SCALE);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+        __m256i lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(s));
+        __m256i hi = _mm256_cvtepi16_epi32(_mm256_extracti128_si256(s, 1));
+        _mm256_storeu_ps(dst + i,     _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale));
+        _mm256_storeu_ps(dst + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale));
+    }
+    convert_scalar(src + i, n - i, dst + i);
+}
+#endif
+
+static void channel_scalar(const int16_t *src, int channels, int channel, size_t n, float *dst) {
+    src += channel;
+    for (size_t i = 0; i < n; i++, src += channels) dst[i] = (float)*src * PCM16_SCALE;
+}
+
+#ifdef PCM_NEON
+static void channel_neon(const int16_t *src, int channels, int channel, size_t n, float *dst) {
+    if (channels != 2) {
+        channel_scalar(src, channels, channel, n, dst);
+        return;
+    }
+    const float32x4_t scale = vdupq_n_f32(PCM16_SCALE);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        int16x8_t s = vld2q_s16(src + 2 * i).val[channel];  // de-interleaving load
+        vst1q_f32(dst + i,     vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(s))), scale));
+        vst1q_f32(dst + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(s))), scale));
+    }
+    channel_scalar(src + 2 * i, channels, channel, n - i, dst + i);
+}
+#endif
+
+#ifdef PCM_AVX2
+__attribute__((target("avx2")))
+static void channel_avx2(const int16_t *src, int channels, int channel, size_t n, float *dst) {
+    if (channels != 2) {
+        channel_scalar(src, channels, channel, n, dst);
+        return;
+    }
+    const __m256 scale = _mm256_set1_ps(PCM16_SCALE);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        // Each 32-bit lane is one frame: left in the low half, right in the high
+        __m256i s = _mm256_loadu_si256((const __m256i *)(src + 2 * i));
+        __m256i v = channel == 0 ? _mm256_srai_epi32(_mm256_slli_epi32(s, 16), 16) : _mm256_srai_epi32(s, 16);
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+    }
+    channel_scalar(src + 2 * i, channels, channel, n - i, dst + i);
+}
+#endif
+
+using ConvertFn = void (*)(const int16_t *, size_t, float *);
+using ChannelFn = void (*)(const int16_t *, int, int, size_t, float *);
+
+static ConvertFn select_convert() {
+#if defined(PCM_NEON)
+    return convert_neon;
+#elif defined(PCM_AVX2)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return convert_avx2;
+    return convert_scalar;
+#else
+    return convert_scalar;
+#endif
+}
+
+static ChannelFn select_channel() {
+#if defined(PCM_NEON)
+    return channel_neon;
+#elif defined(PCM_AVX2)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return channel_avx2;
+    return channel_scalar;
+#else
+    return channel_scalar;
+#endif
+}
+
+static const ConvertFn g_convert = select_convert();
+static const ChannelFn g_channel = select_channel();
+
+void pcm16_to_float(const int16_t *src, size_t n, float *dst) {
+    g_convert(src, n, dst);
+}
+
+void pcm16_channel_to_float(const int16_t *src, int channels, int channel, size_t n_frames, float *dst) {
+    g_channel(src, channels, channel, n_frames, dst);
+}
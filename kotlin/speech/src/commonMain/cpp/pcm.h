@@ -0,0 +1,24 @@
+/**
+ * pcm.h - Sample format conversion for the 16 kHz front end
+ *
+ * int16 PCM is the native format of WAV files and of Android's AudioRecord;
+ * whisper wants float in [-1, 1). The conversion has NEON and AVX2 kernels
+ * (AVX2 is selected at runtime), with a scalar fallback. So does pulling
+ * one channel out of interleaved stereo, for per-channel transcription.
+ */
+
+#ifndef PCM_H
+#define PCM_H
+
+#include <cstddef>
+#include <cstdint>
+
+// dst[i] = src[i] / 32768. `src` is host-endian (little-endian on every
+// supported target) and needs only 2-byte alignment.
+void pcm16_to_float(const int16_t *src, size_t n, float *dst);
+
+// dst[i] = src[i * channels + channel] / 32768, for `n_frames` frames of
+// interleaved PCM. Vectorised for stereo; other layouts run scalar.
+void pcm16_channel_to_float(const int16_t *src, int channels, int channel, size_t n_frames, float *dst);
+
+#endif // PCM_H
@@ -5,6 +5,7 @@
  */
 
 #include "speech_jni.h"
+#include "jni_cache.h"
 #include "piper.hpp"
 
 #include <string>
@@ -271,11 +272,10 @@ Java_dev_deviceai_SpeechBridge_nativeSynthesizeStream(
 
     std::lock_guard<std::mutex> lock(g_mutex);
 
-    // Get callback methods
-    jclass cbClass = env->GetObjectClass(callback);
-    jmethodID onChunk = env->GetMethodID(cbClass, "onAudioChunk", "([S)V");
-    jmethodID onComplete = env->GetMethodID(cbClass, "onComplete", "()V");
-    jmethodID onError = env->GetMethodID(cbClass, "onError", "(Ljava/lang/String;)V");
+    // Callback methods are resolved once in JNI_OnLoad
+    jmethodID onChunk = g_jni.ttsOnAudioChunk;
+    jmethodID onComplete = g_jni.ttsOnComplete;
+    jmethodID onError = g_jni.ttsOnError;
 
     if (!g_initialized) {
         env->CallVoidMethod(callback, onError, env->NewStringUTF("Piper not initialized"));
@@ -0,0 +1,239 @@
+/**
+ * resampler.cpp - Polyphase windowed-sinc resampler for the 16 kHz front end
+ */
+
+#include "resampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <utility>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define RESAMPLER_NEON 1
+#elif (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define RESAMPLER_AVX2 1
+#endif
+
+static constexpr double PI = 3.14159265358979323846;
+
+// Zero crossings of the prototype sinc on each side of the centre tap.
+static constexpr int ZERO_CROSSINGS = 16;
+
+// Passband edge as a fraction of the lower Nyquist frequency.
+static constexpr double ROLLOFF = 0.92;
+
+// Kaiser beta; ~80 dB stopband attenuation.
+static constexpr double KAISER_BETA = 8.0;
+
+// Ratios whose reduced L exceeds this (odd device rates) share a bank of this
+// many phases and use the nearest one.
+static constexpr int MAX_PHASES = 1024;
+
+// Filter rows are padded to a whole number of SIMD vectors.
+static constexpr int TAP_ALIGN = 8;
+
+struct ResamplerBank {
+    int L = 1;                  // output rate / gcd
+    int M = 1;                  // input rate / gcd
+    int phases = 1;             // rows in coeffs
+    int half_len = 0;           // filter half-length, in input samples
+    int taps = 0;               // row length (2 * half_len, padded)
+    std::vector<float> coeffs;  // phases x taps
+};
+
+// ═══════════════════════════════════════════════════════════════
+//                        FILTER DESIGN
+// ═══════════════════════════════════════════════════════════════
+
+// Zeroth-order modified Bessel function of the first kind.
+static double bessel_i0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 50; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+static std::shared_ptr<const ResamplerBank> build_bank(int L, int M) {
+    auto bank = std::make_shared<ResamplerBank>();
+    bank->L = L;
+    bank->M = M;
+    bank->phases = std::min(L, MAX_PHASES);
+
+    // Cutoff in cycles per input sample: below both Nyquist frequencies.
+    const double fc = 0.5 * std::min(1.0, (double)L / M) * ROLLOFF;
+    bank->half_len = (int)std::ceil(ZERO_CROSSINGS / (2.0 * fc));
+    bank->taps = (2 * bank->half_len + TAP_ALIGN - 1) / TAP_ALIGN * TAP_ALIGN;
+    bank->coeffs.assign((size_t)bank->phases * bank->taps, 0.0f);
+
+    const double i0_beta = bessel_i0(KAISER_BETA);
+    for (int p = 0; p < bank->phases; p++) {
+        const double frac = (double)p / bank->phases;
+        float *row = bank->coeffs.data() + (size_t)p * bank->taps;
+        double sum = 0.0;
+        for (int k = 0; k < 2 * bank->half_len; k++) {
+            // Distance from the output instant to input sample k of the window
+            const double d = frac + bank->half_len - 1 - k;
+            const double r = d / bank->half_len;
+            if (r <= -1.0 || r >= 1.0) continue;
+            const double x = 2.0 * fc * d;
+            const double sinc = x == 0.0 ? 1.0 : std::sin(PI * x) / (PI * x);
+            const double window = bessel_i0(KAISER_BETA * std::sqrt(1.0 - r * r)) / i0_beta;
+            row[k] = (float)(2.0 * fc * sinc * window);
+            sum += row[k];
+        }
+        // Unity DC gain for every phase
+        for (int k = 0; k < 2 * bank->half_len; k++) row[k] = (float)(row[k] / sum);
+    }
+    return bank;
+}
+
+// Banks are shared by every resampler with the same ratio.
+static std::shared_ptr<const ResamplerBank> get_bank(int L, int M) {
+    static std::mutex mutex;
+    static std::map<std::pair<int, int>, std::shared_ptr<const ResamplerBank>> cache;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &bank = cache[{L, M}];
+    if (!bank) bank = build_bank(L, M);
+    return bank;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                        DOT PRODUCT KERNELS
+// ═══════════════════════════════════════════════════════════════
+// n is always a multiple of TAP_ALIGN.
+
+static float dot_scalar(const float *x, const float *h, int n) {
+    float a0 = 0.0f, a1 = 0.0f, a2 = 0.0f, a3 = 0.0f;
+    for (int i = 0; i < n; i += 4) {
+        a0 += x[i] * h[i];
+        a1 += x[i + 1] * h[i + 1];
+        a2 += x[i + 2] * h[i + 2];
+        a3 += x[i + 3] * h[i + 3];
+    }
+    return (a0 + a1) + (a2 + a3);
+}
+
+#ifdef RESAMPLER_NEON
+static float dot_neon(const float *x, const float *h, int n) {
+    float32x4_t a0 = vdupq_n_f32(0.0f);
+    float32x4_t a1 = vdupq_n_f32(0.0f);
+    for (int i = 0; i < n; i += 8) {
+#if defined(__aarch64__)
+        a0 = vfmaq_f32(a0, vld1q_f32(x + i), vld1q_f32(h + i));
+        a1 = vfmaq_f32(a1, vld1q_f32(x + i + 4), vld1q_f32(h + i + 4));
+#else
+        a0 = vmlaq_f32(a0, vld1q_f32(x + i), vld1q_f32(h + i));
+        a1 = vmlaq_f32(a1, vld1q_f32(x + i + 4), vld1q_f32(h + i + 4));
+#endif
+    }
+    float32x4_t a = vaddq_f32(a0, a1);
+#if defined(__aarch64__)
+    return vaddvq_f32(a);
+#else
+    float32x2_t s = vadd_f32(vget_low_f32(a), vget_high_f32(a));
+    return vget_lane_f32(vpadd_f32(s, s), 0);
+#endif
+}
+#endif
+
+#ifdef RESAMPLER_AVX2
+__attribute__((target("avx2,fma")))
+static float dot_avx2(const float *x, const float *h, int n) {
+    __m256 acc = _mm256_setzero_ps();
+    for (int i = 0; i < n; i += 8) {
+        acc = _mm256_fmadd_ps(_mm256_loadu_ps(x + i), _mm256_loadu_ps(h + i), acc);
+    }
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 0x55));
+    return _mm_cvtss_f32(s);
+}
+#endif
+
+using DotFn = float (*)(const float *, const float *, int);
+
+static DotFn select_dot() {
+#if defined(RESAMPLER_NEON)
+    return dot_neon;
+#elif defined(RESAMPLER_AVX2)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return dot_avx2;
+    return dot_scalar;
+#else
+    return dot_scalar;
+#endif
+}
+
+static const DotFn g_dot = select_dot();
+
+// ═══════════════════════════════════════════════════════════════
+//                      STREAMING RESAMPLER
+// ═══════════════════════════════════════════════════════════════
+
+StreamingResampler::StreamingResampler(int in_rate, int out_rate) {
+    if (in_rate > 0 && out_rate > 0 && in_rate != out_rate) {
+        int g = std::gcd(in_rate, out_rate);
+        bank_ = get_bank(out_rate / g, in_rate / g);
+    }
+    reset();
+}
+
+StreamingResampler::~StreamingResampler() = default;
+
+void StreamingResampler::reset() {
+    history_.clear();
+    // Lead-in zeros put output 0 exactly on input 0
+    if (bank_) history_.assign((size_t)bank_->half_len - 1, 0.0f);
+    pos_ = 0;
+    phase_ = 0;
+    consumed_in_ = 0;
+    produced_out_ = 0;
+}
+
+void StreamingResampler::process(const float *in, size_t n, std::vector<float> &out) {
+    consumed_in_ += (int64_t)n;
+    if (!bank_) {
+        out.insert(out.end(), in, in + n);
+        return;
+    }
+    history_.insert(history_.end(), in, in + n);
+    run(out, -1);
+}
+
+void StreamingResampler::flush(std::vector<float> &out) {
+    if (!bank_) return;
+    // Zero-pad past the last input so the tail windows are complete, and stop
+    // at the output length that input implies.
+    history_.insert(history_.end(), (size_t)bank_->half_len + bank_->taps, 0.0f);
+    int64_t total = (consumed_in_ * bank_->L + bank_->M - 1) / bank_->M;
+    run(out, total);
+}
+
+void StreamingResampler::run(std::vector<float> &out, int64_t limit) {
+    const ResamplerBank &b = *bank_;
+    const bool exact = b.phases == b.L;
+
+    while (pos_ + (size_t)b.taps <= history_.size() && (limit < 0 || produced_out_ < limit)) {
+        int row = exact ? phase_ : (int)((int64_t)phase_ * b.phases / b.L);
+        out.push_back(g_dot(history_.data() + pos_, b.coeffs.data() + (size_t)row * b.taps, b.taps));
+        produced_out_++;
+
+        phase_ += b.M;
+        pos_ += (size_t)(phase_ / b.L);
+        phase_ %= b.L;
+    }
+
+    // Drop input no future window will touch
+    size_t drop = std::min(pos_, history_.size());
+    history_.erase(history_.begin(), history_.begin() + (std::ptrdiff_t)drop);
+    pos_ -= drop;
+}
@@ -0,0 +1,57 @@
+/**
+ * resampler.h - Polyphase windowed-sinc resampler for the 16 kHz front end
+ *
+ * Rational L/M polyphase filter with a Kaiser-windowed sinc prototype,
+ * band-limited to 92% of the lower Nyquist frequency (so 44.1/48 kHz input
+ * does not alias into the speech band the way linear interpolation does).
+ * Filter banks are built once per reduced ratio (48k -> 16k is 1/3,
+ * 44.1k -> 16k is 160/441, 22.05k is 320/441, 8k is 2/1) and shared by
+ * every resampler using that ratio.
+ *
+ * The inner dot product has NEON and AVX2/FMA kernels (AVX2 is selected at
+ * runtime), with a scalar fallback.
+ */
+
+#ifndef RESAMPLER_H
+#define RESAMPLER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+struct ResamplerBank;
+
+// Stateful resampler: feed input block by block, output is identical to
+// resampling the concatenated input in one go. Not thread-safe.
+class StreamingResampler {
+public:
+    explicit StreamingResampler(int in_rate, int out_rate = 16000);
+    ~StreamingResampler();
+
+    StreamingResampler(const StreamingResampler &) = delete;
+    StreamingResampler &operator=(const StreamingResampler &) = delete;
+
+    bool passthrough() const { return bank_ == nullptr; }
+
+    // Appends the output for `n` more input samples to `out`.
+    void process(const float *in, size_t n, std::vector<float> &out);
+
+    // Appends the output still held back by the filter delay. Call once at
+    // the end of the stream; reset() before reusing the resampler.
+    void flush(std::vector<float> &out);
+
+    void reset();
+
+private:
+    void run(std::vector<float> &out, int64_t limit);
+
+    std::shared_ptr<const ResamplerBank> bank_;
+    std::vector<float> history_;   // input not yet fully consumed (plus lead-in zeros)
+    size_t pos_ = 0;               // history_ index of the current filter window
+    int phase_ = 0;                // output phase, in 1/L input samples
+    int64_t consumed_in_ = 0;      // input samples fed so far
+    int64_t produced_out_ = 0;     // output samples emitted so far
+};
+
+#endif // RESAMPLER_H
@@ -21,29 +21,80 @@ Java_dev_deviceai_SpeechBridge_nativeInitStt(
     jboolean useGpu,
     jboolean useVad,
     jboolean singleSegment,
-    jboolean noContext);
+    jboolean noContext,
+    jint statePoolSize,
+    jint threadsPerState,
+    jboolean persistentState,
+    jboolean longForm,
+    jboolean warmUp,
+    jboolean pinLanguage,
+    jlong resultCacheBytes,
+    jstring resultCachePath,
+    jlong modelBudgetBytes,
+    jboolean stopRepetitionLoops,
+    jobjectArray commands);
 
 JNIEXPORT jstring JNICALL
 Java_dev_deviceai_SpeechBridge_nativeTranscribe(
     JNIEnv *env, jobject thiz,
-    jstring audioPath);
+    jstring audioPath,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs);
 
 JNIEXPORT jobject JNICALL
 Java_dev_deviceai_SpeechBridge_nativeTranscribeDetailed(
     JNIEnv *env, jobject thiz,
-    jstring audioPath);
+    jstring audioPath,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs);
 
 JNIEXPORT jstring JNICALL
 Java_dev_deviceai_SpeechBridge_nativeTranscribeAudio(
     JNIEnv *env, jobject thiz,
-    jfloatArray samples);
+    jfloatArray samples,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs);
+
+JNIEXPORT jstring JNICALL
+Java_dev_deviceai_SpeechBridge_nativeTranscribeAudioBuffer(
+    JNIEnv *env, jobject thiz,
+    jobject buffer,
+    jint byteOffset,
+    jint byteLength,
+    jboolean pcm16,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs);
 
 JNIEXPORT void JNICALL
 Java_dev_deviceai_SpeechBridge_nativeTranscribeStream(
     JNIEnv *env, jobject thiz,
     jfloatArray samples,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs,
     jobject callback);
 
+JNIEXPORT jlongArray JNICALL
+Java_dev_deviceai_SpeechBridge_nativeGetSttCacheStats(
+    JNIEnv *env, jobject thiz);
+
+JNIEXPORT jlongArray JNICALL
+Java_dev_deviceai_SpeechBridge_nativeGetSttLoopStats(
+    JNIEnv *env, jobject thiz);
+
+JNIEXPORT void JNICALL
+Java_dev_deviceai_SpeechBridge_nativeClearSttCache(
+    JNIEnv *env, jobject thiz);
+
 JNIEXPORT void JNICALL
 Java_dev_deviceai_SpeechBridge_nativeCancelStt(
     JNIEnv *env, jobject thiz);
@@ -52,6 +103,185 @@ JNIEXPORT void JNICALL
 Java_dev_deviceai_SpeechBridge_nativeShutdownStt(
     JNIEnv *env, jobject thiz);
 
+// ═══════════════════════════════════════════════════════════════
+//                 STREAMING STT SESSIONS
+// ═══════════════════════════════════════════════════════════════
+
+JNIEXPORT jlong JNICALL
+Java_dev_deviceai_SpeechBridge_nativeSttSessionOpen(
+    JNIEnv *env, jobject thiz,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jstring finalModel,
+    jobject callback);
+
+JNIEXPORT void JNICALL
+Java_dev_deviceai_SpeechBridge_nativeSttSessionPush(
+    JNIEnv *env, jobject thiz,
+    jlong handle,
+    jfloatArray samples);
+
+JNIEXPORT void JNICALL
+Java_dev_deviceai_SpeechBridge_nativeSttSessionFlush(
+    JNIEnv *env, jobject thiz,
+    jlong handle);
+
+JNIEXPORT void JNICALL
+Java_dev_deviceai_SpeechBridge_nativeSttSessionClose(
+    JNIEnv *env, jobject thiz,
+    jlong handle);
+
+JNIEXPORT jlongArray JNICALL
+Java_dev_deviceai_SpeechBridge_nativeSttSessionStats(
+    JNIEnv *env, jobject thiz,
+    jlong handle);
+
+// ═══════════════════════════════════════════════════════════════
+//                   ALWAYS-ON LISTENING
+// ═══════════════════════════════════════════════════════════════
+
+JNIEXPORT jlong JNICALL
+Java_dev_deviceai_SpeechBridge_nativeListenerOpen(
+    JNIEnv *env, jobject thiz,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs,
+    jint preRollMs,
+    jint endSilenceMs,
+    jint minSpeechMs,
+    jint maxUtteranceMs,
+    jobject callback);
+
+JNIEXPORT void JNICALL
+Java_dev_deviceai_SpeechBridge_nativeListenerPush(
+    JNIEnv *env, jobject thiz,
+    jlong handle,
+    jfloatArray samples);
+
+JNIEXPORT void JNICALL
+Java_dev_deviceai_SpeechBridge_nativeListenerClose(
+    JNIEnv *env, jobject thiz,
+    jlong handle);
+
+// ═══════════════════════════════════════════════════════════════
+//                         BATCH STT
+// ═══════════════════════════════════════════════════════════════
+
+JNIEXPORT jobjectArray JNICALL
+Java_dev_deviceai_SpeechBridge_nativeTranscribeBatch(
+    JNIEnv *env, jobject thiz,
+    jobjectArray clips,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs);
+
+JNIEXPORT jobjectArray JNICALL
+Java_dev_deviceai_SpeechBridge_nativeTranscribeBatchFiles(
+    JNIEnv *env, jobject thiz,
+    jobjectArray audioPaths,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs);
+
+// ═══════════════════════════════════════════════════════════════
+//                ENCODE ONCE, DECODE MANY
+// ═══════════════════════════════════════════════════════════════
+
+JNIEXPORT jobjectArray JNICALL
+Java_dev_deviceai_SpeechBridge_nativeTranscribeAudioTasks(
+    JNIEnv *env, jobject thiz,
+    jfloatArray samples,
+    jobjectArray taskLanguages,
+    jintArray taskTranslate,
+    jobjectArray taskPrompts,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs);
+
+// ═══════════════════════════════════════════════════════════════
+//                  LANGUAGE IDENTIFICATION
+// ═══════════════════════════════════════════════════════════════
+
+JNIEXPORT jobjectArray JNICALL
+Java_dev_deviceai_SpeechBridge_nativeDetectLanguage(
+    JNIEnv *env, jobject thiz,
+    jfloatArray samples,
+    jint topN,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs);
+
+// ═══════════════════════════════════════════════════════════════
+//                      VOICE COMMANDS
+// ═══════════════════════════════════════════════════════════════
+
+JNIEXPORT jint JNICALL
+Java_dev_deviceai_SpeechBridge_nativeRecognizeCommand(
+    JNIEnv *env, jobject thiz,
+    jfloatArray samples,
+    jobjectArray commands,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs);
+
+// ═══════════════════════════════════════════════════════════════
+//                      ASYNCHRONOUS JOBS
+// ═══════════════════════════════════════════════════════════════
+
+JNIEXPORT jlong JNICALL
+Java_dev_deviceai_SpeechBridge_nativeSubmitTranscription(
+    JNIEnv *env, jobject thiz,
+    jstring audioPath,
+    jint priority,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs,
+    jobject callback);
+
+JNIEXPORT jlong JNICALL
+Java_dev_deviceai_SpeechBridge_nativeSubmitTranscriptionAudio(
+    JNIEnv *env, jobject thiz,
+    jfloatArray samples,
+    jint priority,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs,
+    jobject callback);
+
+JNIEXPORT jboolean JNICALL
+Java_dev_deviceai_SpeechBridge_nativeCancelSttJob(
+    JNIEnv *env, jobject thiz,
+    jlong jobId);
+
+// ═══════════════════════════════════════════════════════════════
+//                       MODEL REGISTRY
+// ═══════════════════════════════════════════════════════════════
+
+JNIEXPORT jboolean JNICALL
+Java_dev_deviceai_SpeechBridge_nativeLoadSttModel(
+    JNIEnv *env, jobject thiz,
+    jstring modelPath,
+    jboolean activate,
+    jobject callback);
+
+JNIEXPORT jboolean JNICALL
+Java_dev_deviceai_SpeechBridge_nativeUnloadSttModel(
+    JNIEnv *env, jobject thiz,
+    jstring modelPath);
+
+JNIEXPORT jobjectArray JNICALL
+Java_dev_deviceai_SpeechBridge_nativeResidentSttModels(
+    JNIEnv *env, jobject thiz);
+
 // ═══════════════════════════════════════════════════════════════
 //                    TEXT-TO-SPEECH (TTS)
 // ═══════════════════════════════════════════════════════════════
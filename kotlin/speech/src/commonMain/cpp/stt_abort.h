@@ -0,0 +1,86 @@
+/**
+ * stt_abort.h - Cancellation and deadlines for a running decode
+ *
+ * Checking a cancel flag between windows leaves a request running until the
+ * current 30 s window is fully decoded, which is seconds on a phone. Whisper
+ * polls abort_callback between compute-graph nodes (and asks
+ * encoder_begin_callback before each encoder pass), so routing the flag and
+ * the request's deadline through them stops a decode within tens of ms.
+ *
+ * A decode stopped this way keeps the segments it had already produced;
+ * callers return them with SttResult::partial set.
+ *
+ * Requests run concurrently, so the process-wide cancel is an epoch rather
+ * than a flag each request clears at its start (which would swallow a
+ * cancel aimed at a request already running): cancel() moves the epoch on,
+ * and a request stops once it has moved past the value it started with.
+ */
+
+#ifndef STT_ABORT_H
+#define STT_ABORT_H
+
+#include "stt_common.h"
+#include "whisper.h"
+
+#include <atomic>
+#include <cstdint>
+
+class SttCancelEpoch {
+public:
+    uint64_t current() const { return epoch_.load(std::memory_order_acquire); }
+    void cancel() { epoch_.fetch_add(1, std::memory_order_acq_rel); }
+
+private:
+    std::atomic<uint64_t> epoch_{0};
+};
+
+class SttAbort {
+public:
+    // `cancel` may be null. A `timeout_ms` <= 0 means no deadline; otherwise
+    // it counts from construction.
+    SttAbort(const std::atomic<bool> *cancel, int64_t timeout_ms)
+        : cancel_(cancel), deadline_ms_(timeout_ms > 0 ? now_ms() + timeout_ms : 0) {}
+
+    // Stops on any epoch->cancel() after construction: construct it where
+    // the request starts.
+    SttAbort(const SttCancelEpoch *epoch, int64_t timeout_ms)
+        : epoch_(epoch), epoch_start_(epoch != nullptr ? epoch->current() : 0),
+          deadline_ms_(timeout_ms > 0 ? now_ms() + timeout_ms : 0) {}
+
+    // Stops on either: the flag (e.g. a listener closing) or a process-wide
+    // cancel after construction.
+    SttAbort(const std::atomic<bool> *cancel, const SttCancelEpoch *epoch, int64_t timeout_ms)
+        : cancel_(cancel), epoch_(epoch), epoch_start_(epoch != nullptr ? epoch->current() : 0),
+          deadline_ms_(timeout_ms > 0 ? now_ms() + timeout_ms : 0) {}
+
+    bool cancelled() const {
+        return (cancel_ != nullptr && cancel_->load(std::memory_order_relaxed)) ||
+               (epoch_ != nullptr && epoch_->current() != epoch_start_);
+    }
+    bool expired() const { return deadline_ms_ != 0 && now_ms() >= deadline_ms_; }
+    bool stop() const { return cancelled() || expired(); }
+
+    // Points the params' abort hooks at this object, which must outlive
+    // every decode run with them.
+    void install(struct whisper_full_params &params) const {
+        params.abort_callback = abort_cb;
+        params.abort_callback_user_data = const_cast<SttAbort *>(this);
+        params.encoder_begin_callback = encoder_begin_cb;
+        params.encoder_begin_callback_user_data = const_cast<SttAbort *>(this);
+    }
+
+private:
+    static bool abort_cb(void *self) {
+        return static_cast<const SttAbort *>(self)->stop();
+    }
+    static bool encoder_begin_cb(struct whisper_context *, struct whisper_state *, void *self) {
+        return !static_cast<const SttAbort *>(self)->stop();
+    }
+
+    const std::atomic<bool> *cancel_ = nullptr;
+    const SttCancelEpoch *epoch_ = nullptr;
+    const uint64_t epoch_start_ = 0;
+    const long deadline_ms_;
+};
+
+#endif // STT_ABORT_H
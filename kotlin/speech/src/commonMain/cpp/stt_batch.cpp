@@ -0,0 +1,280 @@
+/**
+ * stt_batch.cpp - Many short, independent clips in one call
+ */
+
+#include "stt_batch.h"
+#include "stt_file.h"
+#include "vad.h"
+#include "wav_reader.h"
+
+#include <algorithm>
+
+static constexpr int64_t SAMPLES_PER_MS = WHISPER_SAMPLE_RATE / 1000;
+
+// Packed windows stay under whisper's 30 s input, clips are separated by a
+// second of silence, and only clips up to PACK_CLIP_MAX share a window.
+static constexpr size_t PACK_WINDOW_SAMPLES = 28 * WHISPER_SAMPLE_RATE;
+static constexpr size_t PACK_GAP_SAMPLES    = 1 * WHISPER_SAMPLE_RATE;
+static constexpr size_t PACK_CLIP_MAX       = 10 * WHISPER_SAMPLE_RATE;
+
+// Files up to this length are loaded into memory and batched as clips.
+static constexpr int64_t FILE_LOAD_MAX_MS = 30000;
+
+struct PreparedClip {
+    const float *audio = nullptr;  // what gets decoded: the clip or its VAD packing
+    size_t n_samples = 0;
+    bool vad = false;
+    VadPacked packed;
+};
+
+// Maps a clip-relative time from decoded (possibly VAD-packed) audio back to
+// the original clip.
+static int64_t to_clip_ms(const PreparedClip &clip, int64_t ms, bool is_end) {
+    return clip.vad ? clip.packed.to_original_ms(ms, is_end) : ms;
+}
+
+// A word of a packed decode and the decoded segment it belongs to.
+struct PackedWord {
+    std::string text;
+    int64_t t0_ms;
+    int64_t t1_ms;
+    int segment;
+};
+
+// Words of the decode in `state`, from its token timestamps. A token that
+// starts with a space (or a new segment) starts a word; the rest extend it.
+static void packed_words(struct whisper_context *ctx, struct whisper_state *state,
+                         std::vector<PackedWord> &words) {
+    const whisper_token eot = whisper_token_eot(ctx);
+    int n_segments = whisper_full_n_segments_from_state(state);
+    for (int i = 0; i < n_segments; i++) {
+        int n_tokens = whisper_full_n_tokens_from_state(state, i);
+        for (int j = 0; j < n_tokens; j++) {
+            whisper_token_data token = whisper_full_get_token_data_from_state(state, i, j);
+            if (token.id >= eot) continue;  // timestamps and other special tokens
+            const char *text = whisper_full_get_token_text_from_state(ctx, state, i, j);
+            if (text == nullptr || text[0] == '\0') continue;
+            if (words.empty() || words.back().segment != i || text[0] == ' ') {
+                words.push_back({text, token.t0 * 10, token.t1 * 10, i});
+            } else {
+                words.back().text += text;
+                words.back().t1_ms = token.t1 * 10;
+            }
+        }
+    }
+}
+
+// Decodes several clips laid out in one window. Each word goes to the clip
+// whose span (widened by half a gap on each side) holds its midpoint; a
+// clip's words are split into segments where the decoder's segments split,
+// unless `single_segment` asks for one per clip.
+static bool decode_packed(struct whisper_context *ctx,
+                          struct whisper_state *state,
+                          const struct whisper_full_params &word_params,
+                          bool single_segment,
+                          const std::vector<PreparedClip> &prepared,
+                          const std::vector<size_t> &group,
+                          std::vector<SttResult> &results,
+                          const SttAbort *abort) {
+    std::vector<float> window;
+    std::vector<int64_t> offsets;
+    for (size_t idx : group) {
+        if (!window.empty()) window.insert(window.end(), PACK_GAP_SAMPLES, 0.0f);
+        offsets.push_back((int64_t)window.size());
+        window.insert(window.end(), prepared[idx].audio, prepared[idx].audio + prepared[idx].n_samples);
+    }
+
+    std::vector<SttSegment> segments;
+    if (!stt_decode_buffer(ctx, state, word_params, window.data(), window.size(), false, segments, abort)) {
+        return false;
+    }
+    std::vector<PackedWord> words;
+    packed_words(ctx, state, words);
+
+    const int64_t half_gap = (int64_t)PACK_GAP_SAMPLES / 2;
+    std::vector<int> last_segment(group.size(), -1);  // decoded segment each clip's last segment came from
+    for (const PackedWord &word : words) {
+        int64_t mid = (word.t0_ms + word.t1_ms) / 2 * SAMPLES_PER_MS;
+        size_t k = 0;
+        while (k + 1 < group.size() && mid >= offsets[k + 1] - half_gap) k++;
+
+        const PreparedClip &clip = prepared[group[k]];
+        const int64_t off_ms = offsets[k] / SAMPLES_PER_MS;
+        const int64_t len_ms = (int64_t)clip.n_samples / SAMPLES_PER_MS;
+        int64_t t0 = std::min(std::max<int64_t>(word.t0_ms - off_ms, 0), len_ms);
+        int64_t t1 = std::min(std::max<int64_t>(word.t1_ms - off_ms, 0), len_ms);
+
+        SttResult &r = results[group[k]];
+        t0 = to_clip_ms(clip, t0, false);
+        t1 = to_clip_ms(clip, t1, true);
+        if (r.segments.empty() || (!single_segment && last_segment[k] != word.segment)) {
+            r.segments.push_back({"", t0, t1});
+            last_segment[k] = word.segment;
+        }
+        r.text += word.text;
+        r.segments.back().text += word.text;
+        r.segments.back().t1_ms = t1;
+    }
+    return true;
+}
+
+// Every input is independent of the others and of whatever a pooled state
+// decoded before.
+static struct whisper_full_params batch_params(const struct whisper_full_params &params, const SttAbort *abort) {
+    struct whisper_full_params batch = params;
+    WhisperStatePool::reset_for_reuse(batch);
+    if (abort != nullptr) abort->install(batch);
+    return batch;
+}
+
+std::vector<SttResult> stt_transcribe_batch(struct whisper_context *ctx,
+                                            WhisperStatePool &pool,
+                                            const struct whisper_full_params &params,
+                                            const std::vector<SttClip> &clips,
+                                            bool use_vad,
+                                            const SttAbort *abort) {
+    long t_start = now_ms();
+    std::vector<SttResult> results(clips.size());
+
+    // ── Prepare (VAD) and group ───────────────────────────────────
+    std::vector<PreparedClip> prepared(clips.size());
+    std::vector<std::vector<size_t>> groups;
+    size_t group_samples = 0;
+    for (size_t i = 0; i < clips.size(); i++) {
+        results[i].duration_ms = (int64_t)clips[i].n_samples / SAMPLES_PER_MS;
+
+        PreparedClip &p = prepared[i];
+        p.audio = clips[i].samples;
+        p.n_samples = clips[i].n_samples;
+        if (use_vad && p.n_samples > 0) {
+            vad_pack(p.audio, p.n_samples, vad_detect(p.audio, p.n_samples), p.packed);
+            p.vad = true;
+            p.audio = p.packed.samples();
+            p.n_samples = p.packed.n_samples();
+        }
+        if (p.n_samples == 0) continue;  // nothing to decode
+
+        bool packable = p.n_samples <= PACK_CLIP_MAX;
+        bool fits = !groups.empty() && group_samples > 0 &&
+                    group_samples + PACK_GAP_SAMPLES + p.n_samples <= PACK_WINDOW_SAMPLES;
+        if (packable && fits) {
+            groups.back().push_back(i);
+            group_samples += PACK_GAP_SAMPLES + p.n_samples;
+        } else {
+            groups.push_back({i});
+            group_samples = packable ? p.n_samples : 0;  // 0: nothing joins a long clip
+        }
+    }
+
+    struct whisper_full_params clip_params = batch_params(params, abort);
+
+    // Packed windows need token timing and the decoder's own segments to
+    // split the output between clips
+    struct whisper_full_params word_params = clip_params;
+    word_params.single_segment   = false;
+    word_params.token_timestamps = true;
+
+    // ── Decode across the pool ────────────────────────────────────
+    pool.run_parallel(groups.size(), [&](size_t g, struct whisper_state *state) {
+        const std::vector<size_t> &group = groups[g];
+        if (abort != nullptr && abort->stop()) {
+            for (size_t idx : group) results[idx].partial = true;
+            return true;
+        }
+
+        if (group.size() > 1) {
+            if (!decode_packed(ctx, state, word_params, clip_params.single_segment, prepared, group, results, abort)) {
+                LOGE("[BATCH] window %zu (%zu clips) failed", g, group.size());
+                for (size_t idx : group) {
+                    results[idx].text.clear();
+                    results[idx].segments.clear();
+                    results[idx].error = "Transcription failed";
+                }
+                return true;
+            }
+            if (abort != nullptr && abort->stop()) {
+                for (size_t idx : group) results[idx].partial = true;
+            }
+            return true;
+        }
+
+        size_t idx = group[0];
+        const PreparedClip &clip = prepared[idx];
+        std::vector<SttSegment> segments;
+        if (!stt_decode_buffer(ctx, state, clip_params, clip.audio, clip.n_samples, false, segments, abort)) {
+            LOGE("[BATCH] clip %zu failed", idx);
+            results[idx].error = "Transcription failed";
+            return true;
+        }
+        for (SttSegment &seg : segments) {
+            seg.t0_ms = to_clip_ms(clip, seg.t0_ms, false);
+            seg.t1_ms = to_clip_ms(clip, seg.t1_ms, true);
+            results[idx].text += seg.text;
+        }
+        results[idx].segments = std::move(segments);
+        results[idx].partial = abort != nullptr && abort->stop();
+        return true;
+    });
+
+    LOGI("[BATCH] %zu clip(s) in %zu window(s) on %d state(s): %ld ms",
+         clips.size(), groups.size(), pool.size(), now_ms() - t_start);
+    return results;
+}
+
+std::vector<SttResult> stt_transcribe_batch_files(struct whisper_context *ctx,
+                                                  WhisperStatePool &pool,
+                                                  const struct whisper_full_params &params,
+                                                  const std::vector<std::string> &paths,
+                                                  bool use_vad,
+                                                  const SttAbort *abort) {
+    std::vector<SttResult> results(paths.size());
+
+    // Short files become in-memory clips; long ones are streamed later
+    std::vector<std::vector<float>> audio;
+    std::vector<size_t> short_files;
+    std::vector<size_t> long_files;
+    for (size_t i = 0; i < paths.size(); i++) {
+        WavReader reader;
+        if (!reader.open(paths[i])) {
+            LOGE("[BATCH] cannot read file %zu: %s", i, paths[i].c_str());
+            results[i].error = "Cannot read audio file";
+            continue;
+        }
+        // Unknown length (FLAC without a sample count): stream it too
+        if (reader.duration_ms() == 0 || reader.duration_ms() > FILE_LOAD_MAX_MS) {
+            long_files.push_back(i);
+            continue;
+        }
+        std::vector<float> samples((size_t)(reader.duration_ms() + 1) * SAMPLES_PER_MS);
+        size_t n = 0, got;
+        while ((got = reader.read_16k(samples.data() + n, samples.size() - n)) > 0) {
+            n += got;
+            if (n == samples.size()) samples.resize(samples.size() + WHISPER_SAMPLE_RATE);
+        }
+        samples.resize(n);
+        audio.push_back(std::move(samples));
+        short_files.push_back(i);
+    }
+
+    std::vector<SttClip> clips;
+    for (const std::vector<float> &samples : audio) clips.push_back({samples.data(), samples.size()});
+    std::vector<SttResult> short_results = stt_transcribe_batch(ctx, pool, params, clips, use_vad, abort);
+    for (size_t k = 0; k < short_files.size(); k++) {
+        results[short_files[k]] = std::move(short_results[k]);
+    }
+
+    struct whisper_full_params file_params = batch_params(params, abort);
+    pool.run_parallel(long_files.size(), [&](size_t k, struct whisper_state *state) {
+        size_t idx = long_files[k];
+        WavReader reader;
+        if (!reader.open(paths[idx]) ||
+            !stt_transcribe_wav(ctx, state, file_params, reader, use_vad, results[idx], abort)) {
+            LOGE("[BATCH] file %zu failed: %s", idx, paths[idx].c_str());
+            results[idx] = SttResult();
+            results[idx].error = "Transcription failed";
+        }
+        return true;
+    });
+
+    return results;
+}
@@ -0,0 +1,52 @@
+/**
+ * stt_batch.h - Many short, independent clips in one call
+ *
+ * Clips are scheduled across every state of a WhisperStatePool. Short clips
+ * are also packed several to a decode window, separated by a second of
+ * silence, so they share one encoder pass instead of each paying for a
+ * padded 30 s window. Packed windows are decoded with token timestamps;
+ * every word goes back to the clip its midpoint falls in, and a clip's
+ * words are split into segments where the decoder split them.
+ */
+
+#ifndef STT_BATCH_H
+#define STT_BATCH_H
+
+#include "stt_abort.h"
+#include "stt_common.h"
+#include "whisper_state_pool.h"
+#include "whisper.h"
+
+#include <string>
+#include <vector>
+
+// 16 kHz mono samples owned by the caller.
+struct SttClip {
+    const float *samples = nullptr;
+    size_t n_samples = 0;
+};
+
+// One result per clip, in input order. Segment times are relative to the
+// start of each clip; result.language is left to the caller. A clip without
+// speech (with `use_vad`) yields an empty result; one that could not be
+// decoded an empty result with `error` set. Once `abort` fires, running
+// decodes stop and clips not yet started are skipped; their results are
+// marked partial.
+std::vector<SttResult> stt_transcribe_batch(struct whisper_context *ctx,
+                                            WhisperStatePool &pool,
+                                            const struct whisper_full_params &params,
+                                            const std::vector<SttClip> &clips,
+                                            bool use_vad,
+                                            const SttAbort *abort = nullptr);
+
+// Same for WAV files. Short files are loaded and packed like clips; files
+// longer than one window are streamed with stt_transcribe_wav(). A file
+// that cannot be read or decoded yields an empty result with `error` set.
+std::vector<SttResult> stt_transcribe_batch_files(struct whisper_context *ctx,
+                                                  WhisperStatePool &pool,
+                                                  const struct whisper_full_params &params,
+                                                  const std::vector<std::string> &paths,
+                                                  bool use_vad,
+                                                  const SttAbort *abort = nullptr);
+
+#endif // STT_BATCH_H
@@ -0,0 +1,40 @@
+/**
+ * stt_buckets.cpp - Encoder context sizes for short audio
+ */
+
+#include "stt_buckets.h"
+
+// Encoder frames per second of audio: 100 mel frames, halved by the conv stem.
+static constexpr int FRAMES_PER_SECOND = WHISPER_SAMPLE_RATE / 320;
+
+int stt_bucket_audio_ctx_at(struct whisper_context *ctx, size_t i) {
+    int frames = STT_AUDIO_CTX_BUCKETS_S[i] * FRAMES_PER_SECOND;
+    return frames < whisper_n_audio_ctx(ctx) ? frames : 0;
+}
+
+int stt_bucket_audio_ctx(struct whisper_context *ctx, size_t n_samples) {
+    for (size_t i = 0; i < STT_AUDIO_CTX_N_BUCKETS; i++) {
+        if (n_samples <= (size_t)STT_AUDIO_CTX_BUCKETS_S[i] * WHISPER_SAMPLE_RATE) {
+            return stt_bucket_audio_ctx_at(ctx, i);
+        }
+    }
+    return 0;
+}
+
+static bool stop_before_encoder(struct whisper_context *, struct whisper_state *, void *) {
+    return false;
+}
+
+bool stt_prime_state(struct whisper_context *ctx, struct whisper_state *state,
+                     const float *audio, size_t n_samples, int n_threads) {
+    struct whisper_full_params params = whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
+    params.language               = "en";  // not "auto": skip whisper's own full-size detection
+    params.n_threads              = n_threads;
+    params.audio_ctx              = stt_bucket_audio_ctx(ctx, n_samples);
+    params.print_progress         = false;
+    params.print_realtime         = false;
+    params.print_timestamps       = false;
+    params.print_special          = false;
+    params.encoder_begin_callback = stop_before_encoder;
+    return whisper_full_with_state(ctx, state, params, audio, (int)n_samples) == 0;
+}
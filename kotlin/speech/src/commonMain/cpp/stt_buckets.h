@@ -0,0 +1,44 @@
+/**
+ * stt_buckets.h - Encoder context sizes for short audio
+ *
+ * Whisper's encoder always attends over a 30 s window (1500 frames), so a
+ * 2 s command costs as much to encode as 30 s of speech. Setting
+ * whisper_full_params::audio_ctx to the clip's length cuts that, but sizing
+ * it from the exact sample count gives every input length its own encoder
+ * graph: the backend re-plans buffers (and GPU backends re-record work) for
+ * each new shape. Rounding up to a few fixed lengths keeps the set of shapes
+ * small enough to warm up once per pooled state (WhisperStatePool::warm_up)
+ * and still gives short clips most of the saving.
+ *
+ * Rounding up, never down, keeps the whole clip inside the encoder window.
+ */
+
+#ifndef STT_BUCKETS_H
+#define STT_BUCKETS_H
+
+#include "whisper.h"
+
+#include <cstddef>
+
+// Encoder window lengths in seconds, ascending; the last is whisper's full window.
+static constexpr int STT_AUDIO_CTX_BUCKETS_S[] = {2, 4, 8, 15, 30};
+
+static constexpr size_t STT_AUDIO_CTX_N_BUCKETS =
+    sizeof(STT_AUDIO_CTX_BUCKETS_S) / sizeof(STT_AUDIO_CTX_BUCKETS_S[0]);
+
+// audio_ctx for `n_samples` of 16 kHz audio: the smallest bucket that holds
+// it, in encoder frames. 0 (whisper's full window) once the clip needs the
+// full window, including clips longer than 30 s that whisper splits itself.
+int stt_bucket_audio_ctx(struct whisper_context *ctx, size_t n_samples);
+
+// audio_ctx of bucket `i` (see STT_AUDIO_CTX_BUCKETS_S); 0 for the full window.
+int stt_bucket_audio_ctx_at(struct whisper_context *ctx, size_t i);
+
+// Prepares `state` for direct whisper_encode/decode calls on `audio`: only
+// whisper_full_with_state() computes the mel and sets the state's
+// audio_ctx, so it is run with the bucketed audio_ctx and stopped before
+// the encoder. False if whisper fails.
+bool stt_prime_state(struct whisper_context *ctx, struct whisper_state *state,
+                     const float *audio, size_t n_samples, int n_threads);
+
+#endif // STT_BUCKETS_H
@@ -0,0 +1,251 @@
+/**
+ * stt_cache.cpp - Fingerprint-keyed LRU cache of transcription results
+ */
+
+#include "stt_cache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// ═══════════════════════════════════════════════════════════════
+//                          FINGERPRINT
+// ═══════════════════════════════════════════════════════════════
+
+static constexpr size_t FP_FRAME_SAMPLES = 640;  // 40 ms
+static constexpr float FP_STEP_DB = 3.0f;        // quantisation step
+static constexpr int FP_FLOOR_STEPS = 20;        // 60 dB below the loudest frame
+
+static constexpr uint64_t FNV_OFFSET = 1469598103934665603ull;
+static constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+static inline uint64_t fnv_mix(uint64_t h, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        h ^= (v >> (i * 8)) & 0xff;
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+static uint64_t fnv_string(const std::string &s) {
+    uint64_t h = FNV_OFFSET;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+uint64_t stt_audio_fingerprint(const float *audio, size_t n_samples) {
+    const size_t n_frames = n_samples / FP_FRAME_SAMPLES;
+
+    // Per frame: energy in dB and spectral tilt (energy of the first
+    // difference relative to the signal, a cheap high/low band ratio)
+    std::vector<float> energy_db(n_frames), tilt_db(n_frames);
+    float max_db = -200.0f;
+    for (size_t f = 0; f < n_frames; f++) {
+        const float *p = audio + f * FP_FRAME_SAMPLES;
+        float e = 0.0f, d = 0.0f;
+        for (size_t i = 0; i < FP_FRAME_SAMPLES; i++) {
+            e += p[i] * p[i];
+            if (i > 0) d += (p[i] - p[i - 1]) * (p[i] - p[i - 1]);
+        }
+        energy_db[f] = 10.0f * std::log10(e + 1e-10f);
+        tilt_db[f] = 10.0f * std::log10((d + 1e-10f) / (e + 1e-10f));
+        max_db = std::max(max_db, energy_db[f]);
+    }
+
+    // Gain-normalised and quantised: levels are relative to the loudest
+    // frame and tilt is a ratio, so scaling the samples leaves the hash
+    // unchanged
+    uint64_t h = fnv_mix(FNV_OFFSET, (uint64_t)n_frames);
+    for (size_t f = 0; f < n_frames; f++) {
+        int level = (int)std::lround((energy_db[f] - max_db) / FP_STEP_DB);
+        level = std::max(level, -FP_FLOOR_STEPS);
+        int tilt = level > -FP_FLOOR_STEPS ? (int)std::lround(tilt_db[f] / FP_STEP_DB) : 0;
+        h = fnv_mix(h, (uint64_t)(uint32_t)level << 32 | (uint32_t)tilt);
+    }
+    return h;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                           LRU CACHE
+// ═══════════════════════════════════════════════════════════════
+
+SttResultCache::SttResultCache(size_t max_bytes, std::string path)
+    : max_bytes_(max_bytes), path_(std::move(path)) {
+    if (!path_.empty() && load()) {
+        LOGI("[CACHE] loaded %zu result(s) (%zu bytes) from %s", lru_.size(), bytes_, path_.c_str());
+    }
+}
+
+uint64_t SttResultCache::key(uint64_t fingerprint, const std::string &config) {
+    return fnv_mix(fnv_string(config), fingerprint);
+}
+
+size_t SttResultCache::entry_bytes(const Entry &entry) {
+    size_t n = sizeof(Entry) + entry.config.size() + entry.result.text.size() +
+               entry.result.language.size();
+    for (const SttSegment &seg : entry.result.segments) n += sizeof(SttSegment) + seg.text.size();
+    return n;
+}
+
+bool SttResultCache::lookup(uint64_t fingerprint, const std::string &config, SttResult &result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key(fingerprint, config));
+    if (it == index_.end() || it->second->fingerprint != fingerprint || it->second->config != config) {
+        misses_++;
+        return false;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second);
+    result = it->second->result;
+    hits_++;
+    return true;
+}
+
+void SttResultCache::insert(uint64_t fingerprint, const std::string &config, const SttResult &result) {
+    Entry entry{fingerprint, config, result, 0};
+    entry.bytes = entry_bytes(entry);
+    if (entry.bytes > max_bytes_) return;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    insert_locked(std::move(entry));
+}
+
+void SttResultCache::insert_locked(Entry entry) {
+    const uint64_t k = key(entry.fingerprint, entry.config);
+    auto it = index_.find(k);
+    if (it != index_.end()) {
+        bytes_ -= it->second->bytes;
+        lru_.erase(it->second);
+        index_.erase(it);
+    }
+
+    bytes_ += entry.bytes;
+    lru_.push_front(std::move(entry));
+    index_[k] = lru_.begin();
+
+    while (bytes_ > max_bytes_ && !lru_.empty()) {
+        const Entry &old = lru_.back();
+        bytes_ -= old.bytes;
+        index_.erase(key(old.fingerprint, old.config));
+        lru_.pop_back();
+        evictions_++;
+    }
+}
+
+void SttResultCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.clear();
+    index_.clear();
+    bytes_ = 0;
+}
+
+SttCacheStats SttResultCache::stats() const {
+    SttCacheStats s;
+    s.hits = hits_;
+    s.misses = misses_;
+    s.evictions = evictions_;
+    std::lock_guard<std::mutex> lock(mutex_);
+    s.entries = (int64_t)lru_.size();
+    s.bytes = (int64_t)bytes_;
+    return s;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                          PERSISTENCE
+// ═══════════════════════════════════════════════════════════════
+//
+// Native-endian binary: magic, version, entry count, then the entries from
+// least to most recently used so a reload restores the LRU order.
+
+static constexpr uint32_t CACHE_MAGIC = 0x43524b53;  // "SKRC"
+static constexpr uint32_t CACHE_VERSION = 2;  // 2: segment times in packed-audio time
+
+static bool write_u64(FILE *f, uint64_t v) { return fwrite(&v, sizeof(v), 1, f) == 1; }
+
+static bool write_str(FILE *f, const std::string &s) {
+    return write_u64(f, s.size()) && (s.empty() || fwrite(s.data(), 1, s.size(), f) == s.size());
+}
+
+static bool read_u64(FILE *f, uint64_t &v) { return fread(&v, sizeof(v), 1, f) == 1; }
+
+static bool read_str(FILE *f, std::string &s) {
+    uint64_t n;
+    if (!read_u64(f, n) || n > (1u << 24)) return false;
+    s.resize((size_t)n);
+    return n == 0 || fread(&s[0], 1, (size_t)n, f) == n;
+}
+
+bool SttResultCache::save() const {
+    if (path_.empty()) return false;
+
+    // Write next to the target and rename, so a crash never leaves a torn file
+    const std::string tmp = path_ + ".tmp";
+    FILE *f = fopen(tmp.c_str(), "wb");
+    if (f == nullptr) {
+        LOGE("[CACHE] cannot write %s", tmp.c_str());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool ok = write_u64(f, ((uint64_t)CACHE_VERSION << 32) | CACHE_MAGIC) && write_u64(f, lru_.size());
+    for (auto it = lru_.rbegin(); ok && it != lru_.rend(); ++it) {
+        const SttResult &r = it->result;
+        ok = write_u64(f, it->fingerprint) && write_str(f, it->config) && write_str(f, r.text) &&
+             write_str(f, r.language) && write_u64(f, (uint64_t)r.duration_ms) &&
+             write_u64(f, r.segments.size());
+        for (size_t i = 0; ok && i < r.segments.size(); i++) {
+            const SttSegment &seg = r.segments[i];
+            ok = write_str(f, seg.text) && write_u64(f, (uint64_t)seg.t0_ms) &&
+                 write_u64(f, (uint64_t)seg.t1_ms);
+        }
+    }
+    ok = fclose(f) == 0 && ok;
+    if (!ok || std::rename(tmp.c_str(), path_.c_str()) != 0) {
+        LOGE("[CACHE] failed to save %s", path_.c_str());
+        std::remove(tmp.c_str());
+        return false;
+    }
+    LOGI("[CACHE] saved %zu result(s) to %s", lru_.size(), path_.c_str());
+    return true;
+}
+
+bool SttResultCache::load() {
+    FILE *f = fopen(path_.c_str(), "rb");
+    if (f == nullptr) return false;  // first run
+
+    uint64_t header, count;
+    bool ok = read_u64(f, header) && header == (((uint64_t)CACHE_VERSION << 32) | CACHE_MAGIC) &&
+              read_u64(f, count);
+    for (uint64_t n = 0; ok && n < count; n++) {
+        Entry entry{};
+        uint64_t duration, n_segments;
+        ok = read_u64(f, entry.fingerprint) && read_str(f, entry.config) &&
+             read_str(f, entry.result.text) && read_str(f, entry.result.language) &&
+             read_u64(f, duration) && read_u64(f, n_segments) && n_segments < (1u << 20);
+        for (uint64_t i = 0; ok && i < n_segments; i++) {
+            SttSegment seg;
+            uint64_t t0, t1;
+            ok = read_str(f, seg.text) && read_u64(f, t0) && read_u64(f, t1);
+            seg.t0_ms = (int64_t)t0;
+            seg.t1_ms = (int64_t)t1;
+            entry.result.segments.push_back(std::move(seg));
+        }
+        if (!ok) break;
+        entry.result.duration_ms = (int64_t)duration;
+        entry.bytes = entry_bytes(entry);
+        if (entry.bytes <= max_bytes_) insert_locked(std::move(entry));
+    }
+    fclose(f);
+
+    if (!ok) {
+        LOGE("[CACHE] ignoring unreadable cache file %s", path_.c_str());
+        lru_.clear();
+        index_.clear();
+        bytes_ = 0;
+    }
+    evictions_ = 0;
+    return ok;
+}
@@ -0,0 +1,93 @@
+/**
+ * stt_cache.h - Fingerprint-keyed LRU cache of transcription results
+ *
+ * Devices that hear the same prompts over and over (kiosks, announcements)
+ * can answer a repeated input from memory instead of running the model.
+ * Entries are keyed by a perceptual fingerprint of the audio that would be
+ * decoded (after VAD) plus the settings that change the output (model,
+ * language, translate). The fingerprint is an exact hash of gain-normalised,
+ * quantised frame energy and spectral tilt, so the same recording hits at
+ * any gain. Re-recorded or noisy audio is a different input and misses.
+ *
+ * Since the fingerprint ignores silence around the speech, one entry serves
+ * recordings with different padding: callers store segment times as decoded
+ * (packed-audio time) and remap them through each request's own VAD map.
+ *
+ * The cache is bounded by an approximate byte budget and can be persisted
+ * to a file so it survives restarts. It is thread-safe.
+ */
+
+#ifndef STT_CACHE_H
+#define STT_CACHE_H
+
+#include "stt_common.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Fingerprint of 16 kHz mono audio. Equal for identical audio, and for the
+// same samples scaled by any gain.
+uint64_t stt_audio_fingerprint(const float *audio, size_t n_samples);
+
+struct SttCacheStats {
+    int64_t hits = 0;
+    int64_t misses = 0;
+    int64_t evictions = 0;
+    int64_t entries = 0;
+    int64_t bytes = 0;
+};
+
+class SttResultCache {
+public:
+    // `path` may be empty (memory only). Otherwise the cache is loaded from
+    // it here and written back by save().
+    SttResultCache(size_t max_bytes, std::string path);
+
+    SttResultCache(const SttResultCache &) = delete;
+    SttResultCache &operator=(const SttResultCache &) = delete;
+
+    // `config` identifies the settings the result was produced with.
+    bool lookup(uint64_t fingerprint, const std::string &config, SttResult &result);
+    void insert(uint64_t fingerprint, const std::string &config, const SttResult &result);
+
+    void clear();
+    SttCacheStats stats() const;
+
+    // Writes every entry to the persistence file (no-op without one).
+    bool save() const;
+
+private:
+    struct Entry {
+        uint64_t fingerprint;
+        std::string config;
+        SttResult result;
+        size_t bytes;
+    };
+    using List = std::list<Entry>;
+
+    static uint64_t key(uint64_t fingerprint, const std::string &config);
+    static size_t entry_bytes(const Entry &entry);
+
+    // Caller holds mutex_.
+    void insert_locked(Entry entry);
+    bool load();
+
+    const size_t max_bytes_;
+    const std::string path_;
+
+    mutable std::mutex mutex_;
+    List lru_;  // most recently used first
+    std::unordered_map<uint64_t, List::iterator> index_;  // by key()
+    size_t bytes_ = 0;
+
+    std::atomic<int64_t> hits_{0};
+    std::atomic<int64_t> misses_{0};
+    std::atomic<int64_t> evictions_{0};
+};
+
+#endif // STT_CACHE_H
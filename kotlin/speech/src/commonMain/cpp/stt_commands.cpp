@@ -0,0 +1,164 @@
+/**
+ * stt_commands.cpp - Decoding restricted to a closed list of command phrases
+ */
+
+#include "stt_commands.h"
+#include "stt_buckets.h"
+#include "stt_common.h"
+#include "vad.h"
+
+#include <cctype>
+#include <cmath>
+
+SttCommandGrammar::SttCommandGrammar(struct whisper_context *ctx, const std::vector<std::string> &phrases)
+    : eot_(whisper_token_eot(ctx)), phrases_(phrases), nodes_(1) {
+    for (size_t i = 0; i < phrases_.size(); i++) {
+        const std::string &phrase = phrases_[i];
+        if (phrase.empty()) continue;
+        // Whisper starts a transcript with a space and usually a capital
+        add(ctx, " " + phrase, (int)i);
+        std::string capital = phrase;
+        capital[0] = (char)std::toupper((unsigned char)capital[0]);
+        if (capital != phrase) add(ctx, " " + capital, (int)i);
+    }
+    LOGI("[CMD] %zu phrase(s) -> %zu trie node(s), longest %d token(s)",
+         phrases_.size(), nodes_.size(), max_tokens_);
+}
+
+void SttCommandGrammar::add(struct whisper_context *ctx, const std::string &text, int phrase) {
+    std::vector<whisper_token> tokens(text.size() + 8);
+    int n = whisper_tokenize(ctx, text.c_str(), tokens.data(), (int)tokens.size());
+    if (n <= 0) {
+        LOGE("[CMD] cannot tokenize \"%s\"", text.c_str());
+        return;
+    }
+
+    int node = 0;
+    for (int i = 0; i <= n; i++) {
+        Node &current = nodes_[(size_t)node];
+        current.only = current.only == -1 || current.only == phrase ? phrase : -2;
+        if (i == n) break;
+
+        int next = child(node, tokens[(size_t)i]);
+        if (next < 0) {
+            next = (int)nodes_.size();
+            nodes_[(size_t)node].next.emplace_back(tokens[(size_t)i], next);
+            nodes_.emplace_back();
+        }
+        node = next;
+    }
+    if (nodes_[(size_t)node].ends < 0) nodes_[(size_t)node].ends = phrase;
+    if (n > max_tokens_) max_tokens_ = n;
+}
+
+int SttCommandGrammar::child(int node, whisper_token token) const {
+    for (const auto &edge : nodes_[(size_t)node].next) {
+        if (edge.first == token) return edge.second;
+    }
+    return -1;
+}
+
+int SttCommandGrammar::walk(const whisper_token_data *tokens, int n_tokens) const {
+    int node = 0;
+    for (int i = 0; i < n_tokens && node >= 0; i++) {
+        if (tokens[i].id < eot_) node = child(node, tokens[i].id);
+    }
+    return node;
+}
+
+int SttCommandGrammar::match(const whisper_token *tokens, size_t n_tokens) const {
+    int node = 0;
+    size_t n_text = 0;
+    for (size_t i = 0; i < n_tokens && node >= 0; i++) {
+        if (tokens[i] >= eot_) continue;
+        node = child(node, tokens[i]);
+        n_text++;
+    }
+    if (node < 0 || n_text == 0) return -1;
+    const Node &end = nodes_[(size_t)node];
+    return end.only >= 0 ? end.only : end.ends;
+}
+
+void SttCommandGrammar::install(struct whisper_full_params &params) const {
+    params.logits_filter_callback = filter;
+    params.logits_filter_callback_user_data = const_cast<SttCommandGrammar *>(this);
+}
+
+void SttCommandGrammar::filter(struct whisper_context *ctx, struct whisper_state *,
+                               const whisper_token_data *tokens, int n_tokens, float *logits, void *self) {
+    const auto *grammar = static_cast<const SttCommandGrammar *>(self);
+    const whisper_token eot = grammar->eot_;
+    const int n_vocab = whisper_n_vocab(ctx);
+
+    int node = grammar->walk(tokens, n_tokens);
+    float eot_logit = logits[eot];
+
+    // Keep the continuations of the prefix, unless it already fits one phrase
+    std::vector<std::pair<whisper_token, float>> keep;
+    bool unique = node > 0 && grammar->nodes_[(size_t)node].only >= 0;
+    if (node >= 0 && !unique) {
+        for (const auto &edge : grammar->nodes_[(size_t)node].next) {
+            keep.emplace_back(edge.first, logits[edge.first]);
+        }
+    }
+    bool may_end = node <= 0 || unique || grammar->nodes_[(size_t)node].ends >= 0;
+
+    for (int i = 0; i < n_vocab; i++) logits[i] = -INFINITY;
+    for (const auto &k : keep) logits[k.first] = k.second;
+    if (may_end) logits[eot] = unique ? 0.0f : eot_logit;
+}
+
+int stt_recognize_command(struct whisper_context *ctx,
+                          struct whisper_state *state,
+                          const struct whisper_full_params &params,
+                          const SttCommandGrammar &grammar,
+                          const float *audio, size_t n_samples,
+                          bool use_vad,
+                          const SttAbort *abort) {
+    VadPacked packed;
+    if (use_vad) {
+        vad_pack(audio, n_samples, vad_detect(audio, n_samples), packed);
+        if (packed.empty()) {
+            LOGD("[CMD] no speech");
+            return -1;
+        }
+        audio = packed.samples();
+        n_samples = packed.n_samples();
+    }
+    if (n_samples == 0 || grammar.size() == 0) return -1;
+
+    struct whisper_full_params cmd = params;
+    cmd.strategy         = WHISPER_SAMPLING_GREEDY;
+    cmd.no_context       = true;
+    cmd.no_timestamps    = true;
+    cmd.single_segment   = true;
+    cmd.token_timestamps = false;
+    cmd.suppress_blank   = false;  // keeps the no-command exit open at the first step
+    cmd.temperature_inc  = 0.0f;
+    cmd.max_tokens       = grammar.max_tokens() + 1;
+    cmd.initial_prompt   = nullptr;
+    cmd.prompt_tokens    = nullptr;
+    cmd.prompt_n_tokens  = 0;
+    cmd.audio_ctx        = stt_bucket_audio_ctx(ctx, n_samples);
+    grammar.install(cmd);
+    if (abort != nullptr) abort->install(cmd);
+
+    long t_start = now_ms();
+    if (whisper_full_with_state(ctx, state, cmd, audio, (int)n_samples) != 0) {
+        if (abort != nullptr && abort->stop()) return -1;
+        LOGE("[CMD] whisper_full_with_state failed on %zu samples", n_samples);
+        return -2;
+    }
+
+    std::vector<whisper_token> tokens;
+    int n_segments = whisper_full_n_segments_from_state(state);
+    for (int s = 0; s < n_segments; s++) {
+        int n = whisper_full_n_tokens_from_state(state, s);
+        for (int t = 0; t < n; t++) tokens.push_back(whisper_full_get_token_id_from_state(state, s, t));
+    }
+    int index = grammar.match(tokens.data(), tokens.size());
+    LOGI("[CMD] %s after %zu token(s) over %.2fs: %ld ms",
+         index >= 0 ? grammar.phrase(index).c_str() : "(no command)", tokens.size(),
+         (float)n_samples / WHISPER_SAMPLE_RATE, now_ms() - t_start);
+    return index;
+}
@@ -0,0 +1,77 @@
+/**
+ * stt_commands.h - Decoding restricted to a closed list of command phrases
+ *
+ * Voice commands come from a vocabulary of a few hundred phrases, but a free
+ * decode spends a step on every token, can drift to words that are no
+ * command at all, and runs whisper's temperature fallback when unsure. Here
+ * the phrases are tokenized once into a token trie, and the trie runs as
+ * whisper's logits filter: at each step only the tokens that continue some
+ * phrase (or end one) are allowed. As soon as the decoded prefix fits a
+ * single phrase the filter forces end-of-text, so "turn on the kitchen
+ * lights" can finish after "turn on the k".
+ *
+ * End-of-text is also allowed before the first token, which gives the
+ * decoder a way to reject audio that is no command.
+ */
+
+#ifndef STT_COMMANDS_H
+#define STT_COMMANDS_H
+
+#include "stt_abort.h"
+#include "whisper.h"
+
+#include <string>
+#include <vector>
+
+class SttCommandGrammar {
+public:
+    // Tokenizes `phrases` with `ctx`'s vocabulary. The grammar keeps no
+    // reference to `ctx` and fits every model sharing that vocabulary.
+    SttCommandGrammar(struct whisper_context *ctx, const std::vector<std::string> &phrases);
+
+    size_t size() const { return phrases_.size(); }
+    const std::string &phrase(int i) const { return phrases_[(size_t)i]; }
+
+    // Longest tokenized phrase; a decode never needs more steps.
+    int max_tokens() const { return max_tokens_; }
+
+    // Points `params`' logits filter at this grammar (replacing any other
+    // filter), which must outlive every decode run with them.
+    void install(struct whisper_full_params &params) const;
+
+    // Index of the phrase the decoded text tokens select, or -1.
+    int match(const whisper_token *tokens, size_t n_tokens) const;
+
+private:
+    struct Node {
+        std::vector<std::pair<whisper_token, int>> next;
+        int ends = -1;  // phrase ending here, if any
+        int only = -1;  // the one phrase below this node; -2 if several
+    };
+
+    void add(struct whisper_context *ctx, const std::string &text, int phrase);
+    int child(int node, whisper_token token) const;
+    // Node reached by the text tokens among `tokens`; -1 if off the trie.
+    int walk(const whisper_token_data *tokens, int n_tokens) const;
+    static void filter(struct whisper_context *ctx, struct whisper_state *state,
+                       const whisper_token_data *tokens, int n_tokens, float *logits, void *self);
+
+    whisper_token eot_;
+    std::vector<std::string> phrases_;
+    std::vector<Node> nodes_;
+    int max_tokens_ = 0;
+};
+
+// Decodes 16 kHz `audio` on `state` against `grammar`: greedy, a single
+// segment without timestamps, no temperature fallback. With `use_vad`,
+// audio without speech is rejected before decoding. Returns the phrase
+// index, -1 for no command, -2 if whisper fails.
+int stt_recognize_command(struct whisper_context *ctx,
+                          struct whisper_state *state,
+                          const struct whisper_full_params &params,
+                          const SttCommandGrammar &grammar,
+                          const float *audio, size_t n_samples,
+                          bool use_vad,
+                          const SttAbort *abort = nullptr);
+
+#endif // STT_COMMANDS_H
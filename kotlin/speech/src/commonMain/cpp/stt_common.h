@@ -0,0 +1,62 @@
+/**
+ * stt_common.h - Shared helpers for the native STT layer
+ *
+ * Plain C++ (no JNI) so it can be compiled into both the JNI library
+ * (Android / Desktop) and the iOS static wrapper.
+ */
+
+#ifndef STT_COMMON_H
+#define STT_COMMON_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+// Convenience: milliseconds since an arbitrary epoch (for latency spans)
+static inline long now_ms() {
+    using namespace std::chrono;
+    return (long)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                     PLATFORM-SPECIFIC LOGGING
+// ═══════════════════════════════════════════════════════════════
+
+#ifdef __ANDROID__
+#include <android/log.h>
+#define LOG_TAG "SpeechKMP-STT"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
+#else
+#include <cstdio>
+#define LOGI(...) fprintf(stdout, "[SpeechKMP-STT INFO] " __VA_ARGS__); fprintf(stdout, "\n")
+#define LOGE(...) fprintf(stderr, "[SpeechKMP-STT ERROR] " __VA_ARGS__); fprintf(stderr, "\n")
+#define LOGD(...) fprintf(stdout, "[SpeechKMP-STT DEBUG] " __VA_ARGS__); fprintf(stdout, "\n")
+#endif
+
+// ═══════════════════════════════════════════════════════════════
+//                          SHARED TYPES
+// ═══════════════════════════════════════════════════════════════
+
+// A timed piece of transcribed text. Times are in milliseconds from the
+// start of the audio the caller handed in (not from the decode window).
+struct SttSegment {
+    std::string text;
+    int64_t t0_ms = 0;
+    int64_t t1_ms = 0;
+    int channel = -1;  // source channel of a per-channel transcription; -1: all channels mixed
+};
+
+// Platform-neutral counterpart of the Kotlin TranscriptionResult.
+struct SttResult {
+    std::string text;
+    std::vector<SttSegment> segments;
+    std::string language;
+    int64_t duration_ms = 0;
+    bool partial = false;  // stopped early (cancel or deadline); holds what was decoded
+    std::string error;     // why a batch input yielded nothing; empty on success
+};
+
+#endif // STT_COMMON_H
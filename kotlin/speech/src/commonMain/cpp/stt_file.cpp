@@ -0,0 +1,463 @@
+/**
+ * stt_file.cpp - Bounded-memory transcription of WAV files
+ */
+
+#include "stt_file.h"
+#include "stt_buckets.h"
+#include "vad.h"
+
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+// Whisper's native input length; larger windows would be split internally.
+static constexpr size_t WINDOW_SAMPLES = 30 * WHISPER_SAMPLE_RATE;
+
+static constexpr int64_t SAMPLES_PER_MS = WHISPER_SAMPLE_RATE / 1000;
+
+// Long-form chunks are cut at the quietest ~300 ms between MIN and MAX, and
+// run OVERLAP past the cut so words straddling it are heard whole by one side.
+static constexpr size_t CHUNK_MIN_SAMPLES = 20 * WHISPER_SAMPLE_RATE;
+static constexpr size_t CHUNK_MAX_SAMPLES = 29 * WHISPER_SAMPLE_RATE;
+static constexpr size_t OVERLAP_SAMPLES   = 1 * WHISPER_SAMPLE_RATE;
+static constexpr size_t PAUSE_FRAME       = 480;  // 30 ms
+static constexpr size_t PAUSE_FRAMES      = 10;   // frames per candidate pause
+
+// Decoded chunks queued per worker; bounds memory for arbitrarily long files.
+static constexpr size_t QUEUE_PER_WORKER = 2;
+
+// Longest run of words compared when removing text repeated across a cut.
+static constexpr size_t MAX_OVERLAP_WORDS = 8;
+
+// ═══════════════════════════════════════════════════════════════
+//                         SINGLE BUFFER
+// ═══════════════════════════════════════════════════════════════
+
+bool stt_decode_buffer(struct whisper_context *ctx,
+                       struct whisper_state *state,
+                       const struct whisper_full_params &params,
+                       const float *audio, size_t n_samples,
+                       bool use_vad,
+                       std::vector<SttSegment> &segments,
+                       const SttAbort *abort) {
+    VadPacked packed;
+    if (use_vad) {
+        vad_pack(audio, n_samples, vad_detect(audio, n_samples), packed);
+        if (packed.empty()) return true;
+        LOGD("[VAD] %.2fs -> %.2fs in %zu region(s)",
+             (float)n_samples / WHISPER_SAMPLE_RATE,
+             (float)packed.n_samples() / WHISPER_SAMPLE_RATE, packed.pieces.size());
+        audio = packed.samples();
+        n_samples = packed.n_samples();
+    }
+
+    // Encoder window rounded up to a bucket, unless the caller sized it
+    struct whisper_full_params decode_params = params;
+    if (decode_params.audio_ctx == 0) decode_params.audio_ctx = stt_bucket_audio_ctx(ctx, n_samples);
+
+    // An aborted decode may still return 0 (stopped before an encoder pass);
+    // either way the state holds the segments of the windows it finished.
+    if (whisper_full_with_state(ctx, state, decode_params, audio, (int)n_samples) != 0 &&
+        (abort == nullptr || !abort->stop())) {
+        return false;
+    }
+
+    std::vector<SttSegment> decoded;
+    int n_segments = whisper_full_n_segments_from_state(state);
+    for (int i = 0; i < n_segments; i++) {
+        const char *text = whisper_full_get_segment_text_from_state(state, i);
+        if (!text) continue;
+        SttSegment seg;
+        seg.text  = text;
+        seg.t0_ms = whisper_full_get_segment_t0_from_state(state, i) * 10;
+        seg.t1_ms = whisper_full_get_segment_t1_from_state(state, i) * 10;
+        decoded.push_back(std::move(seg));
+    }
+    if (use_vad) vad_remap(packed, decoded);
+
+    segments.insert(segments.end(), std::make_move_iterator(decoded.begin()),
+                    std::make_move_iterator(decoded.end()));
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                       SEQUENTIAL WINDOWS
+// ═══════════════════════════════════════════════════════════════
+
+bool stt_transcribe_wav(struct whisper_context *ctx,
+                        struct whisper_state *state,
+                        const struct whisper_full_params &params,
+                        WavReader &reader,
+                        bool use_vad,
+                        SttResult &result,
+                        const SttAbort *abort) {
+    // Windows always decode into segments: carrying the last one over needs
+    // more than one per window. A single segment is rebuilt at the end.
+    struct whisper_full_params window_params = params;
+    window_params.single_segment = false;
+    if (abort != nullptr) abort->install(window_params);
+    const size_t first_segment = result.segments.size();
+
+    std::vector<float> window(WINDOW_SAMPLES);
+    size_t filled = 0;
+    int64_t window_start = 0;   // file position of window[0], in 16 kHz samples
+    bool eof = false;
+
+    while (true) {
+        if (abort != nullptr && abort->stop()) {
+            LOGI("File transcription %s at %lld ms", abort->cancelled() ? "cancelled" : "timed out",
+                 (long long)(window_start / SAMPLES_PER_MS));
+            result.partial = true;
+            break;
+        }
+
+        while (!eof && filled < WINDOW_SAMPLES) {
+            size_t n = reader.read_16k(window.data() + filled, WINDOW_SAMPLES - filled);
+            if (n == 0) eof = true;
+            filled += n;
+        }
+        if (filled == 0) break;
+
+        long t_window = now_ms();
+        std::vector<SttSegment> segments;
+        if (!stt_decode_buffer(ctx, state, window_params, window.data(), filled, use_vad, segments, abort)) {
+            return false;
+        }
+        const bool stopped = abort != nullptr && abort->stop();
+
+        // Hold back the last segment unless this window reaches the end of
+        // the file (or is the last one decoded); it is re-decoded with the
+        // audio that follows it.
+        int n_segments = (int)segments.size();
+        int n_keep = n_segments;
+        size_t consumed = filled;
+        if (!eof && !stopped && n_segments > 1) {
+            size_t carry_from = (size_t)(segments.back().t0_ms * SAMPLES_PER_MS);
+            if (carry_from > 0 && carry_from < filled) {
+                n_keep = n_segments - 1;
+                consumed = carry_from;
+            }
+        }
+
+        int64_t offset_ms = window_start / SAMPLES_PER_MS;
+        for (int i = 0; i < n_keep; i++) {
+            SttSegment &seg = segments[i];
+            seg.t0_ms += offset_ms;
+            seg.t1_ms += offset_ms;
+            result.text += seg.text;
+            result.segments.push_back(std::move(seg));
+        }
+
+        LOGD("Window @%lld ms: %.2f s in %ld ms, %d/%d segment(s) kept",
+             (long long)offset_ms, (float)filled / WHISPER_SAMPLE_RATE,
+             now_ms() - t_window, n_keep, n_segments);
+
+        std::memmove(window.data(), window.data() + consumed, (filled - consumed) * sizeof(float));
+        filled -= consumed;
+        window_start += (int64_t)consumed;
+
+        if (eof && filled == 0 && !stopped) break;  // a stop is reported at the top of the loop
+    }
+
+    if (params.single_segment && result.segments.size() > first_segment + 1) {
+        SttSegment joined = std::move(result.segments[first_segment]);
+        for (size_t i = first_segment + 1; i < result.segments.size(); i++) {
+            joined.text += result.segments[i].text;
+            joined.t1_ms = result.segments[i].t1_ms;
+        }
+        result.segments.resize(first_segment);
+        result.segments.push_back(std::move(joined));
+    }
+
+    result.duration_ms = reader.duration_ms();
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                     LONG-FORM (PARALLEL)
+// ═══════════════════════════════════════════════════════════════
+
+struct LongFormChunk {
+    size_t index = 0;
+    int64_t start = 0;       // file position of audio[0], in 16 kHz samples
+    int64_t owned_end = 0;   // file position where the next chunk takes over
+    std::vector<float> audio;
+};
+
+// Cut position in [lo, hi): the middle of the quietest PAUSE_FRAMES window.
+static size_t find_pause(const float *audio, size_t lo, size_t hi) {
+    size_t n_frames = (hi - lo) / PAUSE_FRAME;
+    if (n_frames <= PAUSE_FRAMES) return hi;
+
+    std::vector<double> energy(n_frames);
+    for (size_t f = 0; f < n_frames; f++) {
+        const float *p = audio + lo + f * PAUSE_FRAME;
+        double sum = 0.0;
+        for (size_t i = 0; i < PAUSE_FRAME; i++) sum += p[i] * p[i];
+        energy[f] = sum;
+    }
+
+    double window = 0.0;
+    for (size_t f = 0; f < PAUSE_FRAMES; f++) window += energy[f];
+    double best = window;
+    size_t best_start = 0;
+    for (size_t f = PAUSE_FRAMES; f < n_frames; f++) {
+        window += energy[f] - energy[f - PAUSE_FRAMES];
+        if (window < best) {
+            best = window;
+            best_start = f - PAUSE_FRAMES + 1;
+        }
+    }
+    return lo + (best_start + PAUSE_FRAMES / 2) * PAUSE_FRAME;
+}
+
+// Lowercased alphanumerics only, so "Hello," and "hello" compare equal.
+static std::string normalize_word(const std::string &word) {
+    std::string out;
+    for (char c : word) {
+        if (std::isalnum((unsigned char)c)) out += (char)std::tolower((unsigned char)c);
+    }
+    return out;
+}
+
+// Words of `text` with the offset just past each one.
+static std::vector<std::pair<std::string, size_t>> split_words(const std::string &text) {
+    std::vector<std::pair<std::string, size_t>> words;
+    size_t i = 0;
+    while (i < text.size()) {
+        while (i < text.size() && std::isspace((unsigned char)text[i])) i++;
+        size_t begin = i;
+        while (i < text.size() && !std::isspace((unsigned char)text[i])) i++;
+        if (i > begin) words.emplace_back(normalize_word(text.substr(begin, i - begin)), i);
+    }
+    return words;
+}
+
+// Drops the leading words of `text` that repeat the last words of `tail`
+// (both sides of a cut transcribed the overlap).
+static std::string strip_repeated_prefix(const std::string &tail, const std::string &text) {
+    auto tail_words = split_words(tail);
+    auto text_words = split_words(text);
+    size_t max_k = std::min({MAX_OVERLAP_WORDS, tail_words.size(), text_words.size()});
+    for (size_t k = max_k; k > 0; k--) {
+        bool match = true;
+        for (size_t j = 0; j < k && match; j++) {
+            const std::string &a = tail_words[tail_words.size() - k + j].first;
+            match = !a.empty() && a == text_words[j].first;
+        }
+        if (match) return text.substr(text_words[k - 1].second);
+    }
+    return text;
+}
+
+bool stt_transcribe_wav_parallel(struct whisper_context *ctx,
+                                 WhisperStatePool &pool,
+                                 const struct whisper_full_params &params,
+                                 WavReader &reader,
+                                 bool use_vad,
+                                 SttResult &result,
+                                 const SttAbort *abort) {
+    const size_t n_workers = (size_t)pool.size();
+    const size_t max_queued = n_workers * QUEUE_PER_WORKER;
+    long t_start = now_ms();
+
+    // Chunks are independent: no prompt carried over from whatever the
+    // leased state decoded before.
+    struct whisper_full_params chunk_params = params;
+    WhisperStatePool::reset_for_reuse(chunk_params);
+    if (abort != nullptr) abort->install(chunk_params);
+
+    std::mutex mutex;
+    std::condition_variable work_ready;
+    std::condition_variable space_ready;
+    std::deque<LongFormChunk> queue;
+    bool producing = true;
+    std::atomic<bool> failed{false};
+    std::vector<std::vector<SttSegment>> chunk_segments;
+    std::vector<int64_t> chunk_owned_end_ms;
+
+    auto stopped = [abort] { return abort != nullptr && abort->stop(); };
+
+    auto worker = [&]() {
+        WhisperStatePool::Lease lease;
+        while (true) {
+            LongFormChunk chunk;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                work_ready.wait(lock, [&] { return !queue.empty() || !producing; });
+                if (queue.empty()) return;
+                chunk = std::move(queue.front());
+                queue.pop_front();
+            }
+            space_ready.notify_one();
+            if (failed || stopped()) continue;
+
+            // Lease on first use, so short files don't tie up the whole pool
+            if (!lease) lease = pool.acquire();
+            std::vector<SttSegment> segments;
+            if (!lease ||
+                !stt_decode_buffer(ctx, lease.state(), chunk_params,
+                                   chunk.audio.data(), chunk.audio.size(), use_vad, segments, abort)) {
+                LOGE("[LONGFORM] chunk %zu failed", chunk.index);
+                failed = true;
+                continue;
+            }
+
+            int64_t offset_ms = chunk.start / SAMPLES_PER_MS;
+            for (SttSegment &seg : segments) {
+                seg.t0_ms += offset_ms;
+                seg.t1_ms += offset_ms;
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            chunk_segments[chunk.index] = std::move(segments);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < n_workers; i++) workers.emplace_back(worker);
+
+    // ── Produce chunks (this thread) ──────────────────────────────
+    std::vector<float> pending;
+    pending.reserve(CHUNK_MAX_SAMPLES + OVERLAP_SAMPLES);
+    int64_t pending_start = 0;
+    bool eof = false;
+    size_t n_chunks = 0;
+
+    while (!failed) {
+        if (stopped()) {
+            LOGI("[LONGFORM] %s at %lld ms", abort->cancelled() ? "cancelled" : "timed out",
+                 (long long)(pending_start / SAMPLES_PER_MS));
+            break;
+        }
+
+        const size_t want = CHUNK_MAX_SAMPLES + OVERLAP_SAMPLES;
+        while (!eof && pending.size() < want) {
+            size_t have = pending.size();
+            pending.resize(want);
+            size_t n = reader.read_16k(pending.data() + have, want - have);
+            pending.resize(have + n);
+            if (n == 0) eof = true;
+        }
+        if (pending.empty()) break;
+
+        size_t cut = (eof && pending.size() <= want)
+            ? pending.size()
+            : find_pause(pending.data(), CHUNK_MIN_SAMPLES, CHUNK_MAX_SAMPLES);
+        size_t end = std::min(pending.size(), cut + OVERLAP_SAMPLES);
+
+        LongFormChunk chunk;
+        chunk.index = n_chunks++;
+        chunk.start = pending_start;
+        chunk.owned_end = pending_start + (int64_t)cut;
+        chunk.audio.assign(pending.begin(), pending.begin() + (std::ptrdiff_t)end);
+
+        pending.erase(pending.begin(), pending.begin() + (std::ptrdiff_t)cut);
+        pending_start += (int64_t)cut;
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            space_ready.wait(lock, [&] { return queue.size() < max_queued; });
+            chunk_segments.emplace_back();
+            chunk_owned_end_ms.push_back(chunk.owned_end / SAMPLES_PER_MS);
+            queue.push_back(std::move(chunk));
+        }
+        work_ready.notify_one();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        producing = false;
+    }
+    work_ready.notify_all();
+    for (std::thread &t : workers) t.join();
+
+    if (failed) return false;
+    // Chunks decode out of order, so after a stop the text may have holes;
+    // it is still returned (in order), marked partial.
+    result.partial = stopped();
+
+    // ── Stitch in order ───────────────────────────────────────────
+    // A chunk's segments that start past its cut belong to the next chunk;
+    // segments already covered by the stitched timeline are dropped, and the
+    // first words of each chunk are checked against the stitched tail.
+    int64_t stitched_end_ms = 0;
+    for (size_t k = 0; k < chunk_segments.size(); k++) {
+        bool first_of_chunk = true;
+        for (SttSegment &seg : chunk_segments[k]) {
+            if (k + 1 < chunk_segments.size() && seg.t0_ms >= chunk_owned_end_ms[k]) continue;
+            if (!result.segments.empty()) {
+                if (seg.t1_ms <= stitched_end_ms) continue;
+                if (first_of_chunk) {
+                    size_t tail = std::min<size_t>(result.text.size(), 256);
+                    seg.text = strip_repeated_prefix(result.text.substr(result.text.size() - tail), seg.text);
+                    if (split_words(seg.text).empty()) continue;
+                }
+                seg.t0_ms = std::max(seg.t0_ms, stitched_end_ms);
+            }
+            first_of_chunk = false;
+            stitched_end_ms = seg.t1_ms;
+            result.text += seg.text;
+            result.segments.push_back(std::move(seg));
+        }
+    }
+
+    result.duration_ms = reader.duration_ms();
+    LOGI("[LONGFORM] %zu chunk(s) on %zu worker(s): %.1f s of audio in %ld ms",
+         n_chunks, n_workers, (float)result.duration_ms / 1000.0f, now_ms() - t_start);
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                        PER CHANNEL
+// ═══════════════════════════════════════════════════════════════
+
+bool stt_transcribe_wav_channels(struct whisper_context *ctx,
+                                 WhisperStatePool &pool,
+                                 const struct whisper_full_params &params,
+                                 const WavReader &reader,
+                                 bool use_vad,
+                                 SttResult &result,
+                                 const SttAbort *abort) {
+    const size_t n_channels = (size_t)std::max(reader.channels(), 0);
+    long t_start = now_ms();
+
+    // Channels are independent: no prompt carried over between them
+    struct whisper_full_params channel_params = params;
+    WhisperStatePool::reset_for_reuse(channel_params);
+
+    // One reader per channel: the file is mapped again, not copied
+    std::vector<SttResult> channels(n_channels);
+    bool ok = pool.run_parallel(n_channels, [&](size_t c, struct whisper_state *state) {
+        WavReader channel_reader;
+        if (!channel_reader.open(reader.path()) || !channel_reader.select_channel((int)c)) return false;
+        if (!stt_transcribe_wav(ctx, state, channel_params, channel_reader, use_vad, channels[c], abort)) {
+            LOGE("[CHANNELS] channel %zu failed", c);
+            return false;
+        }
+        return true;
+    });
+    if (!ok) return false;
+
+    for (size_t c = 0; c < n_channels; c++) {
+        for (SttSegment &seg : channels[c].segments) {
+            seg.channel = (int)c;
+            result.segments.push_back(std::move(seg));
+        }
+        result.partial = result.partial || channels[c].partial;
+    }
+    std::stable_sort(result.segments.begin(), result.segments.end(),
+                     [](const SttSegment &a, const SttSegment &b) { return a.t0_ms < b.t0_ms; });
+    for (const SttSegment &seg : result.segments) result.text += seg.text;
+
+    result.duration_ms = reader.duration_ms();
+    LOGI("[CHANNELS] %zu channel(s) on up to %d state(s): %.1f s of audio in %ld ms",
+         n_channels, pool.size(), (float)result.duration_ms / 1000.0f, now_ms() - t_start);
+    return true;
+}
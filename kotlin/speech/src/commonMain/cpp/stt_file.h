@@ -0,0 +1,87 @@
+/**
+ * stt_file.h - Bounded-memory transcription of WAV files
+ *
+ * Audio is pulled from a WavReader into a fixed 30 s window, transcribed,
+ * and the window refilled, so a multi-hour file never has to be resident.
+ * The last segment of each window may be cut mid-word at the window edge;
+ * its audio is carried into the next window and decoded again there (the
+ * same seek strategy whisper_full uses internally). Windows are therefore
+ * always decoded into several segments; with params.single_segment they are
+ * joined into one afterwards.
+ *
+ * Long-form mode trades that sequential dependency for throughput: the file
+ * is cut at pauses into ~30 s chunks that are decoded concurrently on
+ * separate pooled states and stitched back together in order.
+ *
+ * Per-channel mode is for recordings with one speaker per channel (e.g. a
+ * call centre's agent / customer stereo): downmixing them loses who said
+ * what and lets crosstalk garble both. Each channel is read on its own and
+ * transcribed concurrently on a separate pooled state.
+ */
+
+#ifndef STT_FILE_H
+#define STT_FILE_H
+
+#include "stt_abort.h"
+#include "stt_common.h"
+#include "wav_reader.h"
+#include "whisper_state_pool.h"
+#include "whisper.h"
+
+#include <vector>
+
+// Runs whisper over one 16 kHz buffer and appends its segments,
+// timed from audio[0], to `segments`. With `use_vad` the silence between
+// speech regions is cut out first (see vad.h) and the times are mapped back;
+// a buffer without speech yields no segments and no decode. With `abort`
+// installed in `params` (see SttAbort::install), a decode it stops keeps the
+// segments finished so far. Returns false if whisper fails otherwise.
+bool stt_decode_buffer(struct whisper_context *ctx,
+                       struct whisper_state *state,
+                       const struct whisper_full_params &params,
+                       const float *audio, size_t n_samples,
+                       bool use_vad,
+                       std::vector<SttSegment> &segments,
+                       const SttAbort *abort = nullptr);
+
+// Transcribes everything left in `reader` on `state`. Segment times in
+// `result` are relative to the start of the file; result.language is left
+// to the caller. `use_vad` applies per window, as in stt_decode_buffer().
+// Once `abort` fires the decode stops mid-window and the segments so far are
+// kept, with result.partial set. Returns false if whisper fails.
+bool stt_transcribe_wav(struct whisper_context *ctx,
+                        struct whisper_state *state,
+                        const struct whisper_full_params &params,
+                        WavReader &reader,
+                        bool use_vad,
+                        SttResult &result,
+                        const SttAbort *abort = nullptr);
+
+// Long-form mode: splits the file at pauses into ~30 s chunks (each running
+// 1 s into the next) and decodes them concurrently, one worker per state in
+// `pool`. Chunks are decoded without context from their predecessor; text
+// that both neighbours produced for the overlap is kept once. Only a few
+// chunks per worker are buffered, so memory stays bounded. Same result and
+// abort contract as stt_transcribe_wav().
+bool stt_transcribe_wav_parallel(struct whisper_context *ctx,
+                                 WhisperStatePool &pool,
+                                 const struct whisper_full_params &params,
+                                 WavReader &reader,
+                                 bool use_vad,
+                                 SttResult &result,
+                                 const SttAbort *abort = nullptr);
+
+// Per-channel mode: every channel of `reader`'s file runs through
+// stt_transcribe_wav() on its own reader and pooled state, up to
+// pool.size() at once. The segments are tagged with their channel and
+// merged in start-time order, as is the text. Same result and abort
+// contract as stt_transcribe_wav(). `reader` itself is not read.
+bool stt_transcribe_wav_channels(struct whisper_context *ctx,
+                                 WhisperStatePool &pool,
+                                 const struct whisper_full_params &params,
+                                 const WavReader &reader,
+                                 bool use_vad,
+                                 SttResult &result,
+                                 const SttAbort *abort = nullptr);
+
+#endif // STT_FILE_H
@@ -0,0 +1,101 @@
+/**
+ * stt_handles.h - Handles for sessions and listeners owned by the app
+ *
+ * Sessions and listeners are driven from app threads: audio is pushed from
+ * a capture thread while the UI may close the object at any moment. A raw
+ * pointer as the handle lets that close free the object under a push that
+ * is still running. Here a handle is an id that every call looks up; the
+ * call holds a reference for its duration, so a close only drops the
+ * table's reference and the object goes away with the last call using it.
+ * A closed (or never valid) handle simply misses. Ids are never reused.
+ *
+ * SttCallGate serialises the calls on one object and lets close wait for
+ * the call in flight, so no callback fires once close has returned.
+ */
+
+#ifndef STT_HANDLES_H
+#define STT_HANDLES_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+template <typename T>
+class SttHandleTable {
+public:
+    int64_t add(std::shared_ptr<T> item) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int64_t handle = next_++;
+        items_.emplace(handle, std::move(item));
+        return handle;
+    }
+
+    // Null if the handle is closed or unknown.
+    std::shared_ptr<T> get(int64_t handle) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = items_.find(handle);
+        return it != items_.end() ? it->second : nullptr;
+    }
+
+    // Unregisters the handle; the object lives on while calls still hold it.
+    std::shared_ptr<T> remove(int64_t handle) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = items_.find(handle);
+        if (it == items_.end()) return nullptr;
+        std::shared_ptr<T> item = std::move(it->second);
+        items_.erase(it);
+        return item;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<int64_t, std::shared_ptr<T>> items_;
+    int64_t next_ = 1;
+};
+
+class SttCallGate {
+public:
+    // Held for the duration of one call; false once the gate is closed.
+    class Call {
+    public:
+        explicit Call(SttCallGate &gate) : gate_(gate), lock_(gate.mutex_) {
+            entered_ = !gate_.closed_;
+            if (entered_) gate_.owner_ = std::this_thread::get_id();
+        }
+        ~Call() {
+            if (entered_) gate_.owner_ = std::thread::id();
+        }
+        explicit operator bool() const { return entered_; }
+
+        Call(const Call &) = delete;
+        Call &operator=(const Call &) = delete;
+
+    private:
+        SttCallGate &gate_;
+        std::lock_guard<std::mutex> lock_;
+        bool entered_ = false;
+    };
+
+    // Refuses later calls. Waits for the call in flight, unless it is made
+    // from that call's own callback; callbacks should then check closed().
+    void close() {
+        if (owner_.load() == std::this_thread::get_id()) {
+            closed_ = true;
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+    }
+
+    bool closed() const { return closed_; }
+
+private:
+    std::mutex mutex_;
+    std::atomic<std::thread::id> owner_{};
+    std::atomic<bool> closed_{false};
+};
+
+#endif // STT_HANDLES_H
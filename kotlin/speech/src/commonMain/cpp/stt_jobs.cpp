@@ -0,0 +1,122 @@
+/**
+ * stt_jobs.cpp - Prioritised queue of asynchronous STT jobs
+ */
+
+#include "stt_jobs.h"
+#include "stt_common.h"
+
+#include <algorithm>
+
+SttJobQueue::SttJobQueue(int n_workers) : state_(std::make_shared<State>(std::max(1, n_workers))) {}
+
+SttJobQueue::~SttJobQueue() {
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        state_->stopping = true;
+        for (auto &entry : state_->live) *entry.second = true;
+    }
+    state_->cv.notify_all();
+    for (std::thread &worker : workers_) {
+        if (worker.get_id() == std::this_thread::get_id()) {
+            // Destroyed from a job's callback: joining would deadlock. The
+            // worker holds its own reference to the state and sees stopping
+            // on return.
+            worker.detach();
+        } else {
+            worker.join();
+        }
+    }
+}
+
+int64_t SttJobQueue::submit(SttJobPriority priority, Work work, Dropped dropped) {
+    int64_t id;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        id = state_->next_id++;
+        auto flag = std::make_shared<std::atomic<bool>>(state_->stopping);
+        state_->live[id] = flag;
+        state_->queues[priority].push_back({id, priority, std::move(work), std::move(dropped), flag});
+        if (workers_.empty()) {
+            for (int i = 0; i < state_->n_workers; i++) workers_.emplace_back(&SttJobQueue::run_worker, state_);
+        }
+    }
+    state_->cv.notify_all();
+    return id;
+}
+
+bool SttJobQueue::cancel(int64_t id) {
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        auto it = state_->live.find(id);
+        if (it == state_->live.end()) return false;
+        *it->second = true;
+    }
+    state_->cv.notify_all();  // a cancelled job can be reported even with no free slot
+    return true;
+}
+
+void SttJobQueue::cancel_all() {
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        for (auto &entry : state_->live) *entry.second = true;
+    }
+    state_->cv.notify_all();
+}
+
+bool SttJobQueue::pop_locked(State &state, Job &job) {
+    // Cancelled jobs only report, so they go first and need no slot
+    for (std::deque<Job> &queue : state.queues) {
+        auto it = std::find_if(queue.begin(), queue.end(), [](const Job &j) { return j.cancel->load(); });
+        if (it != queue.end()) {
+            job = std::move(*it);
+            queue.erase(it);
+            return true;
+        }
+    }
+
+    // Background work leaves one worker free for everything else
+    const int max_background = state.n_workers > 1 ? state.n_workers - 1 : 1;
+    for (int p = STT_PRIORITY_INTERACTIVE; p <= STT_PRIORITY_BACKGROUND; p++) {
+        if (state.queues[p].empty()) continue;
+        if (p == STT_PRIORITY_BACKGROUND && state.running_background >= max_background) return false;
+        job = std::move(state.queues[p].front());
+        state.queues[p].pop_front();
+        return true;
+    }
+    return false;
+}
+
+void SttJobQueue::run_worker(std::shared_ptr<State> state) {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    for (;;) {
+        Job job;
+        bool popped = false;
+        state->cv.wait(lock, [&state, &job, &popped] {
+            popped = pop_locked(*state, job);
+            return popped || (state->stopping && std::all_of(std::begin(state->queues), std::end(state->queues),
+                                                             [](const std::deque<Job> &q) { return q.empty(); }));
+        });
+        if (!popped) return;  // stopping, nothing left to report
+
+        const int64_t id = job.id;
+        const bool background = job.priority == STT_PRIORITY_BACKGROUND && !job.cancel->load();
+        if (background) state->running_background++;
+        lock.unlock();
+
+        if (job.cancel->load()) {
+            LOGI("[JOBS] job %lld cancelled before start", (long long)id);
+            if (job.dropped) job.dropped(id);
+        } else {
+            long t_start = now_ms();
+            job.work(id, *job.cancel);
+            LOGI("[JOBS] job %lld done in %ld ms (priority %d)", (long long)id, now_ms() - t_start,
+                 (int)job.priority);
+        }
+        job = Job();  // drop captured state before the slot is reported free
+
+        lock.lock();
+        if (background) state->running_background--;
+        state->live.erase(id);
+        state->cv.notify_all();
+    }
+}
@@ -0,0 +1,92 @@
+/**
+ * stt_jobs.h - Prioritised queue of asynchronous STT jobs
+ *
+ * The blocking entry points tie up the calling thread for the whole decode,
+ * so apps ended up keeping thread pools just to wait on them. Jobs submitted
+ * here run on a few native workers instead and report through a callback.
+ * Queued jobs start in priority order (FIFO within a class): a voice command
+ * submitted behind an hour of background files is the next to run. With
+ * more than one worker, background jobs also never occupy the last one, so
+ * an interactive job does not wait for a long file to finish.
+ *
+ * Every job has its own cancel flag, so cancelling one leaves the others
+ * alone. A job cancelled before it starts never runs; its `dropped` handler
+ * reports it instead. Both handlers always run on a worker thread.
+ */
+
+#ifndef STT_JOBS_H
+#define STT_JOBS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+enum SttJobPriority {
+    STT_PRIORITY_INTERACTIVE = 0,
+    STT_PRIORITY_NORMAL = 1,
+    STT_PRIORITY_BACKGROUND = 2,
+};
+
+class SttJobQueue {
+public:
+    // Runs the job. `cancel` is set once the job is cancelled.
+    using Work = std::function<void(int64_t id, const std::atomic<bool> &cancel)>;
+    // Runs instead of Work for a job cancelled before it started.
+    using Dropped = std::function<void(int64_t id)>;
+
+    // Workers are started on the first submit().
+    explicit SttJobQueue(int n_workers);
+    // Cancels every job and joins the workers; the queued jobs are reported.
+    // May run on a worker (a job's callback re-initializing STT): that
+    // worker is detached instead and exits once the queue is drained.
+    ~SttJobQueue();
+
+    SttJobQueue(const SttJobQueue &) = delete;
+    SttJobQueue &operator=(const SttJobQueue &) = delete;
+
+    // Returns the job id (> 0).
+    int64_t submit(SttJobPriority priority, Work work, Dropped dropped);
+
+    // Sets the job's cancel flag. false if it already finished or never existed.
+    bool cancel(int64_t id);
+    void cancel_all();
+
+private:
+    struct Job {
+        int64_t id;
+        SttJobPriority priority;
+        Work work;
+        Dropped dropped;
+        std::shared_ptr<std::atomic<bool>> cancel;
+    };
+
+    // Everything a worker touches, shared with the workers so that one
+    // detached by the destructor keeps it alive.
+    struct State {
+        explicit State(int n_workers) : n_workers(n_workers) {}
+
+        const int n_workers;
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<Job> queues[3];  // by SttJobPriority
+        std::unordered_map<int64_t, std::shared_ptr<std::atomic<bool>>> live;  // queued or running
+        int running_background = 0;
+        int64_t next_id = 1;
+        bool stopping = false;
+    };
+
+    static bool pop_locked(State &state, Job &job);
+    static void run_worker(std::shared_ptr<State> state);
+
+    std::shared_ptr<State> state_;
+    std::vector<std::thread> workers_;  // guarded by state_->mutex
+};
+
+#endif // STT_JOBS_H
@@ -0,0 +1,97 @@
+/**
+ * stt_lang.cpp - Fast spoken-language identification
+ */
+
+#include "stt_lang.h"
+#include "stt_buckets.h"
+#include "vad.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+static constexpr size_t LID_WINDOW_SAMPLES = (size_t)STT_LID_WINDOW_MS * (WHISPER_SAMPLE_RATE / 1000);
+
+// How much of a file is searched for the opening speech.
+static constexpr size_t FILE_SCAN_SAMPLES = 30 * WHISPER_SAMPLE_RATE;
+
+bool stt_language_is_auto(const char *language) {
+    return language == nullptr || language[0] == '\0' || std::strcmp(language, "auto") == 0;
+}
+
+bool stt_detect_language(struct whisper_context *ctx,
+                         struct whisper_state *state,
+                         const float *audio, size_t n_samples,
+                         bool use_vad, int n_threads, int top_n,
+                         const SttAbort *abort,
+                         std::vector<SttLanguageProb> &languages) {
+    languages.clear();
+    if (!whisper_is_multilingual(ctx)) {
+        languages.push_back({"en", 1.0f});
+        return true;
+    }
+
+    VadPacked packed;
+    if (use_vad) {
+        vad_pack(audio, n_samples, vad_detect(audio, n_samples), packed);
+        audio = packed.samples();
+        n_samples = packed.n_samples();
+    }
+    if (n_samples == 0) return true;
+    n_samples = std::min(n_samples, LID_WINDOW_SAMPLES);
+    if (abort != nullptr && abort->stop()) return false;
+
+    long t_start = now_ms();
+
+    // Prime: mel of the window and an encoder context sized to it
+    if (!stt_prime_state(ctx, state, audio, n_samples, n_threads)) {
+        LOGE("[LID] failed to prepare %zu samples", n_samples);
+        return false;
+    }
+
+    // The detection pass itself takes no abort hooks: check once more
+    if (abort != nullptr && abort->stop()) return false;
+
+    std::vector<float> probs((size_t)whisper_lang_max_id() + 1, 0.0f);
+    if (whisper_lang_auto_detect_with_state(ctx, state, 0, n_threads, probs.data()) < 0) {
+        LOGE("[LID] language detection failed");
+        return false;
+    }
+
+    std::vector<int> ids(probs.size());
+    std::iota(ids.begin(), ids.end(), 0);
+    size_t n_top = std::min(ids.size(), (size_t)std::max(1, top_n));
+    std::partial_sort(ids.begin(), ids.begin() + (long)n_top, ids.end(),
+                      [&probs](int a, int b) { return probs[a] > probs[b]; });
+    for (size_t i = 0; i < n_top; i++) {
+        languages.push_back({whisper_lang_str(ids[i]), probs[ids[i]]});
+    }
+
+    LOGI("[LID] %s (p=%.2f) from %.2fs, audio_ctx=%d: %ld ms",
+         languages[0].language.c_str(), languages[0].probability,
+         (float)n_samples / WHISPER_SAMPLE_RATE, stt_bucket_audio_ctx(ctx, n_samples), now_ms() - t_start);
+    return true;
+}
+
+std::string stt_detect_wav_language(struct whisper_context *ctx,
+                                    struct whisper_state *state,
+                                    WavReader &reader,
+                                    bool use_vad, int n_threads,
+                                    const SttAbort *abort) {
+    // Without VAD only the window itself is needed; with it, search further
+    // so leading silence does not leave nothing to identify.
+    std::vector<float> audio(use_vad ? FILE_SCAN_SAMPLES : LID_WINDOW_SAMPLES);
+    size_t filled = 0, n;
+    while (filled < audio.size() &&
+           (n = reader.read_16k(audio.data() + filled, audio.size() - filled)) > 0) {
+        filled += n;
+    }
+    reader.rewind();
+
+    std::vector<SttLanguageProb> languages;
+    if (!stt_detect_language(ctx, state, audio.data(), filled, use_vad, n_threads, 1, abort, languages) ||
+        languages.empty()) {
+        return "";
+    }
+    return languages[0].language;
+}
@@ -0,0 +1,59 @@
+/**
+ * stt_lang.h - Fast spoken-language identification
+ *
+ * Whisper identifies the language from the first decoder step after a full
+ * 30 s encoder pass. Here only the first few seconds of speech are encoded,
+ * with audio_ctx cut to match (rounded up to a bucket, see stt_buckets.h),
+ * which makes identification several times cheaper than a transcription and
+ * cheap enough to route audio with.
+ *
+ * whisper_lang_auto_detect_with_state() encodes at the state's current
+ * audio_ctx, which only whisper_full_with_state() can set. Detection
+ * therefore primes the state first (stt_prime_state, stt_buckets.h): the
+ * mel is computed and audio_ctx set, but nothing is encoded.
+ */
+
+#ifndef STT_LANG_H
+#define STT_LANG_H
+
+#include "stt_abort.h"
+#include "stt_common.h"
+#include "wav_reader.h"
+#include "whisper.h"
+
+#include <string>
+#include <vector>
+
+// Speech encoded for identification. Longer is more reliable, shorter is
+// cheaper; whisper is dependable from about three seconds of speech.
+static constexpr int STT_LID_WINDOW_MS = 3000;
+
+struct SttLanguageProb {
+    std::string language;  // ISO 639-1 code, e.g. "en"
+    float probability = 0.0f;
+};
+
+// True if `language` asks whisper to detect it ("auto", empty or null).
+bool stt_language_is_auto(const char *language);
+
+// Top `top_n` languages of the first STT_LID_WINDOW_MS of speech in `audio`,
+// most likely first. With `use_vad` silence is skipped first; no speech
+// yields an empty list. English-only models always report "en". Returns
+// false if whisper fails or `abort` (may be null) stops it before the
+// encoder pass.
+bool stt_detect_language(struct whisper_context *ctx,
+                         struct whisper_state *state,
+                         const float *audio, size_t n_samples,
+                         bool use_vad, int n_threads, int top_n,
+                         const SttAbort *abort,
+                         std::vector<SttLanguageProb> &languages);
+
+// Most likely language of a WAV file from its opening seconds of speech, or
+// "" if none was found. The reader is rewound afterwards.
+std::string stt_detect_wav_language(struct whisper_context *ctx,
+                                    struct whisper_state *state,
+                                    WavReader &reader,
+                                    bool use_vad, int n_threads,
+                                    const SttAbort *abort);
+
+#endif // STT_LANG_H
@@ -0,0 +1,223 @@
+/**
+ * stt_listener.cpp - Always-on listening front end
+ */
+
+#include "stt_listener.h"
+#include "stt_common.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+static constexpr int64_t SAMPLES_PER_MS = 16;
+
+// Noise floor rise per idle frame, as a fraction of the gap (~1 s to adapt)
+static constexpr float FLOOR_RISE = 0.03f;
+
+// Upper bound on a missed wake-up: push() notifies without taking the mutex
+static constexpr auto MAX_SLEEP = std::chrono::milliseconds(250);
+
+// ═══════════════════════════════════════════════════════════════
+//                          SPSC RING
+// ═══════════════════════════════════════════════════════════════
+
+static size_t next_pow2(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+SpscAudioRing::SpscAudioRing(size_t capacity) : buf_(next_pow2(std::max<size_t>(capacity, 2))), mask_(buf_.size() - 1) {}
+
+size_t SpscAudioRing::write(const float *src, size_t n) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    const size_t tail = tail_.load(std::memory_order_acquire);
+    n = std::min(n, buf_.size() - (head - tail));
+    if (n == 0) return 0;
+
+    const size_t pos = head & mask_;
+    const size_t first = std::min(n, buf_.size() - pos);
+    std::memcpy(buf_.data() + pos, src, first * sizeof(float));
+    std::memcpy(buf_.data(), src + first, (n - first) * sizeof(float));
+    head_.store(head + n, std::memory_order_release);
+    return n;
+}
+
+size_t SpscAudioRing::read(float *dst, size_t n) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t head = head_.load(std::memory_order_acquire);
+    n = std::min(n, head - tail);
+    if (n == 0) return 0;
+
+    const size_t pos = tail & mask_;
+    const size_t first = std::min(n, buf_.size() - pos);
+    std::memcpy(dst, buf_.data() + pos, first * sizeof(float));
+    std::memcpy(dst + first, buf_.data(), (n - first) * sizeof(float));
+    tail_.store(tail + n, std::memory_order_release);
+    return n;
+}
+
+size_t SpscAudioRing::size() const {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                          ENDPOINTER
+// ═══════════════════════════════════════════════════════════════
+
+SttEndpointer::SttEndpointer(const SttListenerConfig &config)
+    : config_(config),
+      frame_(std::max(1, config.vad.frame_samples)),
+      end_silence_frames_(std::max(1, (int)(config.end_silence_ms * SAMPLES_PER_MS / frame_))),
+      min_speech_frames_(std::max(1, (int)(config.min_speech_ms * SAMPLES_PER_MS / frame_))),
+      max_samples_((size_t)std::max(config.max_utterance_ms, 1000) * SAMPLES_PER_MS),
+      pre_roll_((size_t)std::max(config.pre_roll_ms, 0) * SAMPLES_PER_MS) {
+    partial_.reserve((size_t)frame_);
+}
+
+void SttEndpointer::process(const float *audio, size_t n, const SttListenerCallbacks &callbacks) {
+    // Top up a frame left over from the previous call
+    if (!partial_.empty()) {
+        size_t take = std::min(n, (size_t)frame_ - partial_.size());
+        partial_.insert(partial_.end(), audio, audio + take);
+        audio += take;
+        n -= take;
+        if (partial_.size() < (size_t)frame_) return;
+        process_frame(partial_.data(), callbacks);
+        partial_.clear();
+    }
+    for (; n >= (size_t)frame_; audio += frame_, n -= frame_) process_frame(audio, callbacks);
+    partial_.assign(audio, audio + n);
+}
+
+void SttEndpointer::process_frame(const float *frame, const SttListenerCallbacks &callbacks) {
+    float sum = 0.0f;
+    for (int i = 0; i < frame_; i++) sum += frame[i] * frame[i];
+    const float rms = std::sqrt(sum / frame_);
+    position_ += frame_;
+
+    if (noise_floor_ == 0.0f) noise_floor_ = rms;
+    const float start_threshold = std::max(config_.vad.min_threshold, noise_floor_ * config_.vad.start_ratio);
+    const float stop_threshold = start_threshold * config_.vad.stop_ratio / config_.vad.start_ratio;
+
+    if (!in_speech_) {
+        if (rms < start_threshold) {
+            // Idle: track the floor and keep the pre-roll history
+            noise_floor_ = rms < noise_floor_ ? rms : noise_floor_ + (rms - noise_floor_) * FLOOR_RISE;
+            for (int i = 0; i < frame_ && !pre_roll_.empty(); i++) {
+                pre_roll_[pre_roll_pos_] = frame[i];
+                pre_roll_pos_ = (pre_roll_pos_ + 1) % pre_roll_.size();
+            }
+            pre_roll_size_ = std::min(pre_roll_size_ + (size_t)frame_, pre_roll_.size());
+            return;
+        }
+
+        // Speech onset: the utterance starts with the pre-roll
+        in_speech_ = true;
+        started_ = false;
+        voiced_frames_ = 0;
+        silent_frames_ = 0;
+        utterance_.clear();
+        for (size_t i = 0; i < pre_roll_size_; i++) {
+            utterance_.push_back(pre_roll_[(pre_roll_pos_ + pre_roll_.size() - pre_roll_size_ + i) % pre_roll_.size()]);
+        }
+        utterance_start_ = position_ - frame_ - (int64_t)pre_roll_size_;
+        pre_roll_size_ = 0;
+    }
+
+    utterance_.insert(utterance_.end(), frame, frame + frame_);
+    if (rms >= stop_threshold) {
+        voiced_frames_++;
+        silent_frames_ = 0;
+    } else {
+        silent_frames_++;
+    }
+
+    if (!started_ && voiced_frames_ >= min_speech_frames_) {
+        started_ = true;
+        if (callbacks.on_speech_start) callbacks.on_speech_start(utterance_start_ / SAMPLES_PER_MS);
+    }
+
+    if (silent_frames_ >= end_silence_frames_) {
+        end_utterance((size_t)silent_frames_, callbacks);
+    } else if (utterance_.size() >= max_samples_) {
+        // Still talking: deliver what there is and carry on without a gap
+        LOGD("[LISTEN] utterance reached %d ms, cutting", config_.max_utterance_ms);
+        const bool speech = started_;
+        end_utterance(0, callbacks);
+        in_speech_ = speech;
+        utterance_start_ = position_;
+    }
+}
+
+void SttEndpointer::end_utterance(size_t trailing_frames, const SttListenerCallbacks &callbacks) {
+    std::vector<float> audio;
+    audio.swap(utterance_);
+    const bool speech = started_ && voiced_frames_ > 0;  // not a click, nor silence after a cut
+    in_speech_ = false;
+    voiced_frames_ = 0;
+    silent_frames_ = 0;
+    if (!speech) return;
+
+    // Keep as much trailing silence as pre-roll, for the last word's tail
+    const size_t keep = pre_roll_.size();
+    const size_t trailing = trailing_frames * (size_t)frame_;
+    if (trailing > keep) audio.resize(audio.size() - (trailing - keep));
+
+    if (callbacks.on_utterance) callbacks.on_utterance(std::move(audio), utterance_start_ / SAMPLES_PER_MS);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                           LISTENER
+// ═══════════════════════════════════════════════════════════════
+
+SttListener::SttListener(const SttListenerConfig &config, SttListenerCallbacks callbacks)
+    : config_(config),
+      callbacks_(std::move(callbacks)),
+      ring_((size_t)std::max(config.buffer_ms, 1000) * SAMPLES_PER_MS),
+      wake_samples_((size_t)std::max(config.wake_ms, 10) * SAMPLES_PER_MS),
+      thread_(&SttListener::run, this) {}
+
+SttListener::~SttListener() {
+    stop();
+}
+
+size_t SttListener::push(const float *audio, size_t n) {
+    size_t written = ring_.write(audio, n);
+    if (written < n) dropped_ += (int64_t)(n - written);
+    if (sleeping_.load(std::memory_order_acquire) && ring_.size() >= wake_samples_) cv_.notify_one();
+    return written;
+}
+
+void SttListener::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_one();
+    if (thread_.joinable()) thread_.join();
+}
+
+void SttListener::run() {
+    SttEndpointer endpointer(config_);
+    std::vector<float> chunk(wake_samples_);
+    LOGI("[LISTEN] listening (pre-roll %d ms, end silence %d ms)", config_.pre_roll_ms, config_.end_silence_ms);
+
+    while (!stopping_) {
+        size_t n = ring_.read(chunk.data(), chunk.size());
+        if (n > 0) {
+            endpointer.process(chunk.data(), n, callbacks_);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        sleeping_ = true;
+        cv_.wait_for(lock, MAX_SLEEP, [this] { return stopping_ || ring_.size() >= wake_samples_; });
+        sleeping_ = false;
+    }
+
+    if (dropped_ > 0) {
+        LOGI("[LISTEN] %lld sample(s) dropped on a full buffer", (long long)dropped_.load());
+    }
+}
@@ -0,0 +1,143 @@
+/**
+ * stt_listener.h - Always-on listening front end
+ *
+ * Keeping the microphone open and decoding everything it hears burns CPU on
+ * silence. The listener keeps whisper asleep instead: the mic thread pushes
+ * audio into a lock-free single-producer / single-consumer ring (no locks,
+ * no allocation on the audio thread), and one listener thread runs a cheap
+ * streaming endpointer over it (per-frame RMS against a tracked noise floor,
+ * with the hysteresis of vad.h). Only a completed utterance, with a short
+ * pre-roll so the first phoneme is not clipped, is handed on for decoding.
+ *
+ * The listener thread sleeps on a condition variable and is woken only once
+ * `wake_ms` of audio is buffered, so while idle it costs one RMS pass per
+ * frame, a few wake-ups per second.
+ *
+ * Platform-neutral: the JNI and iOS wrappers decode the utterances and
+ * translate callbacks for their runtime.
+ */
+
+#ifndef STT_LISTENER_H
+#define STT_LISTENER_H
+
+#include "vad.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct SttListenerConfig {
+    int pre_roll_ms      = 300;    // audio kept from before speech started
+    int end_silence_ms   = 700;    // quiet time that ends an utterance
+    int min_speech_ms    = 150;    // shorter bursts (clicks, bumps) are dropped
+    int max_utterance_ms = 30000;  // longer speech is cut and delivered in pieces
+    int buffer_ms        = 20000;  // ring capacity: audio that can queue up while a decode runs
+    int wake_ms          = 100;    // buffered audio that wakes the listener thread
+    VadConfig vad;                 // frame size, thresholds and ratios; the rest is unused
+};
+
+// Invoked on the listener thread. Times are in ms of audio since the
+// listener started.
+struct SttListenerCallbacks {
+    std::function<void(int64_t start_ms)> on_speech_start;
+    std::function<void(std::vector<float> &&audio, int64_t start_ms)> on_utterance;
+};
+
+// Lock-free FIFO of float samples for exactly one writer thread and one
+// reader thread. When full, write() drops what does not fit.
+class SpscAudioRing {
+public:
+    explicit SpscAudioRing(size_t capacity);  // rounded up to a power of two
+
+    // Producer side. Returns how many of the `n` samples fit.
+    size_t write(const float *src, size_t n);
+    // Consumer side. Moves up to `n` samples into `dst`; returns how many.
+    size_t read(float *dst, size_t n);
+    // Samples waiting; exact on the consumer side, a lower bound elsewhere.
+    size_t size() const;
+
+private:
+    std::vector<float> buf_;
+    size_t mask_;
+    std::atomic<size_t> head_{0};  // total written
+    std::atomic<size_t> tail_{0};  // total read
+};
+
+// Streaming endpointer: turns a continuous signal into utterances. The
+// noise floor is tracked only outside speech (falls at once, rises slowly),
+// so a long utterance does not raise its own threshold. Not thread-safe.
+class SttEndpointer {
+public:
+    explicit SttEndpointer(const SttListenerConfig &config);
+
+    void process(const float *audio, size_t n, const SttListenerCallbacks &callbacks);
+
+    bool in_speech() const { return in_speech_; }
+    float noise_floor() const { return noise_floor_; }
+
+private:
+    void process_frame(const float *frame, const SttListenerCallbacks &callbacks);
+    void end_utterance(size_t trailing_frames, const SttListenerCallbacks &callbacks);
+
+    SttListenerConfig config_;
+    int frame_;
+    int end_silence_frames_;
+    int min_speech_frames_;
+    size_t max_samples_;
+
+    std::vector<float> partial_;      // samples short of a whole frame
+    std::vector<float> pre_roll_;     // circular history while idle
+    size_t pre_roll_pos_ = 0;
+    size_t pre_roll_size_ = 0;
+
+    std::vector<float> utterance_;
+    int64_t utterance_start_ = 0;     // samples
+    int64_t position_ = 0;            // samples processed
+    bool in_speech_ = false;
+    bool started_ = false;            // on_speech_start delivered
+    int voiced_frames_ = 0;
+    int silent_frames_ = 0;
+    float noise_floor_ = 0.0f;
+};
+
+class SttListener {
+public:
+    // Starts the listener thread.
+    SttListener(const SttListenerConfig &config, SttListenerCallbacks callbacks);
+    ~SttListener();  // stop()
+
+    SttListener(const SttListener &) = delete;
+    SttListener &operator=(const SttListener &) = delete;
+
+    // Called from the audio thread only; never blocks. Returns how many
+    // samples were queued (the rest were dropped: the ring is full).
+    size_t push(const float *audio, size_t n);
+
+    // Joins the listener thread; audio still queued and an utterance in
+    // progress are discarded. Must not be called from a callback.
+    void stop();
+
+    int64_t dropped_samples() const { return dropped_.load(); }
+
+private:
+    void run();
+
+    SttListenerConfig config_;
+    SttListenerCallbacks callbacks_;
+    SpscAudioRing ring_;
+    size_t wake_samples_;
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::atomic<bool> sleeping_{false};
+    std::atomic<bool> stopping_{false};
+    std::atomic<int64_t> dropped_{0};
+    std::thread thread_;
+};
+
+#endif // STT_LISTENER_H
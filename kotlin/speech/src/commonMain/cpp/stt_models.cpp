@@ -0,0 +1,171 @@
+/**
+ * stt_models.cpp - Resident whisper models with a memory budget
+ */
+
+#include "stt_models.h"
+#include "stt_common.h"
+
+#include <algorithm>
+#include <fstream>
+
+static size_t file_size(const std::string &path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    return file ? (size_t)file.tellg() : 0;
+}
+
+SttModel::~SttModel() {
+    pool.reset();
+    if (ctx != nullptr) whisper_free(ctx);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                           REGISTRY
+// ═══════════════════════════════════════════════════════════════
+
+SttModelRegistry::SttModelRegistry(size_t budget_bytes, const SttModelLoadConfig &config)
+    : budget_bytes_(budget_bytes), config_(config) {
+    // The caller's language string may not outlive a background load, and
+    // the warm-up decode does not need it
+    config_.warm_up_params.language = "en";
+}
+
+SttModelRegistry::~SttModelRegistry() {
+    {
+        std::lock_guard<std::mutex> lock(queue_->mutex);
+        queue_->stopping = true;
+        queue_->jobs.clear();
+    }
+    queue_->cv.notify_all();
+    if (!loader_.joinable()) return;
+    if (loader_.get_id() == std::this_thread::get_id()) {
+        // Destroyed from a load callback: joining would deadlock. The loader
+        // holds its own reference to the queue and sees stopping on return.
+        loader_.detach();
+    } else {
+        loader_.join();
+    }
+}
+
+SttModelRef SttModelRegistry::find_locked(const std::string &path) {
+    auto it = std::find_if(lru_.begin(), lru_.end(),
+                           [&path](const SttModelRef &m) { return m->path == path; });
+    if (it == lru_.end()) return nullptr;
+    lru_.splice(lru_.begin(), lru_, it);
+    return *it;
+}
+
+SttModelRef SttModelRegistry::load(const std::string &path) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (SttModelRef model = find_locked(path)) return model;
+    }
+
+    // Serialised so two requests for the same new model load it once
+    std::lock_guard<std::mutex> load_lock(load_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (SttModelRef model = find_locked(path)) return model;
+    }
+
+    long t_load = now_ms();
+    auto model = std::make_shared<SttModel>();
+    model->path = path;
+    model->bytes = file_size(path);
+    model->ctx = whisper_init_from_file_with_params_no_state(path.c_str(), config_.ctx_params);
+    if (model->ctx == nullptr) {
+        LOGE("[MODELS] failed to load %s", path.c_str());
+        return nullptr;
+    }
+    model->pool = std::make_unique<WhisperStatePool>(model->ctx, config_.pool_size);
+    if (config_.warm_up) {
+        model->pool->warm_up(config_.warm_up_params);
+    } else if (config_.preallocate) {
+        model->pool->preallocate();
+    }
+    LOGI("[MODELS] loaded %s (%zu MB) in %ld ms", path.c_str(), model->bytes >> 20, now_ms() - t_load);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    lru_.push_front(model);
+    evict_locked();
+    return model;
+}
+
+void SttModelRegistry::evict_locked() {
+    if (lru_.size() < 2) return;
+    size_t total = 0;
+    for (const SttModelRef &m : lru_) total += m->bytes;
+
+    // Least recently used first; the active and the newest model stay
+    for (auto it = std::prev(lru_.end()); total > budget_bytes_ && it != lru_.begin();) {
+        auto victim = it--;
+        if (*victim == active_) continue;
+        total -= (*victim)->bytes;
+        LOGI("[MODELS] evicting %s", (*victim)->path.c_str());
+        lru_.erase(victim);
+    }
+}
+
+void SttModelRegistry::load_async(const std::string &path, bool activate, LoadCallback done) {
+    {
+        std::lock_guard<std::mutex> lock(queue_->mutex);
+        if (queue_->stopping) return;
+        queue_->jobs.push_back({path, activate, std::move(done)});
+        if (!loader_.joinable()) loader_ = std::thread(&SttModelRegistry::run_loader, this, queue_);
+    }
+    queue_->cv.notify_one();
+}
+
+// `this` is only used between taking a job and calling its callback: once
+// the callback returns, the registry may be gone (see ~SttModelRegistry).
+void SttModelRegistry::run_loader(std::shared_ptr<LoaderQueue> queue) {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(queue->mutex);
+            queue->cv.wait(lock, [&queue] { return queue->stopping || !queue->jobs.empty(); });
+            if (queue->stopping) return;
+            job = std::move(queue->jobs.front());
+            queue->jobs.pop_front();
+        }
+
+        SttModelRef model = load(job.path);
+        if (model && job.activate) set_active(model);
+        if (job.done) job.done(job.path, model != nullptr);
+    }
+}
+
+SttModelRef SttModelRegistry::get(const std::string &path) {
+    if (path.empty()) return active();
+    return load(path);
+}
+
+SttModelRef SttModelRegistry::active() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return active_;
+}
+
+void SttModelRegistry::set_active(const SttModelRef &model) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (active_ != model) {
+        LOGI("[MODELS] active model: %s", model->path.c_str());
+    }
+    active_ = model;
+    if (find_locked(model->path) == nullptr) lru_.push_front(model);  // evicted while loading
+    evict_locked();  // the previous active model may now be over budget
+}
+
+bool SttModelRegistry::unload(const std::string &path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = std::find_if(lru_.begin(), lru_.end(),
+                           [&path](const SttModelRef &m) { return m->path == path; });
+    if (it == lru_.end() || *it == active_) return false;
+    lru_.erase(it);
+    return true;
+}
+
+std::vector<std::string> SttModelRegistry::resident() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::string> paths;
+    for (const SttModelRef &m : lru_) paths.push_back(m->path);
+    return paths;
+}
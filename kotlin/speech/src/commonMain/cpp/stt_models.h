@@ -0,0 +1,128 @@
+/**
+ * stt_models.h - Resident whisper models with a memory budget
+ *
+ * Apps that switch between model sizes (tiny / base / small) depending on
+ * device load should not have to tear the current model down, and stall
+ * every transcription, while the next one is read from disk. The registry
+ * keeps several loaded contexts (each with its own state pool) resident up
+ * to a byte budget, evicting the least recently used. New models are
+ * loaded on a background thread and become the active model with one
+ * pointer swap once they are ready.
+ *
+ * Models are handed out as shared pointers. A request holds its model for
+ * its whole duration, so evicting or replacing a model never frees it
+ * under a running transcription; it goes away when its last user finishes.
+ */
+
+#ifndef STT_MODELS_H
+#define STT_MODELS_H
+
+#include "whisper_state_pool.h"
+#include "whisper.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct SttModel {
+    std::string path;
+    struct whisper_context *ctx = nullptr;
+    std::unique_ptr<WhisperStatePool> pool;
+    size_t bytes = 0;  // model file size, counted against the budget
+
+    SttModel() = default;
+    ~SttModel();  // pool first: states must go before their context
+
+    SttModel(const SttModel &) = delete;
+    SttModel &operator=(const SttModel &) = delete;
+};
+
+using SttModelRef = std::shared_ptr<SttModel>;
+
+// How every model in a registry is loaded and prepared.
+struct SttModelLoadConfig {
+    struct whisper_context_params ctx_params = whisper_context_default_params();
+    int pool_size = 1;
+    bool preallocate = false;  // allocate every pooled state up front
+    bool warm_up = false;      // and run a dummy decode on each
+    struct whisper_full_params warm_up_params = whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
+};
+
+class SttModelRegistry {
+public:
+    // Called on the loader thread once a background load finishes. It may
+    // destroy the registry (e.g. re-initialize from "model ready"): the
+    // loader then detaches and exits without touching it again.
+    using LoadCallback = std::function<void(const std::string &path, bool ok)>;
+
+    // `budget_bytes` bounds the resident models (by file size); 0 keeps
+    // only the active model and models still in use.
+    SttModelRegistry(size_t budget_bytes, const SttModelLoadConfig &config);
+    ~SttModelRegistry();  // waits for the current background load, drops queued ones
+                          // (on the loader thread itself: drops them and detaches)
+
+    SttModelRegistry(const SttModelRegistry &) = delete;
+    SttModelRegistry &operator=(const SttModelRegistry &) = delete;
+
+    // Returns the resident model for `path`, loading it on the calling
+    // thread if needed. Other requests keep running meanwhile. nullptr if
+    // the model cannot be loaded.
+    SttModelRef load(const std::string &path);
+
+    // Queues a load on the background thread. With `activate`, the model
+    // replaces the active one once ready.
+    void load_async(const std::string &path, bool activate, LoadCallback done);
+
+    // Model for a request: the active one for an empty path, otherwise
+    // `path` (loaded on demand).
+    SttModelRef get(const std::string &path);
+    SttModelRef active() const;
+    void set_active(const SttModelRef &model);
+
+    // Drops `path` from the registry; it is freed once no request uses it.
+    // The active model cannot be unloaded.
+    bool unload(const std::string &path);
+
+    // Paths of resident models, most recently used first.
+    std::vector<std::string> resident() const;
+
+private:
+    struct Job {
+        std::string path;
+        bool activate;
+        LoadCallback done;
+    };
+
+    // Job queue, shared with the loader thread so it outlives a registry
+    // destroyed from a load callback.
+    struct LoaderQueue {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<Job> jobs;
+        bool stopping = false;
+    };
+
+    SttModelRef find_locked(const std::string &path);
+    void evict_locked();
+    void run_loader(std::shared_ptr<LoaderQueue> queue);
+
+    const size_t budget_bytes_;
+    SttModelLoadConfig config_;
+
+    mutable std::mutex mutex_;
+    std::list<SttModelRef> lru_;  // most recently used first
+    SttModelRef active_;
+
+    std::mutex load_mutex_;  // one load at a time: no duplicate loads of a path
+
+    std::shared_ptr<LoaderQueue> queue_ = std::make_shared<LoaderQueue>();
+    std::thread loader_;
+};
+
+#endif // STT_MODELS_H
@@ -0,0 +1,29 @@
+/**
+ * stt_options.cpp - Per-request overrides of the init-time decode parameters
+ */
+
+#include "stt_options.h"
+
+struct whisper_full_params SttOptions::apply(const struct whisper_full_params &base) const {
+    struct whisper_full_params params = base;
+    if (!language.empty()) params.language = language.c_str();
+    if (translate >= 0) params.translate = translate != 0;
+    if (single_segment >= 0) params.single_segment = single_segment != 0;
+    if (no_context >= 0) params.no_context = no_context != 0;
+    return params;
+}
+
+static int packed_flag(int flags, int set_bit, int value_bit) {
+    if ((flags & set_bit) == 0) return -1;
+    return (flags & value_bit) != 0 ? 1 : 0;
+}
+
+SttOptions SttOptions::from_packed(const char *language, int flags) {
+    SttOptions options;
+    if (language != nullptr) options.language = language;
+    options.translate = packed_flag(flags, STT_OPT_TRANSLATE_SET, STT_OPT_TRANSLATE);
+    options.single_segment = packed_flag(flags, STT_OPT_SINGLE_SEGMENT_SET, STT_OPT_SINGLE_SEGMENT);
+    options.no_context = packed_flag(flags, STT_OPT_NO_CONTEXT_SET, STT_OPT_NO_CONTEXT);
+    options.split_channels = packed_flag(flags, STT_OPT_SPLIT_CHANNELS_SET, STT_OPT_SPLIT_CHANNELS);
+    return options;
+}
@@ -0,0 +1,47 @@
+/**
+ * stt_options.h - Per-request overrides of the init-time decode parameters
+ *
+ * language, translate, single_segment and no_context only change the
+ * whisper_full_params a decode runs with, not the loaded model. Each
+ * request can therefore patch a copy of the init parameters instead of
+ * re-initialising (and re-reading the model from disk). The model itself
+ * can be chosen per request too, among the resident ones. split_channels
+ * is not a decode parameter: it picks how WAV files are read (stt_file.h).
+ */
+
+#ifndef STT_OPTIONS_H
+#define STT_OPTIONS_H
+
+#include "whisper.h"
+
+#include <cstdint>
+#include <string>
+
+struct SttOptions {
+    std::string model;        // model path, see SttModelRegistry::get(); empty: active model
+    std::string language;     // empty: keep
+    int translate = -1;       // -1: keep, otherwise 0 / 1
+    int single_segment = -1;
+    int no_context = -1;
+    int64_t timeout_ms = 0;   // decode deadline (see SttAbort); <= 0: none
+    int split_channels = -1;  // 1: one transcription per WAV channel; -1 / 0: downmix
+
+    // Copy of `base` with the overrides applied. The copy's language points
+    // into this object, which must outlive it.
+    struct whisper_full_params apply(const struct whisper_full_params &base) const;
+
+    // From the bindings' packed form: a "set" bit and a value bit per flag,
+    // see STT_OPT_* below.
+    static SttOptions from_packed(const char *language, int flags);
+};
+
+static constexpr int STT_OPT_TRANSLATE_SET       = 1 << 0;
+static constexpr int STT_OPT_TRANSLATE           = 1 << 1;
+static constexpr int STT_OPT_SINGLE_SEGMENT_SET  = 1 << 2;
+static constexpr int STT_OPT_SINGLE_SEGMENT      = 1 << 3;
+static constexpr int STT_OPT_NO_CONTEXT_SET      = 1 << 4;
+static constexpr int STT_OPT_NO_CONTEXT          = 1 << 5;
+static constexpr int STT_OPT_SPLIT_CHANNELS_SET  = 1 << 6;
+static constexpr int STT_OPT_SPLIT_CHANNELS      = 1 << 7;
+
+#endif // STT_OPTIONS_H
@@ -0,0 +1,70 @@
+/**
+ * stt_repeat.cpp - Early stop for whisper repetition loops
+ */
+
+#include "stt_repeat.h"
+#include "stt_common.h"
+
+#include <cmath>
+
+// Trailing text tokens that decide a loop: a longer run does not change
+// the outcome of stt_is_repetition_loop.
+static constexpr size_t LOOP_TAIL = STT_LOOP_MAX_PERIOD * STT_LOOP_MIN_REPEATS;
+static_assert(STT_LOOP_MIN_TOKENS <= LOOP_TAIL, "loop tail too short");
+
+bool stt_is_repetition_loop(const whisper_token *tokens, size_t n_tokens) {
+    for (size_t period = 1; period <= STT_LOOP_MAX_PERIOD && period * STT_LOOP_MIN_REPEATS <= n_tokens; period++) {
+        // Trailing tokens that equal the token one period earlier
+        size_t run = 0;
+        while (run + period < n_tokens &&
+               tokens[n_tokens - 1 - run] == tokens[n_tokens - 1 - run - period]) {
+            run++;
+        }
+        size_t covered = run + period;
+        if (covered / period >= STT_LOOP_MIN_REPEATS && covered >= STT_LOOP_MIN_TOKENS) return true;
+    }
+    return false;
+}
+
+void SttRepeatGuard::install(struct whisper_full_params &params) {
+    params.logits_filter_callback = filter;
+    params.logits_filter_callback_user_data = this;
+}
+
+SttLoopStats SttRepeatGuard::stats() const {
+    SttLoopStats stats;
+    stats.decodes = decodes_.load();
+    stats.loops = loops_.load();
+    return stats;
+}
+
+void SttRepeatGuard::reset_stats() {
+    decodes_ = 0;
+    loops_ = 0;
+}
+
+void SttRepeatGuard::filter(struct whisper_context *ctx, struct whisper_state *,
+                            const whisper_token_data *tokens, int n_tokens, float *logits, void *self) {
+    auto *guard = static_cast<SttRepeatGuard *>(self);
+    if (n_tokens == 0) {
+        guard->decodes_++;  // first step of a decoder pass
+        return;
+    }
+
+    // Text tokens only: the timestamps around each repeat differ. Runs on
+    // every decoder step, so the tail is gathered on the stack.
+    const whisper_token eot = whisper_token_eot(ctx);
+    whisper_token tail[LOOP_TAIL];
+    size_t n_tail = 0;
+    for (int i = n_tokens - 1; i >= 0 && n_tail < LOOP_TAIL; i--) {
+        if (tokens[i].id < eot) tail[LOOP_TAIL - ++n_tail] = tokens[i].id;
+    }
+    if (!stt_is_repetition_loop(tail + (LOOP_TAIL - n_tail), n_tail)) return;
+
+    guard->loops_++;
+    LOGD("[LOOP] repetition after %d token(s), ending the window", n_tokens);
+    const int n_vocab = whisper_n_vocab(ctx);
+    for (int i = 0; i < n_vocab; i++) {
+        if (i != eot) logits[i] = -INFINITY;
+    }
+}
@@ -0,0 +1,58 @@
+/**
+ * stt_repeat.h - Early stop for whisper repetition loops
+ *
+ * On silence, noise or music whisper can fall into a loop, re-generating the
+ * same few tokens ("Thank you. Thank you. ...") until the window's token
+ * budget runs out. A looping window costs several times a normal one, which
+ * is where the 5-10x real-time spikes on noisy input come from.
+ *
+ * The guard runs as whisper's logits filter, so it sees every decoder's
+ * tokens before each step. Once the text tokens end in a run of the same
+ * n-gram repeated (see stt_is_repetition_loop), every logit but
+ * end-of-text is masked: the window ends at the next step instead of after
+ * the whole budget. Whisper's own fallbacks (temperature, seek) are left to
+ * handle the truncated window as they would any other.
+ */
+
+#ifndef STT_REPEAT_H
+#define STT_REPEAT_H
+
+#include "whisper.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// A loop is the last `period` tokens repeated back to back, at least
+// STT_LOOP_MIN_REPEATS times and over at least STT_LOOP_MIN_TOKENS tokens:
+// "no, no, no" in speech stays well below that.
+static constexpr size_t STT_LOOP_MAX_PERIOD  = 16;
+static constexpr size_t STT_LOOP_MIN_REPEATS = 4;
+static constexpr size_t STT_LOOP_MIN_TOKENS  = 12;
+
+// True if `tokens` ends in a loop as defined above.
+bool stt_is_repetition_loop(const whisper_token *tokens, size_t n_tokens);
+
+struct SttLoopStats {
+    int64_t decodes = 0;  // decoder passes (per window, decoder and temperature attempt)
+    int64_t loops = 0;    // passes ended early by the guard
+};
+
+class SttRepeatGuard {
+public:
+    // Points `params`' logits filter at this guard, which must outlive every
+    // decode run with them.
+    void install(struct whisper_full_params &params);
+
+    SttLoopStats stats() const;
+    void reset_stats();
+
+private:
+    static void filter(struct whisper_context *ctx, struct whisper_state *state,
+                       const whisper_token_data *tokens, int n_tokens, float *logits, void *self);
+
+    std::atomic<int64_t> decodes_{0};
+    std::atomic<int64_t> loops_{0};
+};
+
+#endif // STT_REPEAT_H
@@ -0,0 +1,453 @@
+/**
+ * stt_session.cpp - Incremental (live) speech-to-text session
+ *
+ * See stt_session.h for the overall model. Terminology used below:
+ *   committed  – words two consecutive decodes agreed on; never revised
+ *   tentative  – the rest of the latest hypothesis; may still change
+ */
+
+#include "stt_session.h"
+#include "stt_buckets.h"
+#include "stt_file.h"
+#include "stt_lang.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+static constexpr int SAMPLES_PER_MS = WHISPER_SAMPLE_RATE / 1000;
+
+// Whisper hallucinates on very short windows; wait for at least this much audio.
+static constexpr int MIN_DECODE_MS = 250;
+
+// Word timestamps jitter by ~100 ms between decodes of the same audio.
+static constexpr int64_t TIMESTAMP_SLACK_MS = 100;
+
+// Longest committed n-gram checked when removing re-transcribed words.
+static constexpr int MAX_DEDUP_WORDS = 5;
+
+// Gap that splits committed words into separate segments in the final result.
+static constexpr int64_t SEGMENT_GAP_MS = 1000;
+
+// ═══════════════════════════════════════════════════════════════
+//                        RING BUFFER
+// ═══════════════════════════════════════════════════════════════
+
+size_t AudioRingBuffer::write(const float *src, size_t n) {
+    n = std::min(n, available());
+    size_t tail = (head_ + size_) % buf_.size();
+    size_t first = std::min(n, buf_.size() - tail);
+    std::memcpy(buf_.data() + tail, src, first * sizeof(float));
+    std::memcpy(buf_.data(), src + first, (n - first) * sizeof(float));
+    size_ += n;
+    return n;
+}
+
+void AudioRingBuffer::copy_to(float *dst, size_t n) const {
+    n = std::min(n, size_);
+    size_t first = std::min(n, buf_.size() - head_);
+    std::memcpy(dst, buf_.data() + head_, first * sizeof(float));
+    std::memcpy(dst + first, buf_.data(), (n - first) * sizeof(float));
+}
+
+void AudioRingBuffer::discard(size_t n) {
+    n = std::min(n, size_);
+    head_ = (head_ + n) % buf_.size();
+    size_ -= n;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                      HELPER FUNCTIONS
+// ═══════════════════════════════════════════════════════════════
+
+// Case- and punctuation-insensitive form of a word for agreement checks.
+// Non-ASCII bytes are kept as-is so UTF-8 text still compares correctly.
+static std::string normalize_word(const std::string &word) {
+    std::string out;
+    out.reserve(word.size());
+    for (unsigned char c : word) {
+        if (c >= 0x80) {
+            out += (char)c;
+        } else if (std::isalnum(c)) {
+            out += (char)std::tolower(c);
+        }
+    }
+    return out;
+}
+
+static bool ends_sentence(const std::string &word) {
+    if (word.empty()) return false;
+    char c = word.back();
+    return c == '.' || c == '?' || c == '!';
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                          SESSION
+// ═══════════════════════════════════════════════════════════════
+
+SttSession::SttSession(struct whisper_context *ctx,
+                       const struct whisper_full_params &base_params,
+                       const std::string &language,
+                       const SttSessionConfig &config)
+    : ctx_(ctx),
+      base_(base_params),
+      language_(language),
+      config_(config),
+      ring_((size_t)(config.max_buffer_ms + 2 * config.step_ms) * SAMPLES_PER_MS) {
+
+    // Each session owns its decoder state so it never disturbs g_ctx's
+    // default state or other sessions.
+    state_ = whisper_init_state(ctx_);
+    if (state_ == nullptr) {
+        LOGE("[STREAM] Failed to allocate whisper state for session");
+    }
+    window_.reserve(ring_.capacity());
+}
+
+SttSession::~SttSession() {
+    if (state_ != nullptr) {
+        whisper_free_state(state_);
+        state_ = nullptr;
+    }
+}
+
+void SttSession::push(const float *samples, int n_samples, const SttSessionCallbacks &cb) {
+    if (state_ == nullptr) {
+        if (cb.on_error) cb.on_error("Session has no whisper state");
+        return;
+    }
+
+    size_t left = n_samples > 0 ? (size_t)n_samples : 0;
+    if (final_ctx_ != nullptr && !utterance_too_long_) {
+        if (utterance_.size() + left > (size_t)config_.final_max_ms * SAMPLES_PER_MS) {
+            utterance_too_long_ = true;
+            utterance_.clear();
+        } else {
+            utterance_.insert(utterance_.end(), samples, samples + left);
+        }
+    }
+
+    while (left > 0) {
+        size_t written = ring_.write(samples, left);
+        samples += written;
+        left -= written;
+        pending_samples_ += (int)written;
+        total_samples_ += (int64_t)written;
+
+        if (left == 0) break;
+
+        // Ring is full (caller pushed a very large chunk): commit whatever the
+        // current hypothesis is and release the committed audio.
+        std::vector<Word> hypothesis;
+        if (decode_tail(hypothesis)) {
+            commit(hypothesis);
+            tentative_.clear();
+        }
+        trim_committed_audio(true);
+        if (ring_.available() == 0) {
+            LOGE("[STREAM] ring buffer overflow — dropping %zu buffered samples", ring_.size());
+            buffer_start_sample_ += (int64_t)ring_.size();
+            ring_.clear();
+        }
+    }
+
+    if (pending_samples_ < config_.step_ms * SAMPLES_PER_MS) {
+        return;
+    }
+
+    std::vector<Word> hypothesis;
+    if (!decode_tail(hypothesis)) {
+        if (cb.on_error) cb.on_error("Transcription failed");
+        return;
+    }
+
+    // Local agreement: the prefix shared with the previous hypothesis is stable.
+    size_t agreed = 0;
+    while (agreed < hypothesis.size() && agreed < tentative_.size() &&
+           normalize_word(hypothesis[agreed].text) == normalize_word(tentative_[agreed].text)) {
+        agreed++;
+    }
+    commit(std::vector<Word>(hypothesis.begin(), hypothesis.begin() + agreed));
+    tentative_.assign(hypothesis.begin() + agreed, hypothesis.end());
+
+    // Never let the uncommitted tail outgrow the decode window.
+    if ((int64_t)ring_.size() >= (int64_t)config_.max_buffer_ms * SAMPLES_PER_MS) {
+        LOGD("[STREAM] buffer at %d ms without agreement — force-committing", config_.max_buffer_ms);
+        commit(tentative_);
+        tentative_.clear();
+        trim_committed_audio(true);
+    } else {
+        trim_committed_audio(false);
+    }
+
+    emit_partial(cb);
+}
+
+void SttSession::flush(const SttSessionCallbacks &cb) {
+    if (state_ == nullptr) {
+        if (cb.on_error) cb.on_error("Session has no whisper state");
+        return;
+    }
+
+    if (pending_samples_ > 0 && ring_.size() > 0) {
+        std::vector<Word> hypothesis;
+        if (!decode_tail(hypothesis)) {
+            if (cb.on_error) cb.on_error("Transcription failed");
+            return;
+        }
+        // A too-short tail decodes to nothing; fall back to the last hypothesis.
+        commit(hypothesis.empty() ? tentative_ : hypothesis);
+    } else {
+        commit(tentative_);
+    }
+    tentative_.clear();
+
+    SttResult result;
+    result.language = language_;
+    if (language_ == "auto") {
+        int lang_id = whisper_full_lang_id_from_state(state_);
+        if (lang_id >= 0) result.language = whisper_lang_str(lang_id);
+    }
+    int64_t stream_ms = total_samples_ / SAMPLES_PER_MS;
+    result.duration_ms = stream_ms - utterance_start_ms_;
+
+    for (size_t i = 0; i < committed_.size(); i++) {
+        const Word &w = committed_[i];
+        bool new_segment = result.segments.empty() ||
+                           ends_sentence(result.segments.back().text) ||
+                           w.t0_ms - result.segments.back().t1_ms > SEGMENT_GAP_MS;
+        if (new_segment) {
+            result.segments.push_back({w.text, w.t0_ms, w.t1_ms});
+        } else {
+            result.segments.back().text += w.text;
+            result.segments.back().t1_ms = std::max(result.segments.back().t1_ms, w.t1_ms);
+        }
+        result.text += w.text;
+    }
+
+    if (final_ctx_ != nullptr) final_pass(result);
+    if (cb.on_final) cb.on_final(result);
+
+    // Carry text into the next utterance's prompt only when the caller wants
+    // context between recordings (same meaning as SttConfig.noContext).
+    if (!base_.no_context) {
+        context_text_ += result.text;
+        size_t keep = (size_t)config_.prompt_chars * 2;
+        if (context_text_.size() > keep) {
+            context_text_.erase(0, context_text_.size() - keep);
+        }
+    }
+
+    committed_.clear();
+    ring_.clear();
+    buffer_start_sample_ = total_samples_;
+    utterance_start_ms_ = stream_ms;
+    committed_end_ms_ = stream_ms;
+    pending_samples_ = 0;
+    last_partial_.clear();
+    utterance_.clear();
+    utterance_too_long_ = false;
+}
+
+void SttSession::set_final_model(struct whisper_context *ctx, WhisperStatePool *pool) {
+    final_ctx_ = ctx;
+    final_pool_ = pool;
+    utterance_.reserve((size_t)std::min(config_.final_max_ms, 30000) * SAMPLES_PER_MS);
+}
+
+// Replaces the streaming result with a decode of the whole utterance on the
+// final model. The streaming text is the prompt: the final model keeps its
+// words and spelling unless it hears otherwise. If the pass cannot run, the
+// streaming result stands.
+void SttSession::final_pass(SttResult &result) {
+    if (utterance_too_long_) {
+        LOGD("[CASCADE] utterance over %d ms, keeping the streaming result", config_.final_max_ms);
+        return;
+    }
+    if (utterance_.empty()) return;
+
+    long t_start = now_ms();
+    WhisperStatePool::Lease lease = final_pool_->acquire();
+    if (!lease) {
+        LOGE("[CASCADE] no state for the final model, keeping the streaming result");
+        return;
+    }
+
+    struct whisper_full_params params = base_;
+    params.language         = result.language.c_str();  // as identified while streaming
+    params.no_context       = true;
+    params.single_segment   = false;
+    params.token_timestamps = false;
+    params.print_progress   = false;
+    params.print_realtime   = false;
+    params.print_timestamps = false;
+    params.print_special    = false;
+    std::string prompt = context_text_ + result.text;  // whisper keeps the tail that fits
+    params.initial_prompt = prompt.empty() ? nullptr : prompt.c_str();
+
+    std::vector<SttSegment> segments;
+    if (!stt_decode_buffer(final_ctx_, lease.state(), params, utterance_.data(), utterance_.size(),
+                           false, segments)) {
+        LOGE("[CASCADE] final pass failed, keeping the streaming result");
+        return;
+    }
+
+    std::string text;
+    for (SttSegment &seg : segments) {
+        seg.t0_ms += utterance_start_ms_;
+        seg.t1_ms += utterance_start_ms_;
+        text += seg.text;
+    }
+    long elapsed = now_ms() - t_start;
+    stats_.final_passes++;
+    stats_.final_ms += elapsed;
+    LOGI("[CASCADE] final pass over %.2fs: %ld ms (%zu -> %zu chars)",
+         (float)utterance_.size() / WHISPER_SAMPLE_RATE, elapsed, result.text.size(), text.size());
+
+    result.text = std::move(text);
+    result.segments = std::move(segments);
+}
+
+bool SttSession::decode_tail(std::vector<Word> &hypothesis) {
+    hypothesis.clear();
+    pending_samples_ = 0;
+
+    const size_t n = ring_.size();
+    if (n < (size_t)MIN_DECODE_MS * SAMPLES_PER_MS) {
+        return true;
+    }
+
+    window_.resize(n);
+    ring_.copy_to(window_.data(), n);
+
+    // Language pre-pass: once enough audio is buffered, identify the language
+    // on a short encoder pass and keep it, instead of whisper re-detecting it
+    // (with a full 30 s encode) on every decode.
+    if (config_.pin_language && stt_language_is_auto(language_.c_str()) &&
+        n >= (size_t)STT_LID_WINDOW_MS * SAMPLES_PER_MS) {
+        std::vector<SttLanguageProb> languages;
+        if (stt_detect_language(ctx_, state_, window_.data(), n, true, base_.n_threads, 1, nullptr, languages) &&
+            !languages.empty()) {
+            language_ = languages[0].language;
+            LOGI("[STREAM] language pinned to %s", language_.c_str());
+        }
+    }
+
+    struct whisper_full_params params = base_;
+    params.language         = language_.c_str();
+    params.no_context       = true;    // continuity comes from initial_prompt instead
+    params.single_segment   = false;
+    params.token_timestamps = true;    // word times drive commit and trimming
+    params.print_progress   = false;
+    params.print_realtime   = false;
+    params.print_timestamps = false;
+    params.print_special    = false;
+    // Encoder window fitted to the tail, in the same buckets as every other path
+    params.audio_ctx = stt_bucket_audio_ctx(ctx_, n);
+
+    std::string prompt = prompt_tail();
+    params.initial_prompt = prompt.empty() ? nullptr : prompt.c_str();
+
+    long t_start = now_ms();
+    if (whisper_full_with_state(ctx_, state_, params, window_.data(), (int)n) != 0) {
+        LOGE("[STREAM] whisper_full_with_state failed on %zu-sample tail", n);
+        return false;
+    }
+
+    const int64_t offset_ms = buffer_start_sample_ / SAMPLES_PER_MS;
+    const whisper_token eot = whisper_token_eot(ctx_);
+
+    int n_segments = whisper_full_n_segments_from_state(state_);
+    for (int s = 0; s < n_segments; s++) {
+        int n_tokens = whisper_full_n_tokens_from_state(state_, s);
+        for (int t = 0; t < n_tokens; t++) {
+            whisper_token_data td = whisper_full_get_token_data_from_state(state_, s, t);
+            if (td.id >= eot) continue;  // special and timestamp tokens
+
+            const char *text = whisper_full_get_token_text_from_state(ctx_, state_, s, t);
+            if (text == nullptr || text[0] == '\0') continue;
+
+            int64_t t0 = offset_ms + td.t0 * 10;
+            int64_t t1 = offset_ms + td.t1 * 10;
+            if (hypothesis.empty() || text[0] == ' ') {
+                hypothesis.push_back({text, t0, t1});
+            } else {
+                // Sub-word piece or punctuation: extend the current word.
+                hypothesis.back().text += text;
+                hypothesis.back().t1_ms = std::max(hypothesis.back().t1_ms, t1);
+            }
+        }
+    }
+
+    // The buffer may still hold audio for already-committed words; drop them
+    // by time first, then by matching the committed tail word-for-word.
+    size_t skip = 0;
+    while (skip < hypothesis.size() &&
+           hypothesis[skip].t0_ms < committed_end_ms_ - TIMESTAMP_SLACK_MS) {
+        skip++;
+    }
+    hypothesis.erase(hypothesis.begin(), hypothesis.begin() + skip);
+
+    int max_k = std::min<int>(MAX_DEDUP_WORDS, (int)std::min(committed_.size(), hypothesis.size()));
+    for (int k = max_k; k >= 1; k--) {
+        bool match = true;
+        for (int i = 0; i < k && match; i++) {
+            match = normalize_word(committed_[committed_.size() - k + i].text) ==
+                    normalize_word(hypothesis[i].text);
+        }
+        if (match) {
+            hypothesis.erase(hypothesis.begin(), hypothesis.begin() + k);
+            break;
+        }
+    }
+
+    long elapsed = now_ms() - t_start;
+    stats_.partial_decodes++;
+    stats_.partial_ms += elapsed;
+    LOGD("[STREAM] decoded %.2fs tail in %ld ms → %zu words (%zu committed so far)",
+         (float)n / WHISPER_SAMPLE_RATE, elapsed, hypothesis.size(), committed_.size());
+    return true;
+}
+
+void SttSession::commit(const std::vector<Word> &words) {
+    for (const Word &w : words) {
+        committed_.push_back(w);
+        committed_end_ms_ = std::max(committed_end_ms_, w.t1_ms);
+    }
+}
+
+void SttSession::trim_committed_audio(bool force) {
+    const int64_t buffered_ms = (int64_t)ring_.size() / SAMPLES_PER_MS;
+    if (!force && buffered_ms < config_.trim_ms) return;
+
+    const int64_t start_ms = buffer_start_sample_ / SAMPLES_PER_MS;
+    if (committed_end_ms_ <= start_ms) return;
+
+    int64_t cut_ms = std::min(committed_end_ms_ - start_ms, buffered_ms);
+    size_t cut = (size_t)cut_ms * SAMPLES_PER_MS;
+    ring_.discard(cut);
+    buffer_start_sample_ += (int64_t)cut;
+}
+
+void SttSession::emit_partial(const SttSessionCallbacks &cb) {
+    std::string text;
+    for (const Word &w : committed_) text += w.text;
+    for (const Word &w : tentative_) text += w.text;
+
+    if (text != last_partial_) {
+        last_partial_ = text;
+        if (cb.on_partial) cb.on_partial(text);
+    }
+}
+
+std::string SttSession::prompt_tail() const {
+    std::string source = context_text_;
+    for (const Word &w : committed_) source += w.text;
+
+    if (source.size() <= (size_t)config_.prompt_chars) return source;
+
+    // Start at a word boundary so the prompt never begins mid-word (or mid UTF-8 sequence).
+    size_t start = source.size() - (size_t)config_.prompt_chars;
+    size_t space = source.find(' ', start);
+    return space == std::string::npos ? std::string() : source.substr(space);
+}
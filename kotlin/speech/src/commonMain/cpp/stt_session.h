@@ -0,0 +1,150 @@
+/**
+ * stt_session.h - Incremental (live) speech-to-text session
+ *
+ * Audio is pushed in small chunks. The session keeps the not-yet-committed
+ * tail in a ring buffer and re-decodes only that tail every `step_ms` of new
+ * audio. Words that two consecutive decodes agree on are committed
+ * (local agreement), so partial results stabilise within a few hundred ms
+ * of being spoken instead of waiting for the whole utterance.
+ *
+ * Cascade: with a final model set, partials still come from the session's
+ * (small, fast) model, and flush() re-decodes the whole utterance once on the
+ * final (larger) model, with the streaming text as its prompt. Partial
+ * latency follows the small model and final accuracy the large one;
+ * SttSessionStats times the two separately.
+ *
+ * Platform-neutral: the JNI and iOS wrappers own the whisper_context and
+ * translate callbacks for their runtime.
+ */
+
+#ifndef STT_SESSION_H
+#define STT_SESSION_H
+
+#include "stt_common.h"
+#include "whisper_state_pool.h"
+#include "whisper.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+struct SttSessionConfig {
+    int step_ms       = 500;    // new audio required before the tail is re-decoded
+    int trim_ms       = 10000;  // drop committed audio once the buffer grows past this
+    int max_buffer_ms = 25000;  // force-commit the hypothesis before the buffer overflows
+    int prompt_chars  = 200;    // committed text fed back as initial_prompt
+    bool pin_language = false;  // with "auto": identify once (see stt_lang.h), then keep it
+    int final_max_ms  = 120000; // cascade: longer utterances keep the streaming text
+};
+
+// Decode time per path, since the session opened.
+struct SttSessionStats {
+    int64_t partial_decodes = 0;  // tail re-decodes on the session's model
+    int64_t partial_ms = 0;
+    int64_t final_passes = 0;     // utterances re-decoded on the final model
+    int64_t final_ms = 0;
+};
+
+// Invoked on the thread that calls push()/flush().
+struct SttSessionCallbacks {
+    std::function<void(const std::string &text)> on_partial;
+    std::function<void(const SttResult &result)> on_final;
+    std::function<void(const std::string &message)> on_error;
+};
+
+// Fixed-capacity FIFO of float samples. Not thread-safe: a session is driven
+// by a single caller.
+class AudioRingBuffer {
+public:
+    explicit AudioRingBuffer(size_t capacity) : buf_(capacity) {}
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return buf_.size(); }
+    size_t available() const { return buf_.size() - size_; }
+
+    // Appends up to `n` samples; returns how many fit.
+    size_t write(const float *src, size_t n);
+    // Copies the oldest `n` samples (n <= size()) into contiguous `dst`.
+    void copy_to(float *dst, size_t n) const;
+    // Drops the oldest `n` samples.
+    void discard(size_t n);
+    void clear() { head_ = 0; size_ = 0; }
+
+private:
+    std::vector<float> buf_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
+
+class SttSession {
+public:
+    SttSession(struct whisper_context *ctx,
+               const struct whisper_full_params &base_params,
+               const std::string &language,
+               const SttSessionConfig &config = SttSessionConfig());
+    ~SttSession();
+
+    SttSession(const SttSession &) = delete;
+    SttSession &operator=(const SttSession &) = delete;
+
+    // False if the per-session whisper_state could not be allocated.
+    bool ok() const { return state_ != nullptr; }
+
+    // Append 16 kHz mono samples. Re-decodes the tail once `step_ms` of new
+    // audio has accumulated and reports the committed + tentative text.
+    void push(const float *samples, int n_samples, const SttSessionCallbacks &cb);
+
+    // Decode the remaining tail, commit everything and deliver the utterance
+    // via on_final. The session stays open for the next utterance.
+    void flush(const SttSessionCallbacks &cb);
+
+    // Turns the session into a cascade: each utterance is kept (up to
+    // final_max_ms) and re-decoded on `ctx`, with a state leased from `pool`,
+    // before on_final. Both must outlive the session. Call before push().
+    void set_final_model(struct whisper_context *ctx, WhisperStatePool *pool);
+
+    const SttSessionStats &stats() const { return stats_; }
+
+private:
+    struct Word {
+        std::string text;
+        int64_t t0_ms;
+        int64_t t1_ms;
+    };
+
+    bool decode_tail(std::vector<Word> &hypothesis);
+    void commit(const std::vector<Word> &words);
+    void trim_committed_audio(bool force);
+    void emit_partial(const SttSessionCallbacks &cb);
+    void final_pass(SttResult &result);
+    std::string prompt_tail() const;
+
+    struct whisper_context *ctx_;
+    struct whisper_state *state_ = nullptr;
+    struct whisper_full_params base_;
+    std::string language_;
+    SttSessionConfig config_;
+
+    AudioRingBuffer ring_;
+    std::vector<float> window_;       // contiguous copy of the ring for whisper
+
+    int64_t buffer_start_sample_ = 0; // stream position of the oldest buffered sample
+    int64_t total_samples_ = 0;       // samples pushed since the session opened
+    int64_t utterance_start_ms_ = 0;  // stream time at which the current utterance began
+    int pending_samples_ = 0;         // samples pushed since the last decode
+
+    std::vector<Word> committed_;     // committed words of the current utterance
+    std::vector<Word> tentative_;     // last hypothesis beyond the committed prefix
+    int64_t committed_end_ms_ = 0;
+    std::string context_text_;        // committed text carried across utterances
+    std::string last_partial_;
+
+    struct whisper_context *final_ctx_ = nullptr;  // cascade only
+    WhisperStatePool *final_pool_ = nullptr;
+    std::vector<float> utterance_;    // audio of the current utterance, for the final pass
+    bool utterance_too_long_ = false;
+
+    SttSessionStats stats_;
+};
+
+#endif // STT_SESSION_H
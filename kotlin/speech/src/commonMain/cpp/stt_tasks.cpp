@@ -0,0 +1,194 @@
+/**
+ * stt_tasks.cpp - Several decodes of one clip from a single encoder pass
+ */
+
+#include "stt_tasks.h"
+#include "stt_buckets.h"
+#include "stt_lang.h"
+#include "stt_repeat.h"
+#include "vad.h"
+
+#include <algorithm>
+#include <cmath>
+
+static constexpr size_t WINDOW_SAMPLES = 30 * WHISPER_SAMPLE_RATE;
+
+static constexpr int64_t SAMPLES_PER_MS = WHISPER_SAMPLE_RATE / 1000;
+
+// Logits of the last token of the previous whisper_decode_with_state() call.
+static const float *last_logits(struct whisper_state *state, size_t n_input, int n_vocab) {
+    return whisper_get_logits_from_state(state) + (n_input - 1) * (size_t)n_vocab;
+}
+
+// Most likely language of the encoder output in `state`: one decoder step
+// from start-of-transcript, compared over the language tokens.
+static std::string detect_language(struct whisper_context *ctx, struct whisper_state *state, int n_threads) {
+    if (!whisper_is_multilingual(ctx)) return "en";
+    whisper_token sot = whisper_token_sot(ctx);
+    if (whisper_decode_with_state(ctx, state, &sot, 1, 0, n_threads) != 0) return "";
+
+    const float *logits = last_logits(state, 1, whisper_n_vocab(ctx));
+    int best = -1;
+    for (int id = 0; id <= whisper_lang_max_id(); id++) {
+        if (best < 0 || logits[whisper_token_lang(ctx, id)] > logits[whisper_token_lang(ctx, best)]) best = id;
+    }
+    return best < 0 ? "" : whisper_lang_str(best);
+}
+
+// Decoder input for a task: optional previous-text prompt, then
+// start-of-transcript, language, task and no-timestamps.
+static std::vector<whisper_token> task_prompt(struct whisper_context *ctx, const std::string &language,
+                                              bool translate, const std::string &prompt) {
+    std::vector<whisper_token> tokens;
+    if (!prompt.empty()) {
+        // Whisper keeps at most half the text context for the prompt, the tail of it
+        const size_t max_prompt = (size_t)whisper_n_text_ctx(ctx) / 2 - 4;
+        std::vector<whisper_token> text(max_prompt);
+        int n = whisper_tokenize(ctx, prompt.c_str(), text.data(), (int)text.size());
+        if (n < 0) {
+            text.resize((size_t)-n);
+            n = whisper_tokenize(ctx, prompt.c_str(), text.data(), (int)text.size());
+        }
+        if (n > 0) {
+            size_t keep = std::min((size_t)n, max_prompt);
+            tokens.push_back(whisper_token_prev(ctx));
+            tokens.insert(tokens.end(), text.begin() + (n - (long)keep), text.begin() + n);
+        }
+    }
+    tokens.push_back(whisper_token_sot(ctx));
+    if (whisper_is_multilingual(ctx)) {
+        int lang_id = whisper_lang_id(language.c_str());
+        tokens.push_back(whisper_token_lang(ctx, lang_id >= 0 ? lang_id : whisper_lang_id("en")));
+        tokens.push_back(translate ? whisper_token_translate(ctx) : whisper_token_transcribe(ctx));
+    }
+    tokens.push_back(whisper_token_not(ctx));
+    return tokens;
+}
+
+// Greedy decode against the encoder output already in `state`. Stops at
+// end-of-text, the token budget, a repetition loop or `abort`. The budget
+// is half the text context, less whatever a long prompt leaves of it:
+// every fed token takes a decoder position.
+static bool decode_task(struct whisper_context *ctx, struct whisper_state *state,
+                        const std::vector<whisper_token> &prompt, int n_threads,
+                        const SttAbort *abort, std::string &text) {
+    const int n_vocab = whisper_n_vocab(ctx);
+    const whisper_token eot = whisper_token_eot(ctx);
+    const int n_text_ctx = whisper_n_text_ctx(ctx);
+    const int max_tokens = std::min(n_text_ctx / 2, n_text_ctx - (int)prompt.size());
+
+    std::vector<whisper_token> input = prompt;
+    std::vector<whisper_token> generated;
+    int n_past = 0;
+    for (int step = 0; step < max_tokens; step++) {
+        if (abort != nullptr && abort->stop()) break;
+        if (whisper_decode_with_state(ctx, state, input.data(), (int)input.size(), n_past, n_threads) != 0) {
+            return false;
+        }
+        n_past += (int)input.size();
+
+        // Text tokens and end-of-text only; never an empty transcript
+        const float *logits = last_logits(state, input.size(), n_vocab);
+        whisper_token best = step > 0 ? eot : 0;
+        for (whisper_token t = 0; t < eot; t++) {
+            if (logits[t] > logits[best]) best = t;
+        }
+        if (best == eot) break;
+
+        generated.push_back(best);
+        text += whisper_token_to_str(ctx, best);
+        if (stt_is_repetition_loop(generated.data(), generated.size())) break;
+        input.assign(1, best);
+    }
+    return true;
+}
+
+bool stt_transcribe_tasks(struct whisper_context *ctx,
+                          struct whisper_state *state,
+                          const struct whisper_full_params &params,
+                          const float *audio, size_t n_samples,
+                          bool use_vad,
+                          const std::vector<SttTask> &tasks,
+                          std::vector<SttResult> &results,
+                          const SttAbort *abort) {
+    const char *default_language = params.language != nullptr ? params.language : "en";
+    results.assign(tasks.size(), SttResult());
+    for (SttResult &r : results) {
+        r.language = default_language;
+        r.duration_ms = (int64_t)n_samples / SAMPLES_PER_MS;
+    }
+
+    VadPacked packed;
+    if (use_vad) {
+        vad_pack(audio, n_samples, vad_detect(audio, n_samples), packed);
+        audio = packed.samples();
+        n_samples = packed.n_samples();
+    }
+    if (tasks.empty() || n_samples == 0) return true;
+
+    long t_start = now_ms();
+    const int n_threads = params.n_threads;
+
+    // Prime: mel of the whole buffer, and an encoder context fitted to a
+    // clip shorter than one window (see stt_lang.h, stt_buckets.h)
+    if (!stt_prime_state(ctx, state, audio, n_samples, n_threads)) {
+        LOGE("[TASKS] failed to prepare %zu samples", n_samples);
+        return false;
+    }
+
+    std::vector<std::vector<whisper_token>> prompts(tasks.size());
+    std::string detected;
+    size_t n_windows = 0;
+    bool stopped = false;
+
+    for (size_t start = 0; start < n_samples; start += WINDOW_SAMPLES) {
+        if (abort != nullptr && abort->stop()) {
+            stopped = true;
+            break;
+        }
+        if (whisper_encode_with_state(ctx, state, (int)(start / WHISPER_HOP_LENGTH), n_threads) != 0) {
+            LOGE("[TASKS] encoder failed at %.1fs", (float)start / WHISPER_SAMPLE_RATE);
+            return false;
+        }
+        n_windows++;
+
+        const int64_t t0 = (int64_t)start / SAMPLES_PER_MS;
+        const int64_t t1 = (int64_t)std::min(start + WINDOW_SAMPLES, n_samples) / SAMPLES_PER_MS;
+        for (size_t i = 0; i < tasks.size(); i++) {
+            const SttTask &task = tasks[i];
+            SttResult &result = results[i];
+            if (prompts[i].empty()) {
+                std::string language = task.language.empty() ? default_language : task.language;
+                if (stt_language_is_auto(language.c_str())) {
+                    if (detected.empty()) detected = detect_language(ctx, state, n_threads);
+                    language = detected.empty() ? "en" : detected;
+                }
+                bool translate = task.translate < 0 ? params.translate : task.translate != 0;
+                prompts[i] = task_prompt(ctx, language, translate, task.prompt);
+                result.language = language;
+            }
+
+            std::string text;
+            if (!decode_task(ctx, state, prompts[i], n_threads, abort, text)) {
+                LOGE("[TASKS] task %zu failed", i);
+                return false;
+            }
+            if (!text.empty()) {
+                result.text += text;
+                result.segments.push_back({text, t0, t1});
+            }
+        }
+        if (abort != nullptr && abort->stop()) {
+            stopped = true;
+            break;
+        }
+    }
+
+    for (SttResult &result : results) {
+        if (use_vad) vad_remap(packed, result.segments);
+        result.partial = stopped;
+    }
+    LOGI("[TASKS] %zu task(s) over %zu window(s), one encoder pass each: %ld ms",
+         tasks.size(), n_windows, now_ms() - t_start);
+    return true;
+}
@@ -0,0 +1,49 @@
+/**
+ * stt_tasks.h - Several decodes of one clip from a single encoder pass
+ *
+ * Apps often want both the transcription and the English translation of a
+ * clip, or the same clip decoded with different prompts. Every whisper_full
+ * call re-runs the encoder, the dominant cost for small models, although
+ * only the decoder's task tokens differ. Here the clip is encoded once per
+ * 30 s window with whisper_encode_with_state(), and each task runs its own
+ * greedy decode (whisper_decode_with_state) against that encoder output on
+ * the same state. Transcribe + translate costs about one encoder pass plus
+ * two decodes instead of two full runs.
+ *
+ * The decoder here is deliberately small: greedy, text tokens only (no
+ * timestamps), no temperature fallback. Each window gives one segment per
+ * task, spanning the window; windows are cut at fixed 30 s boundaries.
+ */
+
+#ifndef STT_TASKS_H
+#define STT_TASKS_H
+
+#include "stt_abort.h"
+#include "stt_common.h"
+#include "whisper.h"
+
+#include <string>
+#include <vector>
+
+// One decode of the shared encoder output.
+struct SttTask {
+    std::string language;  // empty: params.language; "auto": detected once, from the first window
+    int translate = -1;    // -1: params.translate, otherwise 0 / 1
+    std::string prompt;    // text the decoder is conditioned on; empty: none
+};
+
+// Runs every task over 16 kHz `audio` on `state`; one result per task, in
+// order. `params` supplies the defaults above and n_threads. With
+// `use_vad` silence is cut first and segment times are mapped back. Once
+// `abort` fires, decoding stops and every result is marked partial.
+// Returns false if whisper fails.
+bool stt_transcribe_tasks(struct whisper_context *ctx,
+                          struct whisper_state *state,
+                          const struct whisper_full_params &params,
+                          const float *audio, size_t n_samples,
+                          bool use_vad,
+                          const std::vector<SttTask> &tasks,
+                          std::vector<SttResult> &results,
+                          const SttAbort *abort = nullptr);
+
+#endif // STT_TASKS_H
@@ -0,0 +1,169 @@
+/**
+ * vad.cpp - Energy-based voice activity detection for 16 kHz mono audio
+ */
+
+#include "vad.h"
+
+#include <algorithm>
+#include <cmath>
+
+static constexpr int64_t SAMPLES_PER_MS = 16;
+
+// Histogram range, in log10(RMS).
+static constexpr float LOG_MIN = -6.0f;
+static constexpr float LOG_MAX = 0.0f;
+
+// ═══════════════════════════════════════════════════════════════
+//                     STREAMING PERCENTILE
+// ═══════════════════════════════════════════════════════════════
+
+void StreamingPercentile::add(float value) {
+    float l = value > 0.0f ? std::log10(value) : LOG_MIN;
+    int bin = (int)((l - LOG_MIN) / (LOG_MAX - LOG_MIN) * BINS);
+    bins_[std::min(std::max(bin, 0), BINS - 1)]++;
+    count_++;
+}
+
+float StreamingPercentile::quantile(float q) const {
+    if (count_ == 0) return 0.0f;
+    size_t target = (size_t)(q * (float)count_);
+    size_t seen = 0;
+    int bin = 0;
+    for (; bin < BINS - 1; bin++) {
+        seen += bins_[bin];
+        if (seen > target) break;
+    }
+    // Centre of the bin
+    float l = LOG_MIN + ((float)bin + 0.5f) * (LOG_MAX - LOG_MIN) / BINS;
+    return std::pow(10.0f, l);
+}
+
+void StreamingPercentile::reset() {
+    std::fill(bins_, bins_ + BINS, 0u);
+    count_ = 0;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                          DETECTION
+// ═══════════════════════════════════════════════════════════════
+
+std::vector<VadRegion> vad_detect(const float *audio, size_t n_samples, const VadConfig &config) {
+    std::vector<VadRegion> regions;
+    const int frame = config.frame_samples;
+    const int n_frames = (int)(n_samples / (size_t)frame);
+    if (n_frames == 0) return regions;
+
+    // Per-frame RMS and the noise floor (10th percentile)
+    std::vector<float> frame_rms((size_t)n_frames);
+    StreamingPercentile percentile;
+    for (int f = 0; f < n_frames; f++) {
+        const float *p = audio + (size_t)f * frame;
+        float sum = 0.0f;
+        for (int i = 0; i < frame; i++) sum += p[i] * p[i];
+        frame_rms[f] = std::sqrt(sum / frame);
+        percentile.add(frame_rms[f]);
+    }
+    const float noise_floor = percentile.quantile(0.10f);
+    const float start_threshold = std::max(config.min_threshold, noise_floor * config.start_ratio);
+    const float stop_threshold = start_threshold * config.stop_ratio / config.start_ratio;
+
+    // Hysteresis + hangover state machine over frames
+    std::vector<std::pair<int, int>> frames;  // [first, last] speech frame
+    bool in_speech = false;
+    int region_start = 0, last_loud = 0, loud_frames = 0;
+    for (int f = 0; f < n_frames; f++) {
+        float rms = frame_rms[f];
+        if (!in_speech) {
+            if (rms >= start_threshold) {
+                in_speech = true;
+                region_start = last_loud = f;
+                loud_frames = 1;
+            }
+            continue;
+        }
+        if (rms >= stop_threshold) {
+            last_loud = f;
+            if (rms >= start_threshold) loud_frames++;
+        } else if (f - last_loud > config.hangover_frames) {
+            if (loud_frames >= config.min_speech_frames) frames.emplace_back(region_start, last_loud);
+            in_speech = false;
+        }
+    }
+    if (in_speech && loud_frames >= config.min_speech_frames) {
+        frames.emplace_back(region_start, last_loud);
+    }
+
+    // Pad, then merge close neighbours
+    for (const auto &r : frames) {
+        int first = std::max(0, r.first - config.pad_frames);
+        int end = std::min(n_frames, r.second + 1 + config.pad_frames);
+        int64_t start_sample = (int64_t)first * frame;
+        int64_t end_sample = (int64_t)end * frame;
+        if (end == n_frames) end_sample = (int64_t)n_samples;  // keep the partial last frame
+
+        if (!regions.empty() &&
+            start_sample - regions.back().end <= (int64_t)config.merge_gap_frames * frame) {
+            regions.back().end = end_sample;
+        } else {
+            regions.push_back({start_sample, end_sample});
+        }
+    }
+
+    LOGD("[VAD] noise_floor=%.4f  start=%.4f  stop=%.4f  regions=%zu",
+         noise_floor, start_threshold, stop_threshold, regions.size());
+    return regions;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                       PACKING / REMAPPING
+// ═══════════════════════════════════════════════════════════════
+
+void vad_pack(const float *audio, size_t n_samples,
+              const std::vector<VadRegion> &regions, VadPacked &packed) {
+    packed.audio.clear();
+    packed.pieces.clear();
+    packed.view_ = nullptr;
+    packed.view_size_ = 0;
+
+    int64_t total = 0;
+    for (const VadRegion &r : regions) {
+        int64_t end = std::min<int64_t>(r.end, (int64_t)n_samples);
+        if (end <= r.start) continue;
+        packed.pieces.push_back({total, r.start, end - r.start});
+        total += end - r.start;
+    }
+
+    // One region is a contiguous span of the input: hand out a view
+    if (packed.pieces.size() == 1) {
+        packed.view_ = audio + packed.pieces[0].orig_start;
+        packed.view_size_ = (size_t)total;
+        return;
+    }
+
+    packed.audio.reserve((size_t)total);
+    for (const VadPacked::Piece &p : packed.pieces) {
+        packed.audio.insert(packed.audio.end(), audio + p.orig_start, audio + p.orig_start + p.length);
+    }
+}
+
+int64_t VadPacked::to_original_ms(int64_t packed_ms, bool is_end) const {
+    if (pieces.empty()) return packed_ms;
+    int64_t t = packed_ms * SAMPLES_PER_MS;
+
+    // Last piece starting before (or, for starts, at) t
+    auto it = std::upper_bound(pieces.begin(), pieces.end(), t,
+        [is_end](int64_t value, const Piece &p) {
+            return is_end ? value <= p.packed_start : value < p.packed_start;
+        });
+    const Piece &p = it == pieces.begin() ? pieces.front() : *(it - 1);
+
+    int64_t offset = std::min(std::max<int64_t>(t - p.packed_start, 0), p.length);
+    return (p.orig_start + offset) / SAMPLES_PER_MS;
+}
+
+void vad_remap(const VadPacked &packed, std::vector<SttSegment> &segments) {
+    for (SttSegment &seg : segments) {
+        seg.t0_ms = packed.to_original_ms(seg.t0_ms, false);
+        seg.t1_ms = packed.to_original_ms(seg.t1_ms, true);
+    }
+}
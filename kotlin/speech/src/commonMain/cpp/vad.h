@@ -0,0 +1,95 @@
+/**
+ * vad.h - Energy-based voice activity detection for 16 kHz mono audio
+ *
+ * Finds every speech region in a buffer (not just the first and last speech
+ * frame), so long internal pauses can be cut out before the encoder sees
+ * them. The threshold adapts to the recording: it is a multiple of the noise
+ * floor, estimated as the 10th-percentile frame RMS with a fixed-size
+ * histogram (one pass, O(1) per frame, no sort).
+ *
+ * Detection uses hysteresis (a higher level to enter speech than to stay in
+ * it) and a hangover, so word-internal dips and trailing consonants are not
+ * chopped off.
+ */
+
+#ifndef VAD_H
+#define VAD_H
+
+#include "stt_common.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct VadConfig {
+    int frame_samples      = 480;    // 30 ms analysis frame
+    float min_threshold    = 0.02f;  // absolute floor for the start threshold
+    float start_ratio      = 4.0f;   // enter speech at noise_floor * start_ratio
+    float stop_ratio       = 2.5f;   // stay in speech down to the start threshold * stop/start
+    int min_speech_frames  = 3;      // shorter bursts (clicks, bumps) are dropped
+    int hangover_frames    = 8;      // quiet frames tolerated before a region closes
+    int pad_frames         = 10;     // context added on both sides of a region
+    int merge_gap_frames   = 17;     // regions closer than this (~0.5 s) are merged
+};
+
+// [start, end) in samples of the analysed buffer.
+struct VadRegion {
+    int64_t start = 0;
+    int64_t end = 0;
+};
+
+// Streaming quantile estimate over values in roughly [1e-6, 1] (frame RMS),
+// from a log-spaced histogram. Accurate to one bin (~5%).
+class StreamingPercentile {
+public:
+    void add(float value);
+    // Value below which fraction `q` of the added values fall; 0 if empty.
+    float quantile(float q) const;
+    size_t count() const { return count_; }
+    void reset();
+
+private:
+    static constexpr int BINS = 256;
+    uint32_t bins_[BINS] = {};
+    size_t count_ = 0;
+};
+
+// Speech regions of `audio`, padded, merged and in order. Empty if the
+// buffer holds no speech.
+std::vector<VadRegion> vad_detect(const float *audio, size_t n_samples,
+                                  const VadConfig &config = VadConfig());
+
+// Speech regions concatenated into one buffer, with the mapping back to the
+// original audio. A single region is not copied: samples() then points into
+// the buffer given to vad_pack(), which must outlive this object.
+struct VadPacked {
+    struct Piece {
+        int64_t packed_start;  // samples into the packed audio
+        int64_t orig_start;    // samples into the original buffer
+        int64_t length;
+    };
+
+    std::vector<float> audio;  // empty when the packed audio is a view
+    std::vector<Piece> pieces;
+
+    const float *samples() const { return view_ != nullptr ? view_ : audio.data(); }
+    size_t n_samples() const { return view_ != nullptr ? view_size_ : audio.size(); }
+    bool empty() const { return n_samples() == 0; }
+
+    // Maps a time in the packed buffer to original-audio time. `is_end`
+    // resolves instants on a piece boundary to the end of the earlier piece.
+    int64_t to_original_ms(int64_t packed_ms, bool is_end) const;
+
+private:
+    friend void vad_pack(const float *, size_t, const std::vector<VadRegion> &, VadPacked &);
+    const float *view_ = nullptr;
+    size_t view_size_ = 0;
+};
+
+void vad_pack(const float *audio, size_t n_samples,
+              const std::vector<VadRegion> &regions, VadPacked &packed);
+
+// Rewrites segment times from packed to original-audio time.
+void vad_remap(const VadPacked &packed, std::vector<SttSegment> &segments);
+
+#endif // VAD_H
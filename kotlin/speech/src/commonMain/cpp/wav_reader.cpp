@@ -0,0 +1,388 @@
+/**
+ * wav_reader.cpp - Memory-mapped, streaming WAV / FLAC reader
+ */
+
+#include "wav_reader.h"
+#include "pcm.h"
+#include "stt_common.h"
+#include "whisper.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Source frames decoded per block (~85 ms at 48 kHz).
+static constexpr size_t BLOCK_FRAMES = 4096;
+
+static uint16_t read_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t read_u32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static constexpr uint16_t WAVE_FORMAT_PCM        = 0x0001;
+static constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+static constexpr uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+// ═══════════════════════════════════════════════════════════════
+//                       SAMPLE ENCODINGS
+// ═══════════════════════════════════════════════════════════════
+
+static float sample_u8(const uint8_t *p) {
+    return ((float)p[0] - 128.0f) / 128.0f;
+}
+
+static float sample_s16(const uint8_t *p) {
+    return (float)(int16_t)read_u16(p) / 32768.0f;
+}
+
+static float sample_s24(const uint8_t *p) {
+    // Into the top 24 bits of an int32, so the sign comes along
+    return (float)(int32_t)((uint32_t)p[0] << 8 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 24) / 2147483648.0f;
+}
+
+static float sample_s32(const uint8_t *p) {
+    return (float)(int32_t)read_u32(p) / 2147483648.0f;
+}
+
+static float sample_f32(const uint8_t *p) {
+    float v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static float sample_f64(const uint8_t *p) {
+    double v;
+    std::memcpy(&v, p, sizeof(v));
+    return (float)v;
+}
+
+// Decoder for a format / container size, or nullptr if unsupported.
+static float (*sample_decoder(uint16_t format, uint16_t bits))(const uint8_t *) {
+    if (format == WAVE_FORMAT_PCM) {
+        switch (bits) {
+            case 8:  return sample_u8;
+            case 16: return sample_s16;
+            case 24: return sample_s24;
+            case 32: return sample_s32;
+        }
+    } else if (format == WAVE_FORMAT_IEEE_FLOAT) {
+        switch (bits) {
+            case 32: return sample_f32;
+            case 64: return sample_f64;
+        }
+    }
+    return nullptr;
+}
+
+// Size of a leading ID3v2 tag (FLAC and MP3 files may carry one), or 0.
+static size_t id3_size(const uint8_t *p, size_t size) {
+    if (size < 10 || std::memcmp(p, "ID3", 3) != 0) return 0;
+    size_t tag = 10 + ((size_t)(p[6] & 0x7F) << 21 | (size_t)(p[7] & 0x7F) << 14 |
+                       (size_t)(p[8] & 0x7F) << 7 | (size_t)(p[9] & 0x7F));
+    if (p[5] & 0x10) tag += 10;  // footer
+    return std::min(tag, size);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                        OPEN / CLOSE
+// ═══════════════════════════════════════════════════════════════
+
+WavReader::~WavReader() {
+    close();
+}
+
+bool WavReader::open(const std::string &path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        LOGE("Failed to open audio file: %s", path.c_str());
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        LOGE("Failed to open audio file: %s", path.c_str());
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void *map = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (map == nullptr) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        LOGE("Failed to map audio file: %s", path.c_str());
+        return false;
+    }
+    file_handle_ = file;
+    mapping_handle_ = mapping;
+    map_ = static_cast<const uint8_t *>(map);
+    map_size_ = (size_t)size.QuadPart;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOGE("Failed to open audio file: %s", path.c_str());
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        ::close(fd);
+        LOGE("Failed to open audio file: %s", path.c_str());
+        return false;
+    }
+    void *map = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // the mapping keeps the file alive
+    if (map == MAP_FAILED) {
+        LOGE("Failed to map audio file: %s", path.c_str());
+        return false;
+    }
+    madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+    map_ = static_cast<const uint8_t *>(map);
+    map_size_ = (size_t)st.st_size;
+#endif
+
+    // FLAC, else it must be WAV
+    const size_t tag = id3_size(map_, map_size_);
+    if (map_size_ >= tag + 4 && std::memcmp(map_ + tag, "fLaC", 4) == 0) {
+        return open_flac(path, tag);
+    }
+    if (map_size_ >= 4 && (tag > 0 || std::memcmp(map_, "OggS", 4) == 0 ||
+                           (map_[0] == 0xFF && (map_[1] & 0xE0) == 0xE0))) {
+        LOGE("Unsupported audio format (MP3 / Ogg): %s; use WAV or FLAC", path.c_str());
+        close();
+        return false;
+    }
+
+    // Read WAV header
+    if (map_size_ < 12 || std::memcmp(map_, "RIFF", 4) != 0) {
+        LOGE("Invalid WAV file: missing RIFF header");
+        close();
+        return false;
+    }
+    if (std::memcmp(map_ + 8, "WAVE", 4) != 0) {
+        LOGE("Invalid WAV file: missing WAVE header");
+        close();
+        return false;
+    }
+
+    // Walk the chunks for fmt and data
+    bool have_fmt = false;
+    uint16_t audio_format = 0;
+    uint16_t bits_per_sample = 0;
+    size_t pos = 12;
+    while (pos + 8 <= map_size_) {
+        const uint8_t *chunk = map_ + pos;
+        size_t chunk_size = read_u32(chunk + 4);
+        size_t body = pos + 8;
+
+        if (std::memcmp(chunk, "fmt ", 4) == 0 && chunk_size >= 16 && body + 16 <= map_size_) {
+            audio_format    = read_u16(map_ + body);
+            channels_       = read_u16(map_ + body + 2);
+            sample_rate_    = (int)read_u32(map_ + body + 4);
+            bits_per_sample = read_u16(map_ + body + 14);
+            // Extensible: the real format is the first two bytes of the
+            // SubFormat GUID; bits_per_sample stays the container size
+            if (audio_format == WAVE_FORMAT_EXTENSIBLE && chunk_size >= 40 && body + 40 <= map_size_) {
+                audio_format = read_u16(map_ + body + 24);
+            }
+            have_fmt = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            if (!have_fmt) {
+                LOGE("Invalid WAV file: data chunk before fmt chunk");
+                close();
+                return false;
+            }
+            // Streamed/truncated files may declare more data than they hold
+            size_t data_bytes = std::min(chunk_size, map_size_ - body);
+            data_ = map_ + body;
+            sample_bytes_ = bits_per_sample / 8;
+            frame_bytes_ = sample_bytes_ * (size_t)channels_;
+            total_frames_ = frame_bytes_ > 0 ? (int64_t)(data_bytes / frame_bytes_) : 0;
+            break;
+        }
+        pos = body + chunk_size + (chunk_size & 1);  // chunks are word-aligned
+    }
+
+    if (data_ == nullptr) {
+        LOGE("Invalid WAV file: no data chunk");
+        close();
+        return false;
+    }
+    sample_ = sample_decoder(audio_format, bits_per_sample);
+    if (sample_ == nullptr || channels_ < 1 || sample_rate_ <= 0) {
+        LOGE("Unsupported WAV format: format=%d bits=%d channels=%d rate=%d",
+             (int)audio_format, (int)bits_per_sample, channels_, sample_rate_);
+        close();
+        return false;
+    }
+
+    if (sample_rate_ != WHISPER_SAMPLE_RATE) {
+        resampler_ = std::make_unique<StreamingResampler>(sample_rate_, WHISPER_SAMPLE_RATE);
+    }
+
+    path_ = path;
+    pcm16_ = audio_format == WAVE_FORMAT_PCM && bits_per_sample == 16;
+    LOGD("WAV opened: %d Hz, %d channel(s), %d-bit %s, %lld frames",
+         sample_rate_, channels_, (int)bits_per_sample, audio_format == WAVE_FORMAT_PCM ? "PCM" : "float",
+         (long long)total_frames_);
+    return total_frames_ > 0;
+}
+
+bool WavReader::open_flac(const std::string &path, size_t offset) {
+    flac_ = std::make_unique<FlacDecoder>();
+    if (!flac_->open(map_ + offset, map_size_ - offset)) {
+        LOGE("Invalid FLAC file: missing or bad STREAMINFO");
+        close();
+        return false;
+    }
+    sample_rate_ = flac_->sample_rate();
+    channels_ = flac_->channels();
+    total_frames_ = flac_->total_frames();
+    if (sample_rate_ != WHISPER_SAMPLE_RATE) {
+        resampler_ = std::make_unique<StreamingResampler>(sample_rate_, WHISPER_SAMPLE_RATE);
+    }
+
+    path_ = path;
+    LOGD("FLAC opened: %d Hz, %d channel(s), %d-bit, %lld frames",
+         sample_rate_, channels_, flac_->bits_per_sample(), (long long)total_frames_);
+    return true;
+}
+
+void WavReader::close() {
+#ifdef _WIN32
+    if (map_ != nullptr) UnmapViewOfFile(map_);
+    if (mapping_handle_ != nullptr) CloseHandle((HANDLE)mapping_handle_);
+    if (file_handle_ != nullptr) CloseHandle((HANDLE)file_handle_);
+    file_handle_ = nullptr;
+    mapping_handle_ = nullptr;
+#else
+    if (map_ != nullptr) munmap(const_cast<uint8_t *>(map_), map_size_);
+#endif
+    map_ = nullptr;
+    map_size_ = 0;
+    path_.clear();
+    data_ = nullptr;
+    sample_rate_ = 0;
+    channels_ = 0;
+    channel_ = -1;
+    pcm16_ = false;
+    sample_bytes_ = 0;
+    frame_bytes_ = 0;
+    sample_ = nullptr;
+    total_frames_ = 0;
+    flac_.reset();
+    read_frame_ = 0;
+    resampler_.reset();
+    block_.clear();
+    resampled_.clear();
+    resampled_pos_ = 0;
+    flushed_ = false;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                           DECODING
+// ═══════════════════════════════════════════════════════════════
+
+void WavReader::rewind() {
+    read_frame_ = 0;
+    if (flac_) flac_->rewind();
+    if (resampler_) resampler_->reset();
+    resampled_.clear();
+    resampled_pos_ = 0;
+    flushed_ = false;
+}
+
+bool WavReader::select_channel(int channel) {
+    if (channel < -1 || channel >= channels_) return false;
+    channel_ = channel;
+    return true;
+}
+
+void WavReader::decode_frames(int64_t frame, size_t count, float *dst) const {
+    const uint8_t *p = data_ + (size_t)frame * frame_bytes_;
+    if (pcm16_) {
+        if (channels_ == 1) {
+            pcm16_to_float(reinterpret_cast<const int16_t *>(p), count, dst);
+        } else if (channel_ >= 0) {
+            pcm16_channel_to_float(reinterpret_cast<const int16_t *>(p), channels_, channel_, count, dst);
+        } else {
+            // Downmix to mono
+            const float scale = 1.0f / (32768.0f * (float)channels_);
+            for (size_t i = 0; i < count; i++) {
+                int32_t sum = 0;
+                for (int c = 0; c < channels_; c++, p += 2) {
+                    sum += (int16_t)read_u16(p);
+                }
+                dst[i] = (float)sum * scale;
+            }
+        }
+        return;
+    }
+
+    // Other encodings, sample by sample
+    if (channels_ == 1 || channel_ >= 0) {
+        p += (size_t)std::max(channel_, 0) * sample_bytes_;
+        for (size_t i = 0; i < count; i++, p += frame_bytes_) dst[i] = sample_(p);
+        return;
+    }
+    const float scale = 1.0f / (float)channels_;
+    for (size_t i = 0; i < count; i++) {
+        float sum = 0.0f;
+        for (int c = 0; c < channels_; c++, p += sample_bytes_) sum += sample_(p);
+        dst[i] = sum * scale;
+    }
+}
+
+size_t WavReader::decode_next(float *dst, size_t count) {
+    if (flac_) {
+        count = flac_->read(dst, count, channel_);
+    } else {
+        count = (size_t)std::min<int64_t>((int64_t)count, total_frames_ - read_frame_);
+        decode_frames(read_frame_, count, dst);
+    }
+    read_frame_ += (int64_t)count;
+    return count;
+}
+
+size_t WavReader::read_16k(float *dst, size_t max_samples) {
+    if (data_ == nullptr && !flac_) return 0;
+
+    if (sample_rate_ == WHISPER_SAMPLE_RATE) return decode_next(dst, max_samples);
+
+    // Decode a block, resample it, hand out the result; repeat.
+    size_t produced = 0;
+    while (produced < max_samples) {
+        if (resampled_pos_ == resampled_.size()) {
+            resampled_.clear();
+            resampled_pos_ = 0;
+            block_.resize(BLOCK_FRAMES);
+            size_t count = flushed_ ? 0 : decode_next(block_.data(), BLOCK_FRAMES);
+            if (count > 0) {
+                resampler_->process(block_.data(), count, resampled_);
+            } else if (!flushed_) {
+                resampler_->flush(resampled_);
+                flushed_ = true;
+            } else {
+                break;
+            }
+            continue;
+        }
+        size_t n = std::min(max_samples - produced, resampled_.size() - resampled_pos_);
+        std::memcpy(dst + produced, resampled_.data() + resampled_pos_, n * sizeof(float));
+        resampled_pos_ += n;
+        produced += n;
+    }
+    return produced;
+}
@@ -0,0 +1,104 @@
+/**
+ * wav_reader.h - Memory-mapped, streaming WAV / FLAC reader
+ *
+ * The file is mapped rather than read, so opening an hour-long recording
+ * costs nothing up front and the OS pages data in as it is consumed.
+ * Samples are decoded (and downmixed / resampled to 16 kHz mono) in small
+ * blocks into caller-provided buffers: peak memory is independent of file
+ * length.
+ *
+ * Integer PCM of 8, 16, 24 and 32 bits and 32/64-bit float are read, in
+ * plain or WAVE_FORMAT_EXTENSIBLE headers. Instead of the downmix, one
+ * channel can be selected, so each speaker of a multi-channel recording is
+ * transcribed on its own.
+ *
+ * FLAC files (detected by their "fLaC" marker, after an optional ID3 tag)
+ * go through the same interface: flac_decoder.h decodes the mapped stream
+ * frame by frame into the same block / resample path, with no temporary
+ * WAV. MP3 and Ogg are recognised and refused with a clear error.
+ */
+
+#ifndef WAV_READER_H
+#define WAV_READER_H
+
+#include "flac_decoder.h"
+#include "resampler.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class WavReader {
+public:
+    WavReader() = default;
+    ~WavReader();
+
+    WavReader(const WavReader &) = delete;
+    WavReader &operator=(const WavReader &) = delete;
+
+    // Maps the file and parses its header (WAV or FLAC, by content).
+    bool open(const std::string &path);
+    void close();
+
+    // -1 (the default after open) downmixes every channel; 0..channels()-1
+    // reads that channel alone. Applies from the next read; false if out of
+    // range.
+    bool select_channel(int channel);
+
+    const std::string &path() const { return path_; }
+    int sample_rate() const { return sample_rate_; }
+    int channels() const { return channels_; }
+    // 0 for a FLAC file whose encoder did not record its length.
+    int64_t total_frames() const { return total_frames_; }
+    int64_t duration_ms() const {
+        return sample_rate_ > 0 ? total_frames_ * 1000 / sample_rate_ : 0;
+    }
+
+    // Decodes up to `max_samples` of 16 kHz mono audio into `dst`.
+    // Returns the number written; 0 once the audio is exhausted.
+    size_t read_16k(float *dst, size_t max_samples);
+
+    // Restarts decoding from the first sample (no re-parse, no re-map).
+    void rewind();
+
+private:
+    // One sample of the file's encoding, as float in [-1, 1].
+    using SampleFn = float (*)(const uint8_t *p);
+
+    bool open_flac(const std::string &path, size_t offset);
+
+    // Decodes `count` mono frames starting at `frame` (no bounds check).
+    void decode_frames(int64_t frame, size_t count, float *dst) const;
+    // Up to `count` mono frames from the read position, WAV or FLAC.
+    size_t decode_next(float *dst, size_t count);
+
+    const uint8_t *map_ = nullptr;
+    size_t map_size_ = 0;
+#ifdef _WIN32
+    void *file_handle_ = nullptr;
+    void *mapping_handle_ = nullptr;
+#endif
+
+    std::string path_;
+    const uint8_t *data_ = nullptr;   // first byte of the data chunk
+    int sample_rate_ = 0;
+    int channels_ = 0;
+    int channel_ = -1;                // see select_channel()
+    bool pcm16_ = false;              // 16-bit PCM: the vectorised paths
+    size_t sample_bytes_ = 0;
+    size_t frame_bytes_ = 0;
+    SampleFn sample_ = nullptr;
+    int64_t total_frames_ = 0;
+    std::unique_ptr<FlacDecoder> flac_;  // set for FLAC files; data_ is then unused
+
+    int64_t read_frame_ = 0;          // next source frame to decode
+    std::unique_ptr<StreamingResampler> resampler_;
+    std::vector<float> block_;        // decoded source frames
+    std::vector<float> resampled_;    // 16 kHz output not yet handed out
+    size_t resampled_pos_ = 0;
+    bool flushed_ = false;
+};
+
+#endif // WAV_READER_H
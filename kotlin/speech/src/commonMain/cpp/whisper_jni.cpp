@@ -5,49 +5,81 @@
  */
 
 #include "speech_jni.h"
+#include "jni_cache.h"
+#include "pcm.h"
+#include "stt_abort.h"
+#include "stt_batch.h"
+#include "stt_buckets.h"
+#include "stt_cache.h"
+#include "stt_commands.h"
+#include "stt_common.h"
+#include "stt_file.h"
+#include "stt_handles.h"
+#include "stt_jobs.h"
+#include "stt_lang.h"
+#include "stt_listener.h"
+#include "stt_models.h"
+#include "stt_options.h"
+#include "stt_repeat.h"
+#include "stt_session.h"
+#include "stt_tasks.h"
+#include "vad.h"
+#include "whisper_state_pool.h"
 #include "whisper.h"
 
 #include <string>
 #include <vector>
 #include <algorithm>
 #include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <cmath>
+#include <cstdint>
 #include <cstring>
-#include <fstream>
 #include <sstream>
-#include <chrono>
-
-// Convenience: milliseconds since an arbitrary epoch (for latency spans)
-static inline long now_ms() {
-    using namespace std::chrono;
-    return (long)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
-}
-
-// ═══════════════════════════════════════════════════════════════
-//                     PLATFORM-SPECIFIC LOGGING
-// ═══════════════════════════════════════════════════════════════
-
-#ifdef __ANDROID__
-#include <android/log.h>
-#define LOG_TAG "SpeechKMP-STT"
-#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
-#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
-#define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, __VA_ARGS__)
-#else
-#include <cstdio>
-#define LOGI(...) fprintf(stdout, "[SpeechKMP-STT INFO] " __VA_ARGS__); fprintf(stdout, "\n")
-#define LOGE(...) fprintf(stderr, "[SpeechKMP-STT ERROR] " __VA_ARGS__); fprintf(stderr, "\n")
-#define LOGD(...) fprintf(stdout, "[SpeechKMP-STT DEBUG] " __VA_ARGS__); fprintf(stdout, "\n")
-#endif
 
 // ═══════════════════════════════════════════════════════════════
 //                          GLOBAL STATE
 // ═══════════════════════════════════════════════════════════════
 
-static struct whisper_context *g_ctx = nullptr;
 static struct whisper_full_params g_params;
-static std::mutex g_mutex;
-static std::atomic<bool> g_cancel_requested{false};
+static SttCancelEpoch g_cancel;  // see SttAbort; requests never reset it
+
+// Resident models, each a context with its own state pool. Requests hold
+// their model (SttModelRef) while they run, so background loads, swaps of
+// the active model and evictions never block or invalidate them.
+static std::unique_ptr<SttModelRegistry> g_models;
+
+// Guards the lifetime of g_models: transcriptions hold it shared, init and
+// shutdown hold it exclusively. Concurrency between transcriptions comes
+// from leasing states out of the model pools, not from this lock.
+static std::shared_mutex g_mutex;
+
+// Bumped on every init / shutdown, so open streaming sessions can detect
+// that the engine they were opened on is gone.
+static std::atomic<uint64_t> g_ctx_generation{0};
+
+// Workers for the submit* API; one per pooled state.
+static std::unique_ptr<SttJobQueue> g_jobs;
+
+// Optional cache of transcribeAudio results, keyed by a fingerprint of the
+// post-VAD audio and cache_config() of the request. Saved to its file (if
+// any) whenever the engine is released.
+static std::unique_ptr<SttResultCache> g_result_cache;
+
+// Logits filter that ends decoder repetition loops; installed into g_params
+// (and so every request's params) when enabled at init. Never destroyed, so
+// params copied before a re-init still point at a live guard.
+static SttRepeatGuard g_repeat_guard;
+
+// Command phrases given at init, and their grammar compiled per model path
+// (token ids depend on the model's vocabulary) on first use.
+static std::vector<std::string> g_commands;
+static std::map<std::string, std::shared_ptr<const SttCommandGrammar>> g_command_grammars;
+static std::mutex g_command_mutex;
 
 // Configuration
 static std::string g_language = "en";
@@ -57,6 +89,11 @@ static std::atomic<bool> g_use_gpu{true};
 static std::atomic<bool> g_use_vad{true};
 static std::atomic<bool> g_single_segment{true};
 static std::atomic<bool> g_no_context{true};
+static std::atomic<int> g_pool_size{1};
+static std::atomic<int> g_threads_per_state{4};
+static std::atomic<bool> g_persistent_state{false};
+static std::atomic<bool> g_long_form{false};
+static std::atomic<bool> g_pin_language{false};
 
 // ═══════════════════════════════════════════════════════════════
 //                      HELPER FUNCTIONS
@@ -70,100 +107,131 @@ static std::string jstring_to_string(JNIEnv *env, jstring jstr) {
     return result;
 }
 
-static bool read_wav_file(const std::string &path, std::vector<float> &samples, int &sample_rate) {
-    std::ifstream file(path, std::ios::binary);
-    if (!file.is_open()) {
-        LOGE("Failed to open WAV file: %s", path.c_str());
-        return false;
+// A null array gives an empty vector.
+static std::vector<std::string> jstring_array_to_vector(JNIEnv *env, jobjectArray array) {
+    std::vector<std::string> result;
+    if (array == nullptr) return result;
+    jsize n = env->GetArrayLength(array);
+    for (jsize i = 0; i < n; i++) {
+        auto jStr = (jstring)env->GetObjectArrayElement(array, i);
+        result.push_back(jstring_to_string(env, jStr));
+        env->DeleteLocalRef(jStr);
     }
+    return result;
+}
 
-    // Read WAV header
-    char riff[4];
-    file.read(riff, 4);
-    if (std::strncmp(riff, "RIFF", 4) != 0) {
-        LOGE("Invalid WAV file: missing RIFF header");
-        return false;
+// Global ref held by native work that outlives the JNI call (background
+// loads, queued jobs). Released on whichever thread drops the last copy.
+class JniGlobalRef {
+public:
+    JniGlobalRef(JNIEnv *env, jobject obj) : obj_(env->NewGlobalRef(obj)) {}
+    ~JniGlobalRef() {
+        JNIEnv *env = jni_attach_current_thread();
+        if (env != nullptr) env->DeleteGlobalRef(obj_);
     }
 
-    file.seekg(4, std::ios::cur); // Skip file size
+    JniGlobalRef(const JniGlobalRef &) = delete;
+    JniGlobalRef &operator=(const JniGlobalRef &) = delete;
 
-    char wave[4];
-    file.read(wave, 4);
-    if (std::strncmp(wave, "WAVE", 4) != 0) {
-        LOGE("Invalid WAV file: missing WAVE header");
-        return false;
-    }
+    jobject get() const { return obj_; }
 
-    // Find fmt chunk
-    while (file.good()) {
-        char chunk_id[4];
-        file.read(chunk_id, 4);
+private:
+    jobject obj_;
+};
 
-        uint32_t chunk_size;
-        file.read(reinterpret_cast<char*>(&chunk_size), 4);
+// Per-call overrides from the Kotlin SttOptions (model / language may be null).
+static SttOptions read_options(JNIEnv *env, jstring model, jstring language, jint flags, jlong timeoutMs) {
+    SttOptions options = SttOptions::from_packed(jstring_to_string(env, language).c_str(), (int)flags);
+    options.model = jstring_to_string(env, model);
+    options.timeout_ms = (int64_t)timeoutMs;
+    return options;
+}
 
-        if (std::strncmp(chunk_id, "fmt ", 4) == 0) {
-            uint16_t audio_format;
-            file.read(reinterpret_cast<char*>(&audio_format), 2);
+// The model a request runs on: the active one, or options.model (loaded on
+// demand). nullptr if STT is not initialized or the model failed to load.
+// Caller must hold g_mutex.
+static SttModelRef request_model(const SttOptions &options) {
+    return g_models ? g_models->get(options.model) : nullptr;
+}
 
-            uint16_t num_channels;
-            file.read(reinterpret_cast<char*>(&num_channels), 2);
+// Everything besides the audio that decides what a decode produces.
+static std::string cache_config(const SttModel &model, const struct whisper_full_params &params) {
+    return model.path + "|" + params.language + "|" + (params.translate ? "1" : "0") + "|" +
+           (params.single_segment ? "1" : "0") + "|" + (params.no_context ? "1" : "0");
+}
 
-            uint32_t sr;
-            file.read(reinterpret_cast<char*>(&sr), 4);
-            sample_rate = sr;
+// What release_engine_locked() hands back. Destroyed after g_mutex is
+// released: that waits for running jobs and background loads, whose
+// callbacks may call back into the bridge.
+struct RetiredEngine {
+    std::unique_ptr<SttModelRegistry> models;
+    std::unique_ptr<SttJobQueue> jobs;  // stopped first: jobs use the models
+};
 
-            file.seekg(chunk_size - 8, std::ios::cur);
-        } else if (std::strncmp(chunk_id, "data", 4) == 0) {
-            // Read audio data
-            std::vector<int16_t> pcm(chunk_size / 2);
-            file.read(reinterpret_cast<char*>(pcm.data()), chunk_size);
+// Caller must hold g_mutex exclusively.
+static void release_engine_locked(RetiredEngine &retired) {
+    retired.models = std::move(g_models);
+    retired.jobs = std::move(g_jobs);
+    g_ctx_generation++;
+    g_command_grammars.clear();
 
-            // Convert to float
-            samples.resize(pcm.size());
-            for (size_t i = 0; i < pcm.size(); i++) {
-                samples[i] = static_cast<float>(pcm[i]) / 32768.0f;
-            }
-            break;
-        } else {
-            file.seekg(chunk_size, std::ios::cur);
-        }
+    if (g_result_cache) {
+        g_result_cache->save();
+        g_result_cache.reset();
     }
-
-    return !samples.empty();
 }
 
-static bool resample_to_16k(const std::vector<float> &input, int input_rate, std::vector<float> &output) {
-    if (input_rate == WHISPER_SAMPLE_RATE) {
-        output = input;
-        return true;
+// Transcribes a mapped WAV file: sequentially on one leased state, split
+// across the whole pool in long-form mode, or one channel per pooled state
+// with `split_channels`. Once `abort` fires, the text so far is returned as
+// a partial result. Caller must hold g_mutex.
+static bool transcribe_wav_file(const SttModel &model, WavReader &reader,
+                                const struct whisper_full_params &request_params, bool split_channels,
+                                const SttAbort *abort, SttResult &result) {
+    // Language pre-pass: identify the language once from the opening seconds
+    // and pin it, so windows neither re-detect it nor disagree about it.
+    struct whisper_full_params params = request_params;
+    result.language = params.language;
+    std::string language;
+    if (g_pin_language && stt_language_is_auto(params.language)) {
+        WhisperStatePool::Lease lid = model.pool->acquire();
+        if (lid) language = stt_detect_wav_language(model.ctx, lid.state(), reader, g_use_vad, params.n_threads, abort);
+        if (!language.empty()) {
+            params.language = language.c_str();
+            result.language = language;
+        }
     }
 
-    // Simple linear interpolation resampling
-    double ratio = static_cast<double>(WHISPER_SAMPLE_RATE) / input_rate;
-    size_t output_size = static_cast<size_t>(input.size() * ratio);
-    output.resize(output_size);
+    if (split_channels && reader.channels() > 1) {
+        return stt_transcribe_wav_channels(model.ctx, *model.pool, params, reader, g_use_vad, result, abort);
+    }
+    if (g_long_form && model.pool->size() > 1) {
+        return stt_transcribe_wav_parallel(model.ctx, *model.pool, params, reader, g_use_vad, result, abort);
+    }
+    WhisperStatePool::Lease lease = model.pool->acquire();
+    return lease && stt_transcribe_wav(model.ctx, lease.state(), params, reader, g_use_vad, result, abort);
+}
 
-    for (size_t i = 0; i < output_size; i++) {
-        double src_idx = i / ratio;
-        size_t idx0 = static_cast<size_t>(src_idx);
-        size_t idx1 = std::min(idx0 + 1, input.size() - 1);
-        double frac = src_idx - idx0;
-        output[i] = static_cast<float>(input[idx0] * (1.0 - frac) + input[idx1] * frac);
+static jobject new_transcription_result(JNIEnv *env, const SttResult &result) {
+    jobject segmentList = env->NewObject(g_jni.arrayList, g_jni.arrayListCtor);
+    for (const SttSegment &seg : result.segments) {
+        jstring jText = env->NewStringUTF(seg.text.c_str());
+        jobject segment = env->NewObject(g_jni.segment, g_jni.segmentCtor,
+            jText, (jlong)seg.t0_ms, (jlong)seg.t1_ms, (jint)seg.channel);
+        env->CallBooleanMethod(segmentList, g_jni.arrayListAdd, segment);
+        env->DeleteLocalRef(segment);
+        env->DeleteLocalRef(jText);
     }
 
-    return true;
+    return env->NewObject(g_jni.transcriptionResult, g_jni.transcriptionResultCtor,
+        env->NewStringUTF(result.text.c_str()),
+        segmentList,
+        env->NewStringUTF(result.language.c_str()),
+        (jlong)result.duration_ms,
+        (jboolean)result.partial,
+        result.error.empty() ? nullptr : env->NewStringUTF(result.error.c_str()));
 }
 
-// Callback for streaming transcription
-struct StreamCallbackData {
-    JNIEnv *env;
-    jobject callback;
-    jmethodID onPartialResult;
-    jmethodID onFinalResult;
-    jmethodID onError;
-};
-
 // ═══════════════════════════════════════════════════════════════
 //                        JNI FUNCTIONS
 // ═══════════════════════════════════════════════════════════════
@@ -178,15 +246,24 @@ Java_dev_deviceai_SpeechBridge_nativeInitStt(
     jboolean useGpu,
     jboolean useVad,
     jboolean singleSegment,
-    jboolean noContext) {
-
-    std::lock_guard<std::mutex> lock(g_mutex);
-
-    // Shutdown existing context if any
-    if (g_ctx != nullptr) {
-        whisper_free(g_ctx);
-        g_ctx = nullptr;
-    }
+    jboolean noContext,
+    jint statePoolSize,
+    jint threadsPerState,
+    jboolean persistentState,
+    jboolean longForm,
+    jboolean warmUp,
+    jboolean pinLanguage,
+    jlong resultCacheBytes,
+    jstring resultCachePath,
+    jlong modelBudgetBytes,
+    jboolean stopRepetitionLoops,
+    jobjectArray commands) {
+
+    RetiredEngine retired;  // destroyed after the lock is released
+    std::unique_lock<std::shared_mutex> lock(g_mutex);
+
+    // Shutdown existing models if any (waits for in-flight transcriptions)
+    release_engine_locked(retired);
 
     std::string path = jstring_to_string(env, modelPath);
     g_language = jstring_to_string(env, language);
@@ -196,27 +273,27 @@ Java_dev_deviceai_SpeechBridge_nativeInitStt(
     g_use_vad = useVad;
     g_single_segment = singleSegment;
     g_no_context = noContext;
+    g_pool_size = std::max(1, (int)statePoolSize);
+    g_threads_per_state = threadsPerState > 0
+        ? (int)threadsPerState
+        : std::max(1, (int)maxThreads / g_pool_size);
+    g_persistent_state = persistentState;
+    g_long_form = longForm;
+    g_pin_language = pinLanguage;
+    g_commands = jstring_array_to_vector(env, commands);
 
     LOGI("Initializing Whisper with model: %s", path.c_str());
     LOGI("Config: language=%s, translate=%d, threads=%d, gpu=%d, vad=%d",
          g_language.c_str(), (int)g_translate, (int)g_max_threads, (int)g_use_gpu, (int)g_use_vad);
-
-    // Initialize context parameters
-    struct whisper_context_params ctx_params = whisper_context_default_params();
-    ctx_params.use_gpu = g_use_gpu;
-
-    // Load model
-    g_ctx = whisper_init_from_file_with_params(path.c_str(), ctx_params);
-    if (g_ctx == nullptr) {
-        LOGE("Failed to initialize Whisper model");
-        return JNI_FALSE;
-    }
+    LOGI("State pool: %d state(s) x %d thread(s), persistent=%d, long_form=%d, warm_up=%d, pin_language=%d",
+         (int)g_pool_size, (int)g_threads_per_state, (int)g_persistent_state, (int)g_long_form,
+         (int)warmUp, (int)pinLanguage);
 
     // Setup default full params
     g_params = whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
     g_params.language = g_language.c_str();
     g_params.translate = g_translate;
-    g_params.n_threads = g_max_threads;
+    g_params.n_threads = g_threads_per_state;
     g_params.no_timestamps = false;
     g_params.print_special = false;
     g_params.print_progress = false;
@@ -225,6 +302,42 @@ Java_dev_deviceai_SpeechBridge_nativeInitStt(
     g_params.single_segment   = g_single_segment;
     g_params.no_context       = g_no_context;
 
+    // Every model gets a state pool shaped by this config. No default state:
+    // transcriptions run on pooled (or per-call) states, so a context only
+    // holds the weights. Persistent mode pays for every state (KV caches,
+    // compute graphs) at load instead of on the first transcriptions;
+    // warm-up additionally runs each state once so the first request is not
+    // a cold start.
+    SttModelLoadConfig load_config;
+    load_config.ctx_params.use_gpu = g_use_gpu;
+    load_config.pool_size = g_pool_size;
+    load_config.preallocate = g_persistent_state;
+    load_config.warm_up = warmUp;
+    load_config.warm_up_params = g_params;
+    g_models = std::make_unique<SttModelRegistry>((size_t)std::max<jlong>(modelBudgetBytes, 0), load_config);
+
+    // After the warm-up copy, so warm-up decodes do not show in the stats
+    g_repeat_guard.reset_stats();
+    if (stopRepetitionLoops) g_repeat_guard.install(g_params);
+
+    long t_load = now_ms();
+    SttModelRef model = g_models->load(path);
+    if (!model) {
+        LOGE("Failed to initialize Whisper model");
+        g_models.reset();
+        return JNI_FALSE;
+    }
+    g_models->set_active(model);
+    LOGI("[LATENCY] model load:       %ld ms  (incl. state prealloc / warm-up)", now_ms() - t_load);
+
+    g_jobs = std::make_unique<SttJobQueue>(g_pool_size);
+
+    if (resultCacheBytes > 0) {
+        g_result_cache = std::make_unique<SttResultCache>(
+            (size_t)resultCacheBytes, jstring_to_string(env, resultCachePath));
+        LOGI("Result cache: %lld bytes", (long long)resultCacheBytes);
+    }
+
     LOGI("Whisper model initialized successfully");
     return JNI_TRUE;
 }
@@ -232,49 +345,40 @@ Java_dev_deviceai_SpeechBridge_nativeInitStt(
 JNIEXPORT jstring JNICALL
 Java_dev_deviceai_SpeechBridge_nativeTranscribe(
     JNIEnv *env, jobject thiz,
-    jstring audioPath) {
+    jstring audioPath,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs) {
 
-    std::lock_guard<std::mutex> lock(g_mutex);
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
 
-    if (g_ctx == nullptr) {
+    SttOptions options = read_options(env, optModel, optLanguage, optFlags, optTimeoutMs);
+    SttModelRef model = request_model(options);
+    if (!model) {
         LOGE("Whisper not initialized");
         return env->NewStringUTF("");
     }
 
-    g_cancel_requested = false;
+    SttAbort abort(&g_cancel, options.timeout_ms);
 
     std::string path = jstring_to_string(env, audioPath);
     LOGD("Transcribing file: %s", path.c_str());
 
-    // Read WAV file
-    std::vector<float> samples;
-    int sample_rate;
-    if (!read_wav_file(path, samples, sample_rate)) {
-        return env->NewStringUTF("");
-    }
-
-    // Resample to 16kHz if needed
-    std::vector<float> samples_16k;
-    if (!resample_to_16k(samples, sample_rate, samples_16k)) {
-        LOGE("Failed to resample audio");
+    // Map the file; it is decoded window by window during inference
+    WavReader reader;
+    if (!reader.open(path)) {
         return env->NewStringUTF("");
     }
 
     // Run inference
-    if (whisper_full(g_ctx, g_params, samples_16k.data(), samples_16k.size()) != 0) {
+    SttResult transcript;
+    if (!transcribe_wav_file(*model, reader, options.apply(g_params), options.split_channels > 0, &abort,
+                             transcript)) {
         LOGE("Whisper inference failed");
         return env->NewStringUTF("");
     }
-
-    // Collect results
-    std::string result;
-    int n_segments = whisper_full_n_segments(g_ctx);
-    for (int i = 0; i < n_segments; i++) {
-        const char *text = whisper_full_get_segment_text(g_ctx, i);
-        if (text) {
-            result += text;
-        }
-    }
+    const std::string &result = transcript.text;
 
     LOGD("Transcription result: %s", result.c_str());
     return env->NewStringUTF(result.c_str());
@@ -283,208 +387,169 @@ Java_dev_deviceai_SpeechBridge_nativeTranscribe(
 JNIEXPORT jobject JNICALL
 Java_dev_deviceai_SpeechBridge_nativeTranscribeDetailed(
     JNIEnv *env, jobject thiz,
-    jstring audioPath) {
+    jstring audioPath,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs) {
 
-    std::lock_guard<std::mutex> lock(g_mutex);
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
 
-    // Get class references
-    jclass resultClass = env->FindClass("com/speechkmp/TranscriptionResult");
-    jclass segmentClass = env->FindClass("com/speechkmp/Segment");
-    jclass listClass = env->FindClass("java/util/ArrayList");
+    SttResult empty;
+    empty.language = "en";
 
-    if (g_ctx == nullptr) {
+    SttOptions options = read_options(env, optModel, optLanguage, optFlags, optTimeoutMs);
+    SttModelRef model = request_model(options);
+    if (!model) {
         LOGE("Whisper not initialized");
-        // Return empty result
-        jmethodID resultCtor = env->GetMethodID(resultClass, "<init>",
-            "(Ljava/lang/String;Ljava/util/List;Ljava/lang/String;J)V");
-        jmethodID listCtor = env->GetMethodID(listClass, "<init>", "()V");
-        jobject emptyList = env->NewObject(listClass, listCtor);
-        return env->NewObject(resultClass, resultCtor,
-            env->NewStringUTF(""), emptyList, env->NewStringUTF("en"), 0L);
+        return new_transcription_result(env, empty);
     }
 
-    g_cancel_requested = false;
+    SttAbort abort(&g_cancel, options.timeout_ms);
 
     std::string path = jstring_to_string(env, audioPath);
 
-    // Read WAV file
-    std::vector<float> samples;
-    int sample_rate;
-    if (!read_wav_file(path, samples, sample_rate)) {
-        jmethodID resultCtor = env->GetMethodID(resultClass, "<init>",
-            "(Ljava/lang/String;Ljava/util/List;Ljava/lang/String;J)V");
-        jmethodID listCtor = env->GetMethodID(listClass, "<init>", "()V");
-        jobject emptyList = env->NewObject(listClass, listCtor);
-        return env->NewObject(resultClass, resultCtor,
-            env->NewStringUTF(""), emptyList, env->NewStringUTF("en"), 0L);
+    // Map the file; it is decoded window by window during inference
+    WavReader reader;
+    if (!reader.open(path)) {
+        return new_transcription_result(env, empty);
     }
 
-    // Resample to 16kHz if needed
-    std::vector<float> samples_16k;
-    resample_to_16k(samples, sample_rate, samples_16k);
-
     // Run inference
-    if (whisper_full(g_ctx, g_params, samples_16k.data(), samples_16k.size()) != 0) {
+    SttResult transcript;
+    if (!transcribe_wav_file(*model, reader, options.apply(g_params), options.split_channels > 0, &abort,
+                             transcript)) {
         LOGE("Whisper inference failed");
-        jmethodID resultCtor = env->GetMethodID(resultClass, "<init>",
-            "(Ljava/lang/String;Ljava/util/List;Ljava/lang/String;J)V");
-        jmethodID listCtor = env->GetMethodID(listClass, "<init>", "()V");
-        jobject emptyList = env->NewObject(listClass, listCtor);
-        return env->NewObject(resultClass, resultCtor,
-            env->NewStringUTF(""), emptyList, env->NewStringUTF("en"), 0L);
+        return new_transcription_result(env, empty);
     }
 
-    // Build result
-    std::string fullText;
-    int n_segments = whisper_full_n_segments(g_ctx);
-
-    // Create ArrayList
-    jmethodID listCtor = env->GetMethodID(listClass, "<init>", "()V");
-    jmethodID listAdd = env->GetMethodID(listClass, "add", "(Ljava/lang/Object;)Z");
-    jobject segmentList = env->NewObject(listClass, listCtor);
-
-    // Create Segment constructor
-    jmethodID segmentCtor = env->GetMethodID(segmentClass, "<init>", "(Ljava/lang/String;JJ)V");
-
-    for (int i = 0; i < n_segments; i++) {
-        const char *text = whisper_full_get_segment_text(g_ctx, i);
-        int64_t t0 = whisper_full_get_segment_t0(g_ctx, i) * 10; // Convert to ms
-        int64_t t1 = whisper_full_get_segment_t1(g_ctx, i) * 10;
-
-        if (text) {
-            fullText += text;
-
-            // Create Segment object
-            jobject segment = env->NewObject(segmentClass, segmentCtor,
-                env->NewStringUTF(text), (jlong)t0, (jlong)t1);
-            env->CallBooleanMethod(segmentList, listAdd, segment);
-            env->DeleteLocalRef(segment);
-        }
-    }
-
-    // Calculate duration
-    jlong durationMs = samples_16k.size() * 1000 / WHISPER_SAMPLE_RATE;
-
-    // Create TranscriptionResult
-    jmethodID resultCtor = env->GetMethodID(resultClass, "<init>",
-        "(Ljava/lang/String;Ljava/util/List;Ljava/lang/String;J)V");
-
-    return env->NewObject(resultClass, resultCtor,
-        env->NewStringUTF(fullText.c_str()),
-        segmentList,
-        env->NewStringUTF(g_language.c_str()),
-        durationMs);
+    return new_transcription_result(env, transcript);
 }
 
-JNIEXPORT jstring JNICALL
-Java_dev_deviceai_SpeechBridge_nativeTranscribeAudio(
-    JNIEnv *env, jobject thiz,
-    jfloatArray samples) {
-
-    std::lock_guard<std::mutex> lock(g_mutex);
-
-    if (g_ctx == nullptr) {
-        LOGE("Whisper not initialized");
-        return env->NewStringUTF("");
-    }
-
-    g_cancel_requested = false;
-
-    long t_jni_start = now_ms();
-
-    // Get samples
-    jsize len = env->GetArrayLength(samples);
-    jfloat *data = env->GetFloatArrayElements(samples, nullptr);
-
-    // Copy to vector
-    std::vector<float> audio(data, data + len);
-    env->ReleaseFloatArrayElements(samples, data, 0);
-
-    long t_jni_copy_done = now_ms();
-    float audio_sec = (float)audio.size() / WHISPER_SAMPLE_RATE;
-    LOGI("[LATENCY] JNI array copy:   %ld ms  (%d samples = %.2f s of audio)",
-         t_jni_copy_done - t_jni_start, (int)audio.size(), audio_sec);
-
-    // ── VAD: trim leading/trailing silence ─────────────────────────
-    // Whisper loops on trailing silence, re-generating the same tokens.
-    // Energy-based VAD finds the actual speech region and crops to it,
-    // so Whisper only sees real speech content.
-    //
-    // Adaptive threshold: measure the noise floor of this specific recording
-    // (10th-percentile frame RMS) so the threshold automatically scales on
-    // noisy environments (emulators, cheap mics) without cutting real speech.
+// Shared tail of the transcribeAudio entry points and audio jobs. `audio` is
+// read in place (16 kHz mono float); `t_start` is when the request began.
+// `abort` stops the decode in progress; what was decoded by then is kept as
+// a partial result (never cached). Caller must hold g_mutex (shared).
+// Returns false on failure; no speech is an empty result.
+static bool transcribe_samples(const SttModel &model, const float *audio, size_t n_samples,
+                               const struct whisper_full_params &request_params, long t_start,
+                               const SttAbort *abort, SttResult &transcript) {
+    transcript = SttResult();
+    transcript.language = request_params.language;
+    transcript.duration_ms = (int64_t)n_samples * 1000 / WHISPER_SAMPLE_RATE;
+    float audio_sec = (float)n_samples / WHISPER_SAMPLE_RATE;
+    long t_vad_start = now_ms();
+
+    // ── VAD: cut silence ───────────────────────────────────────────
+    // Whisper loops on trailing silence, re-generating the same tokens, and
+    // long internal pauses still cost encoder time. The VAD finds every
+    // speech region (adaptive threshold over the recording's noise floor,
+    // with hysteresis and hangover) and packs them into one buffer, so
+    // Whisper only sees real speech content. A single region is decoded in
+    // place; only several regions are copied.
+    VadPacked packed;
     if (g_use_vad) {
-        const int FRAME = 480;   // 30 ms at 16 kHz
-        const int PAD   = 10;    // padding frames (~300 ms) around detected speech
-
-        int n_frames = (int)audio.size() / FRAME;
-
-        // Compute per-frame RMS
-        std::vector<float> frame_rms(n_frames);
-        for (int f = 0; f < n_frames; ++f) {
-            const float *p = audio.data() + f * FRAME;
-            float sum = 0.0f;
-            for (int i = 0; i < FRAME; ++i) sum += p[i] * p[i];
-            frame_rms[f] = std::sqrt(sum / FRAME);
-        }
-
-        // Noise floor = 10th-percentile RMS (quietest ~10% of frames)
-        std::vector<float> sorted_rms = frame_rms;
-        std::sort(sorted_rms.begin(), sorted_rms.end());
-        float noise_floor = sorted_rms[std::max(0, n_frames / 10)];
-
-        // Speech threshold: 4× above noise floor, minimum 0.02
-        float threshold = std::max(0.02f, noise_floor * 4.0f);
-        LOGI("[VAD] noise_floor=%.4f  threshold=%.4f", noise_floor, threshold);
-
-        int first_speech = -1, last_speech = -1;
-        for (int f = 0; f < n_frames; ++f) {
-            if (frame_rms[f] >= threshold) {
-                if (first_speech < 0) first_speech = f;
-                last_speech = f;
-            }
+        vad_pack(audio, n_samples, vad_detect(audio, n_samples), packed);
+        if (packed.empty()) {
+            LOGI("[VAD] no speech detected — skipping transcription");
+            return true;
         }
+        float packed_sec = (float)packed.n_samples() / WHISPER_SAMPLE_RATE;
+        LOGI("[VAD] %zu speech region(s)  packed %.2fs → %.2fs  (%ld ms)",
+             packed.pieces.size(), audio_sec, packed_sec, now_ms() - t_vad_start);
+        audio = packed.samples();
+        n_samples = packed.n_samples();
+    }
 
-        if (first_speech >= 0) {
-            int s = std::max(0,        first_speech - PAD) * FRAME;
-            int e = std::min(n_frames, last_speech  + PAD + 1) * FRAME;
-            float trimmed_sec = (float)(e - s) / WHISPER_SAMPLE_RATE;
-            LOGI("[VAD] speech frames %d–%d  trimmed %.2fs → %.2fs",
-                 first_speech, last_speech, audio_sec, trimmed_sec);
-            audio = std::vector<float>(audio.begin() + s, audio.begin() + e);
-        } else {
-            LOGI("[VAD] no speech detected — skipping transcription");
-            return env->NewStringUTF("");
+    // ── Result cache ───────────────────────────────────────────────
+    // Repeated inputs (the same prompt or announcement) are answered from
+    // memory. The fingerprint is taken after VAD, so leading/trailing
+    // silence does not change it.
+    uint64_t fingerprint = 0;
+    std::string config;
+    if (g_result_cache) {
+        long t_fp_start = now_ms();
+        fingerprint = stt_audio_fingerprint(audio, n_samples);
+        config = cache_config(model, request_params);
+        SttResult cached;
+        if (g_result_cache->lookup(fingerprint, config, cached)) {
+            // Times are cached in packed-audio time: remap them through this
+            // request's VAD. The duration stays this request's own.
+            transcript.text = std::move(cached.text);
+            transcript.segments = std::move(cached.segments);
+            transcript.language = std::move(cached.language);
+            if (g_use_vad) vad_remap(packed, transcript.segments);
+            LOGI("[CACHE] hit  %016llx  (%ld ms)", (unsigned long long)fingerprint, now_ms() - t_fp_start);
+            return true;
         }
     }
 
     // ── Whisper inference ──────────────────────────────────────────
-    // Auto-derive audio_ctx from actual sample count so the encoder's attention
-    // window matches the real audio length instead of always running over 30s.
-    // Formula: each whisper frame = 160 samples; encoder conv halves it → /320.
-    struct whisper_full_params params = g_params;
-    int auto_ctx = (static_cast<int>(audio.size()) + 319) / 320;
-    params.audio_ctx = std::min(auto_ctx, 1500);
-    audio_sec = (float)audio.size() / WHISPER_SAMPLE_RATE;
-    LOGI("[WHISPER-CFG] audio_ctx set to %d (%.2fs after VAD trim)",
+    // Size the encoder's attention window to the real audio length instead
+    // of always running over 30s, rounded up to a bucket (see stt_buckets.h)
+    // so each length does not get its own encoder graph.
+    struct whisper_full_params params = request_params;
+    params.audio_ctx = stt_bucket_audio_ctx(model.ctx, n_samples);
+    audio_sec = (float)n_samples / WHISPER_SAMPLE_RATE;
+    LOGI("[WHISPER-CFG] audio_ctx set to %d (%.2fs after VAD)",
          params.audio_ctx, audio_sec);
+    if (abort != nullptr) abort->install(params);
 
-    // ── Fresh state per call ───────────────────────────────────────
-    // whisper_full() writes into g_ctx's internal state and result_all buffer,
+    // ── Whisper state ──────────────────────────────────────────────
+    // whisper_full() writes into the context's internal state and result_all buffer,
     // which accumulates across calls and leaks into subsequent inferences even
-    // with no_context=true. A fresh whisper_state isolates every call completely.
-    struct whisper_state *state = whisper_init_state(g_ctx);
-    if (state == nullptr) {
-        LOGE("Failed to allocate whisper state");
-        return env->NewStringUTF("");
+    // with no_context=true. Every call therefore needs an isolated state:
+    //  - default: a fresh whisper_state per call. It is not leased from
+    //    the model's pool, so this path never waits for pooled calls.
+    //  - persistent: a preallocated pooled state, reset in place. The previous
+    //    call's results are cleared by whisper_full_with_state() and its
+    //    prompt history is dropped by reset_for_reuse(), so nothing leaks.
+    //    This call's own prompt is kept, as on a fresh state.
+    WhisperStatePool::Lease lease;
+    struct whisper_state *state = nullptr;
+    long t_state_start = now_ms();
+    if (g_persistent_state) {
+        lease = model.pool->acquire();
+        if (!lease) {
+            LOGE("Failed to acquire whisper state");
+            return false;
+        }
+        WhisperStatePool::reset_for_reuse(params);
+        state = lease.state();
+        LOGI("[LATENCY] state reset:      %ld ms  (pool slot %d)",
+             now_ms() - t_state_start, lease.slot());
+    } else {
+        state = whisper_init_state(model.ctx);
+        if (state == nullptr) {
+            LOGE("Failed to allocate whisper state");
+            return false;
+        }
+        LOGI("[LATENCY] state alloc:      %ld ms", now_ms() - t_state_start);
+    }
+
+    // Language pre-pass on the (VAD-packed) audio about to be decoded
+    std::string language;
+    if (g_pin_language && stt_language_is_auto(params.language)) {
+        std::vector<SttLanguageProb> languages;
+        if (stt_detect_language(model.ctx, state, audio, n_samples, false, params.n_threads, 1, abort, languages) &&
+            !languages.empty()) {
+            language = languages[0].language;
+            params.language = language.c_str();
+        }
     }
 
     long t_infer_start = now_ms();
 
-    if (whisper_full_with_state(g_ctx, state, params, audio.data(), (int)audio.size()) != 0) {
-        whisper_free_state(state);
+    if (whisper_full_with_state(model.ctx, state, params, audio, (int)n_samples) != 0 &&
+        (abort == nullptr || !abort->stop())) {
+        if (!lease) whisper_free_state(state);
         LOGE("Whisper inference failed");
-        return env->NewStringUTF("");
+        return false;
+    }
+    transcript.partial = abort != nullptr && abort->stop();
+    if (transcript.partial) {
+        LOGI("[ABORT] decode %s after %ld ms", abort->cancelled() ? "cancelled" : "timed out",
+             now_ms() - t_infer_start);
     }
 
     long t_infer_done = now_ms();
@@ -495,125 +560,258 @@ Java_dev_deviceai_SpeechBridge_nativeTranscribeAudio(
     LOGI("[WHISPER-CFG] n_threads=%d  single_segment=%d  no_context=%d  gpu=%d",
          (int)params.n_threads, (int)params.single_segment,
          (int)params.no_context, (int)g_use_gpu.load());
-    whisper_print_timings(g_ctx);
+    whisper_print_timings(model.ctx);
 
     // ── Collect text segments ──────────────────────────────────────
     long t_collect_start = now_ms();
 
-    std::string result;
     int n_segments = whisper_full_n_segments_from_state(state);
     for (int i = 0; i < n_segments; i++) {
         const char *text = whisper_full_get_segment_text_from_state(state, i);
         if (text) {
-            result += text;
+            transcript.text += text;
+            transcript.segments.push_back({text,
+                whisper_full_get_segment_t0_from_state(state, i) * 10,
+                whisper_full_get_segment_t1_from_state(state, i) * 10});
         }
     }
 
-    whisper_free_state(state);
+    if (lease) {
+        lease.release();
+    } else {
+        whisper_free_state(state);
+    }
 
     long t_collect_done = now_ms();
     LOGI("[LATENCY] collect segments: %ld ms  (%d segments)",
          t_collect_done - t_collect_start, n_segments);
     LOGI("[LATENCY] ── TOTAL C++ ──   %ld ms",
-         t_collect_done - t_jni_start);
+         t_collect_done - t_start);
 
-    return env->NewStringUTF(result.c_str());
+    transcript.language = params.language;
+    if (g_result_cache && !transcript.partial) g_result_cache->insert(fingerprint, config, transcript);
+    if (g_use_vad) vad_remap(packed, transcript.segments);
+    return true;
 }
 
-JNIEXPORT void JNICALL
-Java_dev_deviceai_SpeechBridge_nativeTranscribeStream(
+
+JNIEXPORT jstring JNICALL
+Java_dev_deviceai_SpeechBridge_nativeTranscribeAudio(
     JNIEnv *env, jobject thiz,
     jfloatArray samples,
-    jobject callback) {
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs) {
 
-    std::lock_guard<std::mutex> lock(g_mutex);
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
 
-    if (g_ctx == nullptr) {
-        // Call onError
-        jclass cbClass = env->GetObjectClass(callback);
-        jmethodID onError = env->GetMethodID(cbClass, "onError", "(Ljava/lang/String;)V");
-        env->CallVoidMethod(callback, onError, env->NewStringUTF("Whisper not initialized"));
-        return;
+    SttOptions options = read_options(env, optModel, optLanguage, optFlags, optTimeoutMs);
+    SttModelRef model = request_model(options);
+    if (!model) {
+        LOGE("Whisper not initialized");
+        return env->NewStringUTF("");
     }
 
-    g_cancel_requested = false;
+    SttAbort abort(&g_cancel, options.timeout_ms);
 
-    // Get callback methods
-    jclass cbClass = env->GetObjectClass(callback);
-    jmethodID onPartial = env->GetMethodID(cbClass, "onPartialResult", "(Ljava/lang/String;)V");
-    jmethodID onFinal = env->GetMethodID(cbClass, "onFinalResult", "(Lcom/speechkmp/TranscriptionResult;)V");
-    jmethodID onError = env->GetMethodID(cbClass, "onError", "(Ljava/lang/String;)V");
+    long t_jni_start = now_ms();
 
-    // Get samples
+    // Decode straight from the array elements (pinned, or the VM's one copy)
     jsize len = env->GetArrayLength(samples);
     jfloat *data = env->GetFloatArrayElements(samples, nullptr);
-    std::vector<float> audio(data, data + len);
-    env->ReleaseFloatArrayElements(samples, data, 0);
+    LOGI("[LATENCY] JNI array access: %ld ms  (%d samples = %.2f s of audio)",
+         now_ms() - t_jni_start, (int)len, (float)len / WHISPER_SAMPLE_RATE);
 
-    // Setup progress callback for partial results
-    struct whisper_full_params params = g_params;
+    SttResult result;
+    transcribe_samples(*model, data, (size_t)len, options.apply(g_params), t_jni_start, &abort, result);
+    env->ReleaseFloatArrayElements(samples, data, JNI_ABORT);
+    return env->NewStringUTF(result.text.c_str());
+}
 
-    // For now, we'll run full transcription and report result
-    // Real streaming would require VAD and chunked processing
+JNIEXPORT jstring JNICALL
+Java_dev_deviceai_SpeechBridge_nativeTranscribeAudioBuffer(
+    JNIEnv *env, jobject thiz,
+    jobject buffer,
+    jint byteOffset,
+    jint byteLength,
+    jboolean pcm16,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs) {
+
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    SttOptions options = read_options(env, optModel, optLanguage, optFlags, optTimeoutMs);
+    SttModelRef model = request_model(options);
+    if (!model) {
+        LOGE("Whisper not initialized");
+        return env->NewStringUTF("");
+    }
 
-    if (whisper_full(g_ctx, params, audio.data(), audio.size()) != 0) {
-        env->CallVoidMethod(callback, onError, env->NewStringUTF("Transcription failed"));
-        return;
+    // Only position..limit holds samples (the Kotlin side passes them)
+    auto *base = static_cast<const uint8_t *>(env->GetDirectBufferAddress(buffer));
+    jlong capacity = env->GetDirectBufferCapacity(buffer);
+    if (base == nullptr || capacity < 0) {
+        LOGE("transcribeAudio: not a direct buffer");
+        return env->NewStringUTF("");
+    }
+    if (byteOffset < 0 || byteLength < 0 || (jlong)byteOffset + byteLength > capacity) {
+        LOGE("transcribeAudio: range %d+%d outside the buffer's %lld bytes",
+             (int)byteOffset, (int)byteLength, (long long)capacity);
+        return env->NewStringUTF("");
+    }
+    const uint8_t *address = base + byteOffset;
+
+    SttAbort abort(&g_cancel, options.timeout_ms);
+
+    long t_jni_start = now_ms();
+
+    // float32 is read in place. int16 needs one conversion pass; so does
+    // float32 at an odd address (a slice of a byte buffer).
+    std::vector<float> converted;
+    const float *audio = nullptr;
+    size_t n_samples = 0;
+    if (pcm16) {
+        n_samples = (size_t)byteLength / sizeof(int16_t);
+        converted.resize(n_samples);
+        std::vector<int16_t> aligned;
+        auto *pcm = reinterpret_cast<const int16_t *>(address);
+        if (reinterpret_cast<uintptr_t>(address) % alignof(int16_t) != 0) {
+            aligned.resize(n_samples);
+            std::memcpy(aligned.data(), address, n_samples * sizeof(int16_t));
+            pcm = aligned.data();
+        }
+        pcm16_to_float(pcm, n_samples, converted.data());
+        audio = converted.data();
+    } else {
+        n_samples = (size_t)byteLength / sizeof(float);
+        audio = reinterpret_cast<const float *>(address);
+        if (reinterpret_cast<uintptr_t>(address) % alignof(float) != 0) {
+            converted.resize(n_samples);
+            std::memcpy(converted.data(), address, n_samples * sizeof(float));
+            audio = converted.data();
+        }
     }
+    LOGI("[LATENCY] JNI buffer access: %ld ms  (%zu %s samples = %.2f s of audio)",
+         now_ms() - t_jni_start, n_samples, pcm16 ? "int16" : "float32",
+         (float)n_samples / WHISPER_SAMPLE_RATE);
+
+    SttResult result;
+    transcribe_samples(*model, audio, n_samples, options.apply(g_params), t_jni_start, &abort, result);
+    return env->NewStringUTF(result.text.c_str());
+}
+
+JNIEXPORT void JNICALL
+Java_dev_deviceai_SpeechBridge_nativeTranscribeStream(
+    JNIEnv *env, jobject thiz,
+    jfloatArray samples,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs,
+    jobject callback) {
+
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
 
-    // Build result and call callbacks
-    std::string fullText;
-    int n_segments = whisper_full_n_segments(g_ctx);
+    SttOptions options = read_options(env, optModel, optLanguage, optFlags, optTimeoutMs);
+    SttModelRef model = request_model(options);
+    if (!model) {
+        env->CallVoidMethod(callback, g_jni.sttOnError, env->NewStringUTF("Whisper not initialized"));
+        return;
+    }
 
-    // Get class references for result
-    jclass resultClass = env->FindClass("com/speechkmp/TranscriptionResult");
-    jclass segmentClass = env->FindClass("com/speechkmp/Segment");
-    jclass listClass = env->FindClass("java/util/ArrayList");
+    SttAbort abort(&g_cancel, options.timeout_ms);
 
-    jmethodID listCtor = env->GetMethodID(listClass, "<init>", "()V");
-    jmethodID listAdd = env->GetMethodID(listClass, "add", "(Ljava/lang/Object;)Z");
-    jobject segmentList = env->NewObject(listClass, listCtor);
+    // Get samples
+    jsize len = env->GetArrayLength(samples);
+    jfloat *audio = env->GetFloatArrayElements(samples, nullptr);
+
+    // One pass over the whole array; segments are reported once it is done.
+    // Live audio goes through nativeSttSessionOpen/Push/Flush instead.
+    struct whisper_full_params params = options.apply(g_params);
+    params.audio_ctx = stt_bucket_audio_ctx(model->ctx, (size_t)len);
+    abort.install(params);
+
+    WhisperStatePool::Lease lease = model->pool->acquire();
+    bool ok = lease && (whisper_full_with_state(model->ctx, lease.state(), params, audio, len) == 0 ||
+                        abort.expired());
+    env->ReleaseFloatArrayElements(samples, audio, JNI_ABORT);
+    if (abort.cancelled()) {
+        env->CallVoidMethod(callback, g_jni.sttOnError, env->NewStringUTF("Cancelled"));
+        return;
+    }
+    if (!ok) {
+        env->CallVoidMethod(callback, g_jni.sttOnError, env->NewStringUTF("Transcription failed"));
+        return;
+    }
 
-    jmethodID segmentCtor = env->GetMethodID(segmentClass, "<init>", "(Ljava/lang/String;JJ)V");
+    SttResult result;
+    result.partial = abort.expired();
+    int n_segments = whisper_full_n_segments_from_state(lease.state());
 
     for (int i = 0; i < n_segments; i++) {
-        if (g_cancel_requested) {
-            env->CallVoidMethod(callback, onError, env->NewStringUTF("Cancelled"));
+        if (abort.cancelled()) {
+            env->CallVoidMethod(callback, g_jni.sttOnError, env->NewStringUTF("Cancelled"));
             return;
         }
 
-        const char *text = whisper_full_get_segment_text(g_ctx, i);
-        int64_t t0 = whisper_full_get_segment_t0(g_ctx, i) * 10;
-        int64_t t1 = whisper_full_get_segment_t1(g_ctx, i) * 10;
+        const char *text = whisper_full_get_segment_text_from_state(lease.state(), i);
+        int64_t t0 = whisper_full_get_segment_t0_from_state(lease.state(), i) * 10;
+        int64_t t1 = whisper_full_get_segment_t1_from_state(lease.state(), i) * 10;
 
         if (text) {
-            fullText += text;
+            result.text += text;
+            result.segments.push_back({text, t0, t1});
 
-            // Call partial result callback
-            env->CallVoidMethod(callback, onPartial, env->NewStringUTF(fullText.c_str()));
-
-            // Create Segment
-            jobject segment = env->NewObject(segmentClass, segmentCtor,
-                env->NewStringUTF(text), (jlong)t0, (jlong)t1);
-            env->CallBooleanMethod(segmentList, listAdd, segment);
-            env->DeleteLocalRef(segment);
+            // Text so far, one callback per decoded segment
+            jstring jPartial = env->NewStringUTF(result.text.c_str());
+            env->CallVoidMethod(callback, g_jni.sttOnPartialResult, jPartial);
+            env->DeleteLocalRef(jPartial);
         }
     }
 
-    // Calculate duration
-    jlong durationMs = audio.size() * 1000 / WHISPER_SAMPLE_RATE;
+    result.language = params.language;
+    result.duration_ms = (int64_t)len * 1000 / WHISPER_SAMPLE_RATE;
 
-    // Create final result
-    jmethodID resultCtor = env->GetMethodID(resultClass, "<init>",
-        "(Ljava/lang/String;Ljava/util/List;Ljava/lang/String;J)V");
+    env->CallVoidMethod(callback, g_jni.sttOnFinalResult, new_transcription_result(env, result));
+}
 
-    jobject result = env->NewObject(resultClass, resultCtor,
-        env->NewStringUTF(fullText.c_str()),
-        segmentList,
-        env->NewStringUTF(g_language.c_str()),
-        durationMs);
+JNIEXPORT jlongArray JNICALL
+Java_dev_deviceai_SpeechBridge_nativeGetSttCacheStats(
+    JNIEnv *env, jobject thiz) {
+
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    SttCacheStats stats;
+    if (g_result_cache) stats = g_result_cache->stats();
+    jlong values[5] = {stats.hits, stats.misses, stats.evictions, stats.entries, stats.bytes};
 
-    env->CallVoidMethod(callback, onFinal, result);
+    jlongArray array = env->NewLongArray(5);
+    env->SetLongArrayRegion(array, 0, 5, values);
+    return array;
+}
+
+JNIEXPORT jlongArray JNICALL
+Java_dev_deviceai_SpeechBridge_nativeGetSttLoopStats(
+    JNIEnv *env, jobject thiz) {
+
+    SttLoopStats stats = g_repeat_guard.stats();
+    jlong values[2] = {stats.decodes, stats.loops};
+
+    jlongArray array = env->NewLongArray(2);
+    env->SetLongArrayRegion(array, 0, 2, values);
+    return array;
+}
+
+JNIEXPORT void JNICALL
+Java_dev_deviceai_SpeechBridge_nativeClearSttCache(
+    JNIEnv *env, jobject thiz) {
+
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    if (g_result_cache) g_result_cache->clear();
 }
 
 JNIEXPORT void JNICALL
@@ -621,20 +819,768 @@ Java_dev_deviceai_SpeechBridge_nativeCancelStt(
     JNIEnv *env, jobject thiz) {
 
     LOGI("Cancel STT requested");
-    g_cancel_requested = true;
+    g_cancel.cancel();
+
+    // Every queued and running job too; see nativeCancelSttJob for one
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+    if (g_jobs) g_jobs->cancel_all();
 }
 
 JNIEXPORT void JNICALL
 Java_dev_deviceai_SpeechBridge_nativeShutdownStt(
     JNIEnv *env, jobject thiz) {
 
-    std::lock_guard<std::mutex> lock(g_mutex);
+    RetiredEngine retired;  // destroyed after the lock is released
+    std::unique_lock<std::shared_mutex> lock(g_mutex);
 
-    if (g_ctx != nullptr) {
+    if (g_models) {
         LOGI("Shutting down Whisper");
-        whisper_free(g_ctx);
-        g_ctx = nullptr;
     }
+    release_engine_locked(retired);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                    STREAMING SESSIONS
+// ═══════════════════════════════════════════════════════════════
+
+// Native side of a Kotlin SttSession, reached through g_sessions. The
+// SttStream callback is held as a global ref; callbacks fire on the thread
+// calling push/flush using that call's JNIEnv. The model stays alive while
+// the session is open, even if it is evicted or no longer the active one.
+struct JniSttSession {
+    SttModelRef model;
+    SttModelRef final_model;  // cascade only
+    std::unique_ptr<SttSession> session;
+    JniGlobalRef callback;
+    uint64_t generation;
+    SttCallGate gate;  // push/flush/stats one at a time; close waits for them
+
+    JniSttSession(JNIEnv *env, SttModelRef model, SttModelRef final_model, SttSession *session,
+                  jobject callback, uint64_t generation)
+        : model(std::move(model)), final_model(std::move(final_model)), session(session),
+          callback(env, callback), generation(generation) {}
+};
+
+static SttHandleTable<JniSttSession> g_sessions;
+
+// Nothing is reported once the session was closed (from its own callback).
+static SttSessionCallbacks jni_session_callbacks(JNIEnv *env, JniSttSession *s) {
+    SttSessionCallbacks cb;
+    cb.on_partial = [env, s](const std::string &text) {
+        if (s->gate.closed()) return;
+        jstring jText = env->NewStringUTF(text.c_str());
+        env->CallVoidMethod(s->callback.get(), g_jni.sttOnPartialResult, jText);
+        env->DeleteLocalRef(jText);
+    };
+    cb.on_final = [env, s](const SttResult &result) {
+        if (s->gate.closed()) return;
+        jobject jResult = new_transcription_result(env, result);
+        env->CallVoidMethod(s->callback.get(), g_jni.sttOnFinalResult, jResult);
+        env->DeleteLocalRef(jResult);
+    };
+    cb.on_error = [env, s](const std::string &message) {
+        if (s->gate.closed()) return;
+        jstring jMessage = env->NewStringUTF(message.c_str());
+        env->CallVoidMethod(s->callback.get(), g_jni.sttOnError, jMessage);
+        env->DeleteLocalRef(jMessage);
+    };
+    return cb;
+}
+
+// Caller must hold g_mutex. Reports through onError if the session's context is gone.
+static bool session_context_valid(JNIEnv *env, JniSttSession *s) {
+    if (g_models && s->generation == g_ctx_generation) return true;
+    env->CallVoidMethod(s->callback.get(), g_jni.sttOnError,
+        env->NewStringUTF("STT was re-initialized or shut down; open a new session"));
+    return false;
+}
+
+JNIEXPORT jlong JNICALL
+Java_dev_deviceai_SpeechBridge_nativeSttSessionOpen(
+    JNIEnv *env, jobject thiz,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jstring finalModel,
+    jobject callback) {
+
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    // No deadline: a session lives as long as the stream it is fed
+    SttOptions options = read_options(env, optModel, optLanguage, optFlags, 0);
+    SttModelRef model = request_model(options);
+    if (!model) {
+        LOGE("Whisper not initialized");
+        env->CallVoidMethod(callback, g_jni.sttOnError, env->NewStringUTF("Whisper not initialized"));
+        return 0;
+    }
+
+    SttModelRef final_model;
+    std::string final_path = jstring_to_string(env, finalModel);
+    if (!final_path.empty()) {
+        final_model = g_models->get(final_path);
+        if (!final_model) {
+            LOGE("[CASCADE] cannot load final model %s", final_path.c_str());
+            env->CallVoidMethod(callback, g_jni.sttOnError, env->NewStringUTF("Failed to load final model"));
+            return 0;
+        }
+    }
+
+    SttSessionConfig session_config;
+    session_config.pin_language = g_pin_language;
+    struct whisper_full_params params = options.apply(g_params);
+    auto *session = new SttSession(model->ctx, params, params.language, session_config);
+    if (!session->ok()) {
+        delete session;
+        env->CallVoidMethod(callback, g_jni.sttOnError, env->NewStringUTF("Failed to allocate whisper state"));
+        return 0;
+    }
+
+    if (final_model) session->set_final_model(final_model->ctx, final_model->pool.get());
+
+    int64_t handle = g_sessions.add(std::make_shared<JniSttSession>(
+        env, model, final_model, session, callback, g_ctx_generation.load()));
+    LOGI("[STREAM] session %lld opened%s", (long long)handle, final_model ? " with a final model" : "");
+    return (jlong)handle;
+}
+
+JNIEXPORT void JNICALL
+Java_dev_deviceai_SpeechBridge_nativeSttSessionPush(
+    JNIEnv *env, jobject thiz,
+    jlong handle,
+    jfloatArray samples) {
+
+    std::shared_ptr<JniSttSession> s = g_sessions.get(handle);
+    if (!s) return;
+    SttCallGate::Call call(s->gate);
+    if (!call) return;
+
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+    if (!session_context_valid(env, s.get())) return;
+
+    jsize len = env->GetArrayLength(samples);
+    jfloat *data = env->GetFloatArrayElements(samples, nullptr);
+    s->session->push(data, (int)len, jni_session_callbacks(env, s.get()));
+    env->ReleaseFloatArrayElements(samples, data, JNI_ABORT);
+}
+
+JNIEXPORT void JNICALL
+Java_dev_deviceai_SpeechBridge_nativeSttSessionFlush(
+    JNIEnv *env, jobject thiz,
+    jlong handle) {
+
+    std::shared_ptr<JniSttSession> s = g_sessions.get(handle);
+    if (!s) return;
+    SttCallGate::Call call(s->gate);
+    if (!call) return;
+
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+    if (!session_context_valid(env, s.get())) return;
+
+    s->session->flush(jni_session_callbacks(env, s.get()));
+}
+
+JNIEXPORT void JNICALL
+Java_dev_deviceai_SpeechBridge_nativeSttSessionClose(
+    JNIEnv *env, jobject thiz,
+    jlong handle) {
+
+    std::shared_ptr<JniSttSession> s = g_sessions.remove(handle);
+    if (!s) return;
+
+    // Waits for a push/flush on another thread; the session is freed with
+    // the last reference (here, or when a push this is called from returns)
+    s->gate.close();
+    LOGI("[STREAM] session %lld closed", (long long)handle);
+}
+
+JNIEXPORT jlongArray JNICALL
+Java_dev_deviceai_SpeechBridge_nativeSttSessionStats(
+    JNIEnv *env, jobject thiz,
+    jlong handle) {
+
+    jlong values[4] = {0, 0, 0, 0};
+    std::shared_ptr<JniSttSession> s = g_sessions.get(handle);
+    if (s) {
+        SttCallGate::Call call(s->gate);
+        if (call) {
+            const SttSessionStats &stats = s->session->stats();
+            values[0] = stats.partial_decodes;
+            values[1] = stats.partial_ms;
+            values[2] = stats.final_passes;
+            values[3] = stats.final_ms;
+        }
+    }
+
+    jlongArray array = env->NewLongArray(4);
+    env->SetLongArrayRegion(array, 0, 4, values);
+    return array;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                    ALWAYS-ON LISTENING
+// ═══════════════════════════════════════════════════════════════
+
+// Native side of a Kotlin SttListener, reached through g_listeners.
+// Utterances are decoded and reported on the listener thread, under g_mutex
+// (shared) for the decode only, so a callback may call back into the bridge.
+struct JniSttListener {
+    SttOptions options;
+    JniGlobalRef callback;
+    uint64_t generation;
+    std::atomic<bool> closing{false};
+    std::unique_ptr<SttListener> listener;
+
+    JniSttListener(JNIEnv *env, const SttOptions &options, jobject callback, uint64_t generation)
+        : options(options), callback(env, callback), generation(generation) {}
+};
+
+static SttHandleTable<JniSttListener> g_listeners;
+
+// Returns the error message, or "" on success.
+static std::string transcribe_utterance(JniSttListener *s, const std::vector<float> &audio, SttResult &result) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+    if (s->generation != g_ctx_generation) return "STT was re-initialized or shut down; start listening again";
+    SttModelRef model = request_model(s->options);
+    if (!model) return "Whisper not initialized";
+    SttAbort abort(&s->closing, &g_cancel, s->options.timeout_ms);  // per utterance
+    if (!transcribe_samples(*model, audio.data(), audio.size(), s->options.apply(g_params), now_ms(),
+                            &abort, result)) {
+        return "Transcription failed";
+    }
+    return "";
+}
+
+static SttListenerCallbacks jni_listener_callbacks(JniSttListener *s) {
+    SttListenerCallbacks cb;
+    cb.on_speech_start = [s](int64_t start_ms) {
+        JNIEnv *env = jni_attach_current_thread();
+        if (env == nullptr) return;
+        env->CallVoidMethod(s->callback.get(), g_jni.sttListenerOnSpeechStart, (jlong)start_ms);
+    };
+    cb.on_utterance = [s](std::vector<float> &&audio, int64_t start_ms) {
+        JNIEnv *env = jni_attach_current_thread();
+        if (env == nullptr) return;
+
+        SttResult result;
+        std::string error = transcribe_utterance(s, audio, result);
+        if (s->closing) return;
+        if (!error.empty()) {
+            jstring jMessage = env->NewStringUTF(error.c_str());
+            env->CallVoidMethod(s->callback.get(), g_jni.sttListenerOnError, jMessage);
+            env->DeleteLocalRef(jMessage);
+            return;
+        }
+        if (result.text.empty()) return;  // the endpointer's "speech" was noise
+
+        // Utterance-relative times to listener time
+        for (SttSegment &segment : result.segments) {
+            segment.t0_ms += start_ms;
+            segment.t1_ms += start_ms;
+        }
+        jobject jResult = new_transcription_result(env, result);
+        env->CallVoidMethod(s->callback.get(), g_jni.sttListenerOnUtterance, jResult);
+        env->DeleteLocalRef(jResult);
+    };
+    return cb;
+}
+
+JNIEXPORT jlong JNICALL
+Java_dev_deviceai_SpeechBridge_nativeListenerOpen(
+    JNIEnv *env, jobject thiz,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs,
+    jint preRollMs,
+    jint endSilenceMs,
+    jint minSpeechMs,
+    jint maxUtteranceMs,
+    jobject callback) {
+
+    SttOptions options = read_options(env, optModel, optLanguage, optFlags, optTimeoutMs);
+    uint64_t generation;
+    {
+        std::shared_lock<std::shared_mutex> lock(g_mutex);
+        if (!request_model(options)) {
+            LOGE("Whisper not initialized");
+            return 0;
+        }
+        generation = g_ctx_generation;
+    }
+
+    SttListenerConfig config;
+    config.pre_roll_ms = (int)preRollMs;
+    config.end_silence_ms = (int)endSilenceMs;
+    config.min_speech_ms = (int)minSpeechMs;
+    config.max_utterance_ms = (int)maxUtteranceMs;
+
+    auto s = std::make_shared<JniSttListener>(env, options, callback, generation);
+    s->listener.reset(new SttListener(config, jni_listener_callbacks(s.get())));
+    int64_t handle = g_listeners.add(std::move(s));
+    LOGI("[LISTEN] listener %lld opened", (long long)handle);
+    return (jlong)handle;
+}
+
+JNIEXPORT void JNICALL
+Java_dev_deviceai_SpeechBridge_nativeListenerPush(
+    JNIEnv *env, jobject thiz,
+    jlong handle,
+    jfloatArray samples) {
+
+    std::shared_ptr<JniSttListener> s = g_listeners.get(handle);
+    if (!s) return;
+
+    jsize len = env->GetArrayLength(samples);
+    jfloat *data = env->GetFloatArrayElements(samples, nullptr);
+    s->listener->push(data, (size_t)len);
+    env->ReleaseFloatArrayElements(samples, data, JNI_ABORT);
+}
+
+JNIEXPORT void JNICALL
+Java_dev_deviceai_SpeechBridge_nativeListenerClose(
+    JNIEnv *env, jobject thiz,
+    jlong handle) {
+
+    std::shared_ptr<JniSttListener> s = g_listeners.remove(handle);
+    if (!s) return;
+
+    // Not under g_mutex: the listener thread may be waiting for it. A push
+    // still running on the audio thread keeps the listener alive until it
+    // returns; the stopped listener just ignores its audio.
+    s->closing = true;
+    s->listener->stop();
+    LOGI("[LISTEN] listener %lld closed", (long long)handle);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                         BATCH
+// ═══════════════════════════════════════════════════════════════
+
+// `language` null: keep each result's own language.
+static jobjectArray new_transcription_result_array(JNIEnv *env, std::vector<SttResult> &results,
+                                                   const char *language) {
+    jobjectArray array = env->NewObjectArray((jsize)results.size(), g_jni.transcriptionResult, nullptr);
+    for (size_t i = 0; i < results.size(); i++) {
+        if (language != nullptr) results[i].language = language;
+        jobject jResult = new_transcription_result(env, results[i]);
+        env->SetObjectArrayElement(array, (jsize)i, jResult);
+        env->DeleteLocalRef(jResult);
+    }
+    return array;
+}
+
+JNIEXPORT jobjectArray JNICALL
+Java_dev_deviceai_SpeechBridge_nativeTranscribeBatch(
+    JNIEnv *env, jobject thiz,
+    jobjectArray clips,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs) {
+
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    jsize n_clips = env->GetArrayLength(clips);
+    std::vector<SttResult> results((size_t)n_clips);
+    SttOptions options = read_options(env, optModel, optLanguage, optFlags, optTimeoutMs);
+    SttModelRef model = request_model(options);
+    if (!model) {
+        LOGE("Whisper not initialized");
+        return new_transcription_result_array(env, results, "en");
+    }
+
+    SttAbort abort(&g_cancel, options.timeout_ms);
+
+    // Copy out of the Java arrays up front: decoding runs on pool threads
+    std::vector<std::vector<float>> audio((size_t)n_clips);
+    std::vector<SttClip> views((size_t)n_clips);
+    for (jsize i = 0; i < n_clips; i++) {
+        auto clip = (jfloatArray)env->GetObjectArrayElement(clips, i);
+        if (clip == nullptr) continue;
+        jsize len = env->GetArrayLength(clip);
+        audio[i].resize((size_t)len);
+        env->GetFloatArrayRegion(clip, 0, len, audio[i].data());
+        env->DeleteLocalRef(clip);
+        views[i] = {audio[i].data(), audio[i].size()};
+    }
+
+    struct whisper_full_params params = options.apply(g_params);
+    results = stt_transcribe_batch(model->ctx, *model->pool, params, views, g_use_vad, &abort);
+    return new_transcription_result_array(env, results, params.language);
+}
+
+JNIEXPORT jobjectArray JNICALL
+Java_dev_deviceai_SpeechBridge_nativeTranscribeBatchFiles(
+    JNIEnv *env, jobject thiz,
+    jobjectArray audioPaths,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs) {
+
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    jsize n_paths = env->GetArrayLength(audioPaths);
+    std::vector<SttResult> results((size_t)n_paths);
+    SttOptions options = read_options(env, optModel, optLanguage, optFlags, optTimeoutMs);
+    SttModelRef model = request_model(options);
+    if (!model) {
+        LOGE("Whisper not initialized");
+        return new_transcription_result_array(env, results, "en");
+    }
+
+    SttAbort abort(&g_cancel, options.timeout_ms);
+
+    std::vector<std::string> paths((size_t)n_paths);
+    for (jsize i = 0; i < n_paths; i++) {
+        auto jPath = (jstring)env->GetObjectArrayElement(audioPaths, i);
+        paths[i] = jstring_to_string(env, jPath);
+        env->DeleteLocalRef(jPath);
+    }
+
+    struct whisper_full_params params = options.apply(g_params);
+    results = stt_transcribe_batch_files(model->ctx, *model->pool, params, paths, g_use_vad, &abort);
+    return new_transcription_result_array(env, results, params.language);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                ENCODE ONCE, DECODE MANY
+// ═══════════════════════════════════════════════════════════════
+
+JNIEXPORT jobjectArray JNICALL
+Java_dev_deviceai_SpeechBridge_nativeTranscribeAudioTasks(
+    JNIEnv *env, jobject thiz,
+    jfloatArray samples,
+    jobjectArray taskLanguages,
+    jintArray taskTranslate,
+    jobjectArray taskPrompts,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs) {
+
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    // Per task: language (null = options), translate (-1 = options, 0, 1), prompt (null = none)
+    jsize n_tasks = env->GetArrayLength(taskTranslate);
+    std::vector<SttTask> tasks((size_t)n_tasks);
+    std::vector<jint> translate((size_t)n_tasks);
+    env->GetIntArrayRegion(taskTranslate, 0, n_tasks, translate.data());
+    for (jsize i = 0; i < n_tasks; i++) {
+        auto jLanguage = (jstring)env->GetObjectArrayElement(taskLanguages, i);
+        auto jPrompt = (jstring)env->GetObjectArrayElement(taskPrompts, i);
+        tasks[i].language = jstring_to_string(env, jLanguage);
+        tasks[i].translate = (int)translate[i];
+        tasks[i].prompt = jstring_to_string(env, jPrompt);
+        env->DeleteLocalRef(jLanguage);
+        env->DeleteLocalRef(jPrompt);
+    }
+
+    std::vector<SttResult> results((size_t)n_tasks);
+    SttOptions options = read_options(env, optModel, optLanguage, optFlags, optTimeoutMs);
+    SttModelRef model = request_model(options);
+    if (!model) {
+        LOGE("Whisper not initialized");
+        return new_transcription_result_array(env, results, "en");
+    }
+
+    SttAbort abort(&g_cancel, options.timeout_ms);
+
+    jsize len = env->GetArrayLength(samples);
+    jfloat *audio = env->GetFloatArrayElements(samples, nullptr);
+    struct whisper_full_params params = options.apply(g_params);
+    WhisperStatePool::Lease lease = model->pool->acquire();
+    bool ok = lease && stt_transcribe_tasks(model->ctx, lease.state(), params, audio, (size_t)len,
+                                            g_use_vad, tasks, results, &abort);
+    env->ReleaseFloatArrayElements(samples, audio, JNI_ABORT);
+    if (!ok) {
+        LOGE("[TASKS] transcription failed");
+        results.assign((size_t)n_tasks, SttResult());
+        return new_transcription_result_array(env, results, params.language);
+    }
+    return new_transcription_result_array(env, results, nullptr);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                  LANGUAGE IDENTIFICATION
+// ═══════════════════════════════════════════════════════════════
+
+JNIEXPORT jobjectArray JNICALL
+Java_dev_deviceai_SpeechBridge_nativeDetectLanguage(
+    JNIEnv *env, jobject thiz,
+    jfloatArray samples,
+    jint topN,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs) {
+
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    SttOptions options = read_options(env, optModel, optLanguage, optFlags, optTimeoutMs);
+    SttModelRef model = request_model(options);
+    std::vector<SttLanguageProb> languages;
+    if (!model) {
+        LOGE("Whisper not initialized");
+    } else {
+        SttAbort abort(&g_cancel, options.timeout_ms);
+        struct whisper_full_params params = options.apply(g_params);
+        jsize len = env->GetArrayLength(samples);
+        jfloat *audio = env->GetFloatArrayElements(samples, nullptr);
+        WhisperStatePool::Lease lease = model->pool->acquire();
+        if (lease) {
+            stt_detect_language(model->ctx, lease.state(), audio, (size_t)len, g_use_vad,
+                                params.n_threads, (int)topN, &abort, languages);
+        }
+        env->ReleaseFloatArrayElements(samples, audio, JNI_ABORT);
+    }
+
+    jobjectArray array = env->NewObjectArray((jsize)languages.size(), g_jni.languageProbability, nullptr);
+    for (size_t i = 0; i < languages.size(); i++) {
+        jstring jLanguage = env->NewStringUTF(languages[i].language.c_str());
+        jobject jProb = env->NewObject(g_jni.languageProbability, g_jni.languageProbabilityCtor,
+            jLanguage, (jfloat)languages[i].probability);
+        env->SetObjectArrayElement(array, (jsize)i, jProb);
+        env->DeleteLocalRef(jProb);
+        env->DeleteLocalRef(jLanguage);
+    }
+    return array;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                      VOICE COMMANDS
+// ═══════════════════════════════════════════════════════════════
+
+// Grammar of the init commands for `model`. Caller must hold g_mutex.
+static std::shared_ptr<const SttCommandGrammar> init_command_grammar(const SttModel &model) {
+    std::lock_guard<std::mutex> lock(g_command_mutex);
+    std::shared_ptr<const SttCommandGrammar> &grammar = g_command_grammars[model.path];
+    if (!grammar) grammar = std::make_shared<SttCommandGrammar>(model.ctx, g_commands);
+    return grammar;
+}
+
+JNIEXPORT jint JNICALL
+Java_dev_deviceai_SpeechBridge_nativeRecognizeCommand(
+    JNIEnv *env, jobject thiz,
+    jfloatArray samples,
+    jobjectArray commands,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs) {
+
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    SttOptions options = read_options(env, optModel, optLanguage, optFlags, optTimeoutMs);
+    SttModelRef model = request_model(options);
+    if (!model) {
+        LOGE("Whisper not initialized");
+        return -1;
+    }
+
+    // Per-request phrases are compiled for this call only
+    std::shared_ptr<const SttCommandGrammar> grammar = commands != nullptr
+        ? std::make_shared<SttCommandGrammar>(model->ctx, jstring_array_to_vector(env, commands))
+        : init_command_grammar(*model);
+    if (grammar->size() == 0) {
+        LOGE("[CMD] no command phrases");
+        return -1;
+    }
+
+    SttAbort abort(&g_cancel, options.timeout_ms);
+
+    jsize len = env->GetArrayLength(samples);
+    jfloat *audio = env->GetFloatArrayElements(samples, nullptr);
+    WhisperStatePool::Lease lease = model->pool->acquire();
+    int index = lease ? stt_recognize_command(model->ctx, lease.state(), options.apply(g_params), *grammar,
+                                              audio, (size_t)len, g_use_vad, &abort)
+                      : -2;
+    env->ReleaseFloatArrayElements(samples, audio, JNI_ABORT);
+    return index >= 0 ? index : -1;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                      ASYNCHRONOUS JOBS
+// ═══════════════════════════════════════════════════════════════
+
+// Runs on a job worker, after g_mutex is released (the callback may submit
+// more work). `error` empty: success.
+static void report_job(const JniGlobalRef &callback, int64_t id, const SttResult &result,
+                       const std::string &error) {
+    JNIEnv *env = jni_attach_current_thread();
+    if (env == nullptr) return;
+    if (error.empty()) {
+        jobject jResult = new_transcription_result(env, result);
+        env->CallVoidMethod(callback.get(), g_jni.sttJobOnResult, (jlong)id, jResult);
+        env->DeleteLocalRef(jResult);
+    } else {
+        jstring jMessage = env->NewStringUTF(error.c_str());
+        env->CallVoidMethod(callback.get(), g_jni.sttJobOnError, (jlong)id, jMessage);
+        env->DeleteLocalRef(jMessage);
+    }
+}
+
+// The decode a job runs, on the model and params its options resolve to.
+using JobBody = std::function<bool(const SttModel &model, const struct whisper_full_params &params,
+                                   const SttAbort &abort, SttResult &result)>;
+
+// Returns the error message, or "" on success (a job past its deadline
+// succeeds with a partial result). `generation` is g_ctx_generation at
+// submit time: a job queued before re-init must not run on the new engine.
+static std::string run_job(uint64_t generation, const SttOptions &options, const std::atomic<bool> &cancel,
+                           const JobBody &body, SttResult &result) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+    if (generation != g_ctx_generation) return "STT was re-initialized or shut down";
+    SttModelRef model = request_model(options);
+    if (!model) return "Whisper not initialized";
+    SttAbort abort(&cancel, options.timeout_ms);  // the deadline counts from job start, not submit
+    if (!body(*model, options.apply(g_params), abort, result)) {
+        return cancel ? "Cancelled" : "Transcription failed";
+    }
+    return cancel ? "Cancelled" : "";
+}
+
+// Queues `body` at `priority`; the outcome goes to `callback` (SttJobCallback).
+static jlong submit_job(JNIEnv *env, jint priority, const SttOptions &options, jobject callback,
+                        JobBody body) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    if (!g_jobs) {
+        LOGE("Whisper not initialized");
+        return 0;
+    }
+
+    auto cb = std::make_shared<JniGlobalRef>(env, callback);
+    const uint64_t generation = g_ctx_generation;
+    auto p = (SttJobPriority)std::min(std::max((int)priority, (int)STT_PRIORITY_INTERACTIVE),
+                                      (int)STT_PRIORITY_BACKGROUND);
+    return (jlong)g_jobs->submit(p,
+        [cb, generation, options, body](int64_t id, const std::atomic<bool> &cancel) {
+            SttResult result;
+            std::string error = run_job(generation, options, cancel, body, result);
+            report_job(*cb, id, result, error);
+        },
+        [cb](int64_t id) { report_job(*cb, id, SttResult(), "Cancelled"); });
+}
+
+JNIEXPORT jlong JNICALL
+Java_dev_deviceai_SpeechBridge_nativeSubmitTranscription(
+    JNIEnv *env, jobject thiz,
+    jstring audioPath,
+    jint priority,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs,
+    jobject callback) {
+
+    std::string path = jstring_to_string(env, audioPath);
+    SttOptions options = read_options(env, optModel, optLanguage, optFlags, optTimeoutMs);
+    bool split_channels = options.split_channels > 0;
+    return submit_job(env, priority, options, callback,
+        [path, split_channels](const SttModel &model, const struct whisper_full_params &params,
+                               const SttAbort &abort, SttResult &result) {
+            WavReader reader;
+            return reader.open(path) && transcribe_wav_file(model, reader, params, split_channels, &abort, result);
+        });
+}
+
+JNIEXPORT jlong JNICALL
+Java_dev_deviceai_SpeechBridge_nativeSubmitTranscriptionAudio(
+    JNIEnv *env, jobject thiz,
+    jfloatArray samples,
+    jint priority,
+    jstring optModel,
+    jstring optLanguage,
+    jint optFlags,
+    jlong optTimeoutMs,
+    jobject callback) {
+
+    // Copied: the job outlives this call
+    jsize len = env->GetArrayLength(samples);
+    auto audio = std::make_shared<std::vector<float>>((size_t)len);
+    env->GetFloatArrayRegion(samples, 0, len, audio->data());
+
+    return submit_job(env, priority, read_options(env, optModel, optLanguage, optFlags, optTimeoutMs), callback,
+        [audio](const SttModel &model, const struct whisper_full_params &params,
+                const SttAbort &abort, SttResult &result) {
+            return transcribe_samples(model, audio->data(), audio->size(), params, now_ms(), &abort, result);
+        });
+}
+
+JNIEXPORT jboolean JNICALL
+Java_dev_deviceai_SpeechBridge_nativeCancelSttJob(
+    JNIEnv *env, jobject thiz,
+    jlong jobId) {
+
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    return g_jobs && g_jobs->cancel((int64_t)jobId) ? JNI_TRUE : JNI_FALSE;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                       MODEL REGISTRY
+// ═══════════════════════════════════════════════════════════════
+
+// Runs on the registry's loader thread.
+static void report_model_loaded(const JniGlobalRef &callback, const std::string &path, bool ok) {
+    JNIEnv *env = jni_attach_current_thread();
+    if (env == nullptr) return;
+    jstring jPath = env->NewStringUTF(path.c_str());
+    env->CallVoidMethod(callback.get(), g_jni.sttOnModelLoaded, jPath, (jboolean)ok);
+    env->DeleteLocalRef(jPath);
+}
+
+JNIEXPORT jboolean JNICALL
+Java_dev_deviceai_SpeechBridge_nativeLoadSttModel(
+    JNIEnv *env, jobject thiz,
+    jstring modelPath,
+    jboolean activate,
+    jobject callback) {
+
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    if (!g_models) {
+        LOGE("Whisper not initialized");
+        return JNI_FALSE;
+    }
+
+    SttModelRegistry::LoadCallback done;
+    if (callback != nullptr) {
+        auto cb = std::make_shared<JniGlobalRef>(env, callback);
+        done = [cb](const std::string &path, bool ok) { report_model_loaded(*cb, path, ok); };
+    }
+    g_models->load_async(jstring_to_string(env, modelPath), activate, std::move(done));
+    return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_dev_deviceai_SpeechBridge_nativeUnloadSttModel(
+    JNIEnv *env, jobject thiz,
+    jstring modelPath) {
+
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    return g_models && g_models->unload(jstring_to_string(env, modelPath)) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jobjectArray JNICALL
+Java_dev_deviceai_SpeechBridge_nativeResidentSttModels(
+    JNIEnv *env, jobject thiz) {
+
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    std::vector<std::string> paths;
+    if (g_models) paths = g_models->resident();
+
+    jobjectArray array = env->NewObjectArray((jsize)paths.size(), g_jni.string, nullptr);
+    for (size_t i = 0; i < paths.size(); i++) {
+        jstring jPath = env->NewStringUTF(paths[i].c_str());
+        env->SetObjectArrayElement(array, (jsize)i, jPath);
+        env->DeleteLocalRef(jPath);
+    }
+    return array;
 }
 
 // ═══════════════════════════════════════════════════════════════
@@ -679,9 +1625,7 @@ Java_dev_deviceai_SpeechBridge_nativeSynthesizeStream(
     JNIEnv *env, jobject thiz,
     jstring text,
     jobject callback) {
-    jclass cbClass = env->GetObjectClass(callback);
-    jmethodID onError = env->GetMethodID(cbClass, "onError", "(Ljava/lang/String;)V");
-    env->CallVoidMethod(callback, onError, env->NewStringUTF("TTS not available - built with STT only"));
+    env->CallVoidMethod(callback, g_jni.ttsOnError, env->NewStringUTF("TTS not available - built with STT only"));
 }
 
 JNIEXPORT void JNICALL
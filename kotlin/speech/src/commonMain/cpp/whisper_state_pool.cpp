@@ -0,0 +1,194 @@
+/**
+ * whisper_state_pool.cpp - Pool of whisper_state objects sharing one context
+ */
+
+#include "whisper_state_pool.h"
+#include "stt_buckets.h"
+#include "stt_common.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+// ═══════════════════════════════════════════════════════════════
+//                            LEASE
+// ═══════════════════════════════════════════════════════════════
+
+WhisperStatePool::Lease::Lease(Lease &&other) noexcept
+    : pool_(other.pool_), slot_(other.slot_), state_(other.state_) {
+    other.pool_ = nullptr;
+    other.slot_ = -1;
+    other.state_ = nullptr;
+}
+
+WhisperStatePool::Lease &WhisperStatePool::Lease::operator=(Lease &&other) noexcept {
+    if (this != &other) {
+        release();
+        pool_ = other.pool_;
+        slot_ = other.slot_;
+        state_ = other.state_;
+        other.pool_ = nullptr;
+        other.slot_ = -1;
+        other.state_ = nullptr;
+    }
+    return *this;
+}
+
+void WhisperStatePool::Lease::release() {
+    if (pool_ != nullptr) {
+        pool_->give_back(slot_);
+    }
+    pool_ = nullptr;
+    slot_ = -1;
+    state_ = nullptr;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                            POOL
+// ═══════════════════════════════════════════════════════════════
+
+WhisperStatePool::WhisperStatePool(struct whisper_context *ctx, int size)
+    : ctx_(ctx), states_((size_t)std::max(1, size), nullptr) {
+    // Hand out low slots first so a lightly loaded pool keeps reusing the
+    // same (already allocated, cache-warm) states.
+    for (int i = (int)states_.size() - 1; i >= 0; i--) {
+        free_slots_.push_back(i);
+    }
+}
+
+WhisperStatePool::~WhisperStatePool() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_slots_.size() != states_.size()) {
+        LOGE("[POOL] destroyed with %zu state(s) still leased",
+             states_.size() - free_slots_.size());
+    }
+    for (struct whisper_state *state : states_) {
+        if (state != nullptr) whisper_free_state(state);
+    }
+    states_.clear();
+}
+
+WhisperStatePool::Lease WhisperStatePool::acquire() {
+    int slot;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (free_slots_.empty()) {
+            long t_wait = now_ms();
+            available_.wait(lock, [this] { return !free_slots_.empty(); });
+            LOGD("[POOL] waited %ld ms for a free state", now_ms() - t_wait);
+        }
+        slot = free_slots_.back();
+        free_slots_.pop_back();
+    }
+
+    // The slot is ours now; allocate outside the lock so other callers are
+    // not blocked behind a (slow) first-time allocation.
+    if (states_[slot] == nullptr) {
+        long t_alloc = now_ms();
+        states_[slot] = whisper_init_state(ctx_);
+        if (states_[slot] == nullptr) {
+            LOGE("[POOL] failed to allocate whisper state for slot %d", slot);
+            give_back(slot);
+            return Lease();
+        }
+        LOGI("[POOL] allocated state for slot %d in %ld ms", slot, now_ms() - t_alloc);
+    }
+
+    return Lease(this, slot, states_[slot]);
+}
+
+int WhisperStatePool::preallocate() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int allocated = 0;
+    for (size_t slot = 0; slot < states_.size(); slot++) {
+        if (states_[slot] == nullptr) {
+            states_[slot] = whisper_init_state(ctx_);
+            if (states_[slot] == nullptr) {
+                LOGE("[POOL] failed to preallocate state for slot %zu", slot);
+                continue;
+            }
+        }
+        allocated++;
+    }
+    return allocated;
+}
+
+int WhisperStatePool::warm_up(const struct whisper_full_params &params) {
+    preallocate();
+
+    // One second of faint noise (pure zeros take degenerate paths in the
+    // log-mel) with the decoder capped at one token: every weight is touched,
+    // little else is computed. It runs once per short audio_ctx bucket, so
+    // each encoder shape a request can use has been set up on every state;
+    // the full window is the shape whisper_init_state() already sized for.
+    std::vector<float> audio(WHISPER_SAMPLE_RATE);
+    uint32_t seed = 12345;
+    for (float &x : audio) {
+        seed = seed * 1664525u + 1013904223u;
+        x = ((float)(seed >> 8) / 16777216.0f - 0.5f) * 2e-3f;
+    }
+
+    struct whisper_full_params warm = params;
+    reset_for_reuse(warm);
+    warm.single_segment  = true;
+    warm.no_timestamps   = true;
+    warm.max_tokens      = 1;
+    warm.temperature_inc = 0.0f;
+
+    std::atomic<int> warmed{0};
+    auto run = [&](struct whisper_state *state) {
+        bool ok = true;
+        for (size_t i = 0; i < STT_AUDIO_CTX_N_BUCKETS; i++) {
+            struct whisper_full_params bucket = warm;
+            bucket.audio_ctx = stt_bucket_audio_ctx_at(ctx_, i);
+            if (bucket.audio_ctx == 0) continue;
+            ok = whisper_full_with_state(ctx_, state, bucket, audio.data(), (int)audio.size()) == 0 && ok;
+        }
+        if (ok) warmed++;
+    };
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::thread> threads;
+    for (size_t slot = 1; slot < states_.size(); slot++) {
+        if (states_[slot] != nullptr) threads.emplace_back(run, states_[slot]);
+    }
+    if (states_[0] != nullptr) run(states_[0]);
+    for (std::thread &t : threads) t.join();
+    return warmed;
+}
+
+void WhisperStatePool::reset_for_reuse(struct whisper_full_params &params) {
+    params.no_context = true;
+}
+
+bool WhisperStatePool::run_parallel(
+        size_t n_tasks,
+        const std::function<bool(size_t task, struct whisper_state *state)> &task) {
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+
+    auto worker = [&]() {
+        Lease lease;
+        size_t i;
+        while (!failed && (i = next++) < n_tasks) {
+            // Lease on first use: workers that find no task never take a state
+            if (!lease) lease = acquire();
+            if (!lease || !task(i, lease.state())) failed = true;
+        }
+    };
+
+    size_t n_threads = std::min(n_tasks, states_.size());
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < n_threads; t++) threads.emplace_back(worker);
+    worker();  // the calling thread works too
+    for (std::thread &t : threads) t.join();
+    return !failed;
+}
+
+void WhisperStatePool::give_back(int slot) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_slots_.push_back(slot);
+    }
+    available_.notify_one();
+}
@@ -0,0 +1,103 @@
+/**
+ * whisper_state_pool.h - Pool of whisper_state objects sharing one context
+ *
+ * The model weights live in the whisper_context and are read-only during
+ * inference; everything a transcription mutates (KV cache, mel, results)
+ * lives in a whisper_state. Leasing states from a pool therefore lets several
+ * transcriptions run concurrently on one loaded model.
+ *
+ * The pool does not own the context. Callers must keep the context alive
+ * (and not destroy the pool) while any lease is outstanding.
+ */
+
+#ifndef WHISPER_STATE_POOL_H
+#define WHISPER_STATE_POOL_H
+
+#include "whisper.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+class WhisperStatePool {
+public:
+    // Exclusive use of one pooled state; returned to the pool on destruction.
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(Lease &&other) noexcept;
+        Lease &operator=(Lease &&other) noexcept;
+        Lease(const Lease &) = delete;
+        Lease &operator=(const Lease &) = delete;
+        ~Lease() { release(); }
+
+        struct whisper_state *state() const { return state_; }
+        int slot() const { return slot_; }
+        explicit operator bool() const { return state_ != nullptr; }
+
+        void release();
+
+    private:
+        friend class WhisperStatePool;
+        Lease(WhisperStatePool *pool, int slot, struct whisper_state *state)
+            : pool_(pool), slot_(slot), state_(state) {}
+
+        WhisperStatePool *pool_ = nullptr;
+        int slot_ = -1;
+        struct whisper_state *state_ = nullptr;
+    };
+
+    // States are allocated lazily on first lease of each slot.
+    WhisperStatePool(struct whisper_context *ctx, int size);
+    ~WhisperStatePool();
+
+    WhisperStatePool(const WhisperStatePool &) = delete;
+    WhisperStatePool &operator=(const WhisperStatePool &) = delete;
+
+    // Blocks until a state is free. Returns an empty lease if the state
+    // could not be allocated.
+    Lease acquire();
+
+    // Allocates every slot up front so no lease pays the allocation (KV
+    // caches, mel buffers, compute graphs). Call before handing out leases.
+    // Returns the number of states now allocated.
+    int preallocate();
+
+    // Allocates every slot and runs a short dummy transcription on each
+    // state, concurrently, once per short audio_ctx bucket (stt_buckets.h).
+    // The first whisper_full() on a state, and on each encoder shape, pays
+    // for backend buffer setup and GPU pipeline creation, and the first pass
+    // over the model faults its weights into memory; after this, the first
+    // real request runs at steady-state speed. Call before handing out leases.
+    // Returns the number of states warmed.
+    int warm_up(const struct whisper_full_params &params);
+
+    // Prepares params so a reused state behaves like a freshly allocated
+    // one. whisper_full_with_state() already clears the previous results;
+    // the only thing a state carries between calls is the decoder prompt
+    // history, which no_context drops. The call's own initial_prompt or
+    // prompt_tokens are kept: whisper prepends them after the history is
+    // cleared, as it would on a fresh state.
+    static void reset_for_reuse(struct whisper_full_params &params);
+
+    // Runs task(i, state) for every i in [0, n_tasks) on up to size() threads,
+    // each holding its own lease, and blocks until all are done. Tasks are
+    // handed out in index order. Returns false if any task returned false or
+    // no state could be leased (the remaining tasks are skipped).
+    bool run_parallel(size_t n_tasks,
+                      const std::function<bool(size_t task, struct whisper_state *state)> &task);
+
+    int size() const { return (int)states_.size(); }
+
+private:
+    void give_back(int slot);
+
+    struct whisper_context *ctx_;
+    std::vector<struct whisper_state *> states_;
+    std::vector<int> free_slots_;
+    std::mutex mutex_;
+    std::condition_variable available_;
+};
+
+#endif // WHISPER_STATE_POOL_H
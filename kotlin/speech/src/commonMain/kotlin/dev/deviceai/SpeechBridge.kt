@@ -21,37 +21,257 @@ expect object SpeechBridge {
     /**
      * Transcribe an audio file to text.
      *
-     * @param audioPath Path to WAV file (16kHz, mono, 16-bit PCM)
+     * @param audioPath Path to a WAV (8/16/24/32-bit PCM or float) or FLAC file, any rate and channel count
+     * @param options Per-request overrides of the init settings
      * @return Transcribed text
      */
-    fun transcribe(audioPath: String): String
+    fun transcribe(audioPath: String, options: SttOptions = SttOptions()): String
 
     /**
      * Transcribe with detailed results including timestamps.
      *
      * @param audioPath Path to WAV file
+     * @param options Per-request overrides of the init settings
      * @return TranscriptionResult with segments and timing
      */
-    fun transcribeDetailed(audioPath: String): TranscriptionResult
+    fun transcribeDetailed(audioPath: String, options: SttOptions = SttOptions()): TranscriptionResult
 
     /**
      * Transcribe raw PCM audio samples.
      *
      * @param samples Float array of audio samples (16kHz, mono, normalized -1.0 to 1.0)
+     * @param options Per-request overrides of the init settings
      * @return Transcribed text
      */
-    fun transcribeAudio(samples: FloatArray): String
+    fun transcribeAudio(samples: FloatArray, options: SttOptions = SttOptions()): String
 
     /**
-     * Stream transcription with real-time callbacks.
+     * Identify the spoken language without transcribing.
+     *
+     * Only the first few seconds of speech are encoded, with a reduced
+     * encoder window, so this is far cheaper than a full transcription.
+     *
+     * @param samples Float array of audio samples (16kHz, mono, normalized -1.0 to 1.0)
+     * @param topN Number of candidates to return
+     * @param options Per-request overrides: the model to identify with (e.g.
+     *                the one the audio will be routed to) and the deadline;
+     *                [cancelStt] stops it too
+     * @return The most likely languages, most probable first; empty on failure
+     */
+    fun detectLanguage(
+        samples: FloatArray,
+        topN: Int = 3,
+        options: SttOptions = SttOptions()
+    ): List<LanguageProbability>
+
+    /**
+     * Recognize one phrase of a closed command list.
+     *
+     * Decoding is restricted to the phrases, so the result is always one of
+     * them, and it ends as soon as the decoded prefix fits a single phrase:
+     * far fewer decoder steps than a free transcription. The decoder may
+     * also answer "no command"; with VAD, audio without speech is rejected
+     * before decoding.
+     *
+     * @param samples Float array of audio samples (16kHz, mono, normalized -1.0 to 1.0)
+     * @param commands Phrases for this call; null uses [SttConfig.commands]
+     * @param options Per-request overrides of the init settings
+     * @return The recognized phrase, or null
+     */
+    fun recognizeCommand(
+        samples: FloatArray,
+        commands: List<String>? = null,
+        options: SttOptions = SttOptions()
+    ): SttCommandMatch?
+
+    /**
+     * Transcribe many independent clips in one call.
+     *
+     * Clips are spread over the state pool ([SttConfig.statePoolSize]) and
+     * short clips share a decode window, which is much cheaper than calling
+     * [transcribeAudio] once per clip.
+     *
+     * @param clips Audio clips (16kHz, mono, normalized -1.0 to 1.0)
+     * @param options Overrides applied to every clip
+     * @return One result per clip, in input order; segment times are relative to each clip.
+     *         A clip that could not be decoded has [TranscriptionResult.error] set
+     */
+    fun transcribeBatch(
+        clips: List<FloatArray>,
+        options: SttOptions = SttOptions()
+    ): List<TranscriptionResult>
+
+    /**
+     * Transcribe many WAV files in one call, like [transcribeBatch].
+     *
+     * @param audioPaths Paths to WAV files
+     * @param options Overrides applied to every file
+     * @return One result per file, in input order; a file that cannot be read or
+     *         decoded yields an empty result with [TranscriptionResult.error] set
+     */
+    fun transcribeFilesBatch(
+        audioPaths: List<String>,
+        options: SttOptions = SttOptions()
+    ): List<TranscriptionResult>
+
+    /**
+     * Decode one clip several ways from a single encoder pass, e.g. the
+     * transcription and the English translation together.
+     *
+     * The encoder, the dominant cost for small models, runs once per 30 s
+     * window; each task then runs only the decoder. Decoding is greedy and
+     * without timestamps, so each window yields one segment per task.
+     *
+     * @param samples Float array of audio samples (16kHz, mono, normalized -1.0 to 1.0)
+     * @param tasks Decodes to run
+     * @param options Defaults for every task (a task's own fields take precedence)
+     * @return One result per task, in task order; empty results on failure
+     */
+    fun transcribeAudioTasks(
+        samples: FloatArray,
+        tasks: List<SttTask>,
+        options: SttOptions = SttOptions()
+    ): List<TranscriptionResult>
+
+    /**
+     * Transcribe a complete clip, reporting it segment by segment.
+     *
+     * Not incremental: the whole array is decoded in one pass, then
+     * [SttStream.onPartialResult] is called with the accumulated text after
+     * each segment and [SttStream.onFinalResult] once at the end. For live
+     * audio that should produce text while it is still arriving, use
+     * [openSttSession].
      *
      * @param samples Audio samples to transcribe
-     * @param callback Callbacks for partial/final results
+     * @param callback Callbacks for per-segment/final results
+     * @param options Per-request overrides of the init settings
+     */
+    fun transcribeStream(samples: FloatArray, callback: SttStream, options: SttOptions = SttOptions())
+
+    /**
+     * Open an incremental transcription session for live audio.
+     *
+     * @param callback Receives partial results while audio is pushed and the
+     *                 final result of each utterance on [SttSession.flush]
+     * @param options Overrides of the init settings for this session
+     * @param finalModelPath Larger model that re-decodes each utterance on
+     *                       flush (cascade, see [SttSession]); loaded on
+     *                       first use and kept resident like any other
+     *                       model. Null: the streaming result is final.
+     * @return The session, or null if STT is not initialized or the final model cannot be loaded
+     */
+    fun openSttSession(
+        callback: SttStream,
+        options: SttOptions = SttOptions(),
+        finalModelPath: String? = null
+    ): SttSession?
+
+    /**
+     * Start always-on listening (see [SttListener]): whisper runs only on
+     * completed utterances found in the pushed audio.
+     *
+     * @param callback Receives speech onsets and transcribed utterances on
+     *                 the native listener thread
+     * @param options Overrides of the init settings, applied to every
+     *                utterance; a timeout applies per utterance
+     * @param config Endpointing settings
+     * @return The listener, or null if STT is not initialized
+     */
+    fun startListening(
+        callback: SttListenerCallback,
+        options: SttOptions = SttOptions(),
+        config: SttListenerConfig = SttListenerConfig()
+    ): SttListener?
+
+    /**
+     * Queue a WAV file for transcription and return immediately.
+     *
+     * Jobs run on native worker threads (one per [SttConfig.statePoolSize]),
+     * so no caller thread blocks for the decode. See [awaitTranscription] for
+     * a suspending version.
+     *
+     * @param audioPath Path to a WAV (8/16/24/32-bit PCM or float) or FLAC file, any rate and channel count
+     * @param priority Scheduling class of the job
+     * @param options Overrides of the init settings for this job
+     * @param callback Receives the result or error on a worker thread
+     * @return Job id for [cancelSttJob], or 0 if STT is not initialized
+     *         (the callback is then never called)
+     */
+    fun submitTranscription(
+        audioPath: String,
+        priority: SttPriority = SttPriority.NORMAL,
+        options: SttOptions = SttOptions(),
+        callback: SttJobCallback
+    ): Long
+
+    /**
+     * Queue raw audio for transcription and return immediately. The samples
+     * are copied. Same delivery as [submitTranscription].
+     *
+     * @param samples Audio samples (16kHz, mono, normalized -1.0 to 1.0)
+     */
+    fun submitTranscriptionAudio(
+        samples: FloatArray,
+        priority: SttPriority = SttPriority.INTERACTIVE,
+        options: SttOptions = SttOptions(),
+        callback: SttJobCallback
+    ): Long
+
+    /**
+     * Cancel one queued or running job; others are unaffected. The job
+     * reports "Cancelled" through [SttJobCallback.onError].
+     *
+     * @return false if the job already finished
+     */
+    fun cancelSttJob(jobId: Long): Boolean
+
+    /**
+     * Counters of the result cache enabled by [SttConfig.resultCacheBytes].
+     * All zero when the cache is off.
+     */
+    fun getSttCacheStats(): SttCacheStats
+
+    /**
+     * Drop every cached transcription result. Counters are kept.
+     */
+    fun clearSttCache()
+
+    /**
+     * How often [SttConfig.stopRepetitionLoops] cut a decoder loop short,
+     * since initStt.
+     */
+    fun getSttLoopStats(): SttLoopStats
+
+    /**
+     * Load another model in the background while transcriptions continue on
+     * the current one. With [activate], it replaces the active model once
+     * ready; in-flight requests finish on the model they started with.
+     *
+     * @param modelPath Path to the .bin model file
+     * @param activate Make it the model used when [SttOptions.modelPath] is null
+     * @param callback Called on a background thread when the load finishes
+     * @return false if STT is not initialized
+     */
+    fun loadSttModel(modelPath: String, activate: Boolean = true, callback: SttModelCallback? = null): Boolean
+
+    /**
+     * Drop a resident model. The active model cannot be unloaded.
+     *
+     * @return true if the model was resident and is now unloaded
+     */
+    fun unloadSttModel(modelPath: String): Boolean
+
+    /**
+     * Paths of the resident models, most recently used first.
      */
-    fun transcribeStream(samples: FloatArray, callback: SttStream)
+    fun residentSttModels(): List<String>
 
     /**
-     * Cancel ongoing transcription.
+     * Cancel ongoing transcriptions and every queued or running job. A decode
+     * in progress stops within tens of milliseconds; transcriptions started
+     * afterwards are unaffected. A listener's utterance being decoded is
+     * cancelled too (reported as a partial result); the listener keeps
+     * listening.
      */
     fun cancelStt()
 
@@ -0,0 +1,31 @@
+package dev.deviceai
+
+/**
+ * Counters of the transcribeAudio result cache ([SttConfig.resultCacheBytes]).
+ */
+data class SttCacheStats(
+    /**
+     * Lookups answered from the cache since initStt.
+     */
+    val hits: Long,
+
+    /**
+     * Lookups that ran the model.
+     */
+    val misses: Long,
+
+    /**
+     * Entries dropped to stay within the memory budget.
+     */
+    val evictions: Long,
+
+    /**
+     * Results currently cached.
+     */
+    val entries: Long,
+
+    /**
+     * Approximate memory held by the cached results.
+     */
+    val bytes: Long
+)
@@ -0,0 +1,16 @@
+package dev.deviceai
+
+/**
+ * The command phrase recognized by [SpeechBridge.recognizeCommand].
+ */
+data class SttCommandMatch(
+    /**
+     * Position of the phrase in the command list.
+     */
+    val index: Int,
+
+    /**
+     * The phrase as given in the command list.
+     */
+    val phrase: String
+)
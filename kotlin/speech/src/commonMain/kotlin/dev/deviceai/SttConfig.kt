@@ -2,6 +2,10 @@ package dev.deviceai
 
 /**
  * Configuration for speech-to-text.
+ *
+ * language, translateToEnglish, singleSegment and noContext are defaults:
+ * pass [SttOptions] to a transcribe call to change them for that call
+ * without re-initializing.
  */
 data class SttConfig(
     /**
@@ -26,7 +30,9 @@ data class SttConfig(
     val useGpu: Boolean = true,
 
     /**
-     * Enable voice activity detection to skip silence.
+     * Enable voice activity detection to skip silence. Leading, trailing and
+     * internal pauses are cut before inference; segment timestamps still
+     * refer to the original audio.
      */
     val useVad: Boolean = true,
 
@@ -34,6 +40,8 @@ data class SttConfig(
      * Force output into a single segment, skipping subtitle-style timestamp
      * boundary detection. Set to true for interactive voice commands.
      * Set to false if you need timestamped segments (e.g. podcast transcription).
+     * Files are still decoded into segments window by window, so no word is cut
+     * at a 30 s window edge, and then joined into one.
      *
      * Requires VAD (useVad = true) to trim trailing silence first — otherwise
      * the decoder loops on silence and repeats the transcription.
@@ -45,5 +53,91 @@ data class SttConfig(
      * Set to true for isolated voice commands (each recording is independent).
      * Set to false for continuous transcription of a long audio stream.
      */
-    val noContext: Boolean = true
+    val noContext: Boolean = true,
+
+    /**
+     * Number of decoder states sharing the loaded model. Each state runs one
+     * transcription at a time, so this is how many transcriptions can run
+     * concurrently. Extra states cost their KV cache and compute buffers,
+     * not another copy of the model weights.
+     */
+    val statePoolSize: Int = 1,
+
+    /**
+     * CPU threads used by each pooled state. 0 = maxThreads / statePoolSize.
+     */
+    val threadsPerState: Int = 0,
+
+    /**
+     * Keep transcribeAudio's decoder states alive between calls instead of
+     * allocating a fresh one per call. States are allocated once during init
+     * and reset in place, so each call stays fully isolated from the last.
+     */
+    val persistentState: Boolean = false,
+
+    /**
+     * Long-form mode for file transcription. Files are split at pauses into
+     * ~30 s chunks that are transcribed concurrently on all statePoolSize
+     * states, then stitched back together in order. Needs statePoolSize > 1;
+     * chunks are decoded without each other's context.
+     */
+    val longForm: Boolean = false,
+
+    /**
+     * Warm up during initStt: allocate every pooled state and run a short
+     * dummy transcription on each, once per encoder length used for short
+     * audio (2, 4, 8 and 15 s), so the first real request does not pay for
+     * backend setup and faulting in the model weights. Makes initStt slower
+     * by roughly one 30 s encoder pass per state. Pair with persistentState
+     * so transcribeAudio reuses the warmed states.
+     */
+    val warmUp: Boolean = false,
+
+    /**
+     * With language "auto", identify the language once per file, session or
+     * transcribeAudio call from its first few seconds (a short, truncated
+     * encoder pass) and decode everything with that language. Later windows
+     * then skip detection and cannot flip between languages mid-stream.
+     */
+    val pinDetectedLanguage: Boolean = false,
+
+    /**
+     * Memory budget in bytes for caching transcribeAudio results; 0 disables
+     * the cache. Inputs are keyed by a fingerprint of their speech (after
+     * VAD) plus the model, language and translate settings, so the same
+     * recording played again, at any volume, returns without running the
+     * model. A fresh recording of the same words does not match. Least
+     * recently used results are evicted first.
+     */
+    val resultCacheBytes: Long = 0L,
+
+    /**
+     * File the result cache is loaded from during initStt and saved to on
+     * shutdownStt (or re-init). Empty keeps the cache in memory only.
+     */
+    val resultCachePath: String = "",
+
+    /**
+     * Total model file size kept resident, in bytes. Models loaded with
+     * [SpeechBridge.loadSttModel] or named by [SttOptions.modelPath] stay
+     * loaded up to this budget, least recently used first out. 0 keeps only
+     * the active model (plus any model a running request still uses).
+     */
+    val modelMemoryBudgetBytes: Long = 0L,
+
+    /**
+     * End a decoder window as soon as it starts repeating the same tokens.
+     * On silence or noise Whisper can loop on a phrase until the window's
+     * token budget is spent, which makes such input several times slower
+     * than speech. Off by default: genuinely repetitive speech (counting,
+     * chants, laughter) can trip it and lose the rest of the window. See
+     * [SpeechBridge.getSttLoopStats].
+     */
+    val stopRepetitionLoops: Boolean = false,
+
+    /**
+     * Default command phrases for [SpeechBridge.recognizeCommand], e.g.
+     * "turn on the lights". Compiled once per model on first use.
+     */
+    val commands: List<String> = emptyList()
 )
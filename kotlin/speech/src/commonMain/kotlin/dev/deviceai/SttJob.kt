@@ -0,0 +1,84 @@
+package dev.deviceai
+
+import kotlinx.coroutines.suspendCancellableCoroutine
+import kotlin.coroutines.resume
+import kotlin.coroutines.resumeWithException
+
+/**
+ * Scheduling class of a queued transcription job. Queued jobs start in this
+ * order (first come, first served within a class), so a voice command does
+ * not wait behind a backlog of files.
+ */
+enum class SttPriority {
+    /** User is waiting on the result: commands, dictation. */
+    INTERACTIVE,
+
+    /** Default for work that should not be starved. */
+    NORMAL,
+
+    /** Bulk work such as re-transcribing recordings; never takes the last worker. */
+    BACKGROUND
+}
+
+/**
+ * Completion callback of a queued transcription job. Exactly one method is
+ * called per job, on a native worker thread.
+ */
+interface SttJobCallback {
+    /**
+     * Called with the result of job [jobId].
+     */
+    fun onResult(jobId: Long, result: TranscriptionResult)
+
+    /**
+     * Called if job [jobId] failed, or with "Cancelled" if it was cancelled.
+     */
+    fun onError(jobId: Long, message: String)
+}
+
+/**
+ * Thrown by the suspending transcription helpers when a job fails.
+ */
+class SttJobException(message: String) : Exception(message)
+
+/**
+ * Transcribe a WAV file on the native job queue, suspending until it
+ * finishes. Cancelling the coroutine cancels the job.
+ *
+ * @throws SttJobException if the job fails or STT is not initialized
+ */
+suspend fun SpeechBridge.awaitTranscription(
+    audioPath: String,
+    priority: SttPriority = SttPriority.NORMAL,
+    options: SttOptions = SttOptions()
+): TranscriptionResult = awaitJob { callback -> submitTranscription(audioPath, priority, options, callback) }
+
+/**
+ * Transcribe raw audio on the native job queue, suspending until it
+ * finishes. Cancelling the coroutine cancels the job.
+ *
+ * @throws SttJobException if the job fails or STT is not initialized
+ */
+suspend fun SpeechBridge.awaitTranscriptionAudio(
+    samples: FloatArray,
+    priority: SttPriority = SttPriority.INTERACTIVE,
+    options: SttOptions = SttOptions()
+): TranscriptionResult = awaitJob { callback -> submitTranscriptionAudio(samples, priority, options, callback) }
+
+private suspend fun SpeechBridge.awaitJob(submit: (SttJobCallback) -> Long): TranscriptionResult =
+    suspendCancellableCoroutine { cont ->
+        val jobId = submit(object : SttJobCallback {
+            override fun onResult(jobId: Long, result: TranscriptionResult) {
+                if (cont.isActive) cont.resume(result)
+            }
+
+            override fun onError(jobId: Long, message: String) {
+                if (cont.isActive) cont.resumeWithException(SttJobException(message))
+            }
+        })
+        if (jobId == 0L) {
+            cont.resumeWithException(SttJobException("Whisper not initialized"))
+        } else {
+            cont.invokeOnCancellation { cancelSttJob(jobId) }
+        }
+    }
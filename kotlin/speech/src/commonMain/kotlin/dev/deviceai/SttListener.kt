@@ -0,0 +1,83 @@
+package dev.deviceai
+
+/**
+ * Always-on listening: whisper stays idle until speech appears.
+ *
+ * Push microphone audio continuously. [pushAudio] only copies the samples
+ * into a lock-free native ring buffer, so it is safe to call from the
+ * audio capture thread. A native listener thread watches the signal with
+ * a cheap endpointer (energy against a tracked noise floor) and runs
+ * whisper only on each completed utterance, including a short pre-roll
+ * from before speech started. While nobody speaks, almost no CPU is used.
+ *
+ * Callbacks are invoked on the native listener thread, one utterance at a
+ * time. Audio pushed while an utterance is decoded is buffered (up to 20 s)
+ * and processed afterwards.
+ */
+interface SttListener {
+    /**
+     * Queue audio for the listener. Never blocks; audio that does not fit
+     * the buffer is dropped.
+     *
+     * @param samples Audio samples (16kHz, mono, normalized -1.0 to 1.0)
+     */
+    fun pushAudio(samples: FloatArray)
+
+    /**
+     * Stop listening and release native resources. Audio not yet processed
+     * is discarded and a decode in progress is cancelled. Safe while
+     * [pushAudio] runs on another thread; must not be called from an
+     * [SttListenerCallback] method.
+     */
+    fun close()
+}
+
+/**
+ * Events of an [SttListener]. All times are in milliseconds of audio since
+ * listening started.
+ */
+interface SttListenerCallback {
+    /**
+     * Called once speech has lasted [SttListenerConfig.minSpeechMs], before
+     * the utterance is complete. Useful to show a "listening" indicator.
+     */
+    fun onSpeechStart(timeMs: Long)
+
+    /**
+     * Called with the transcription of a completed utterance. Segment times
+     * count from the start of listening, not of the utterance.
+     */
+    fun onUtterance(result: TranscriptionResult)
+
+    /**
+     * Called if an utterance could not be transcribed. Listening continues.
+     */
+    fun onError(message: String)
+}
+
+/**
+ * Endpointing of an [SttListener].
+ */
+data class SttListenerConfig(
+    /**
+     * Audio kept from before speech was detected, so the first syllable is
+     * not clipped.
+     */
+    val preRollMs: Int = 300,
+
+    /**
+     * Silence that ends an utterance. Shorter values answer sooner but may
+     * split a sentence at a pause.
+     */
+    val endSilenceMs: Int = 700,
+
+    /**
+     * Sounds shorter than this (clicks, bumps) are ignored.
+     */
+    val minSpeechMs: Int = 150,
+
+    /**
+     * Longer speech is cut and delivered in pieces of this length.
+     */
+    val maxUtteranceMs: Int = 30000
+)
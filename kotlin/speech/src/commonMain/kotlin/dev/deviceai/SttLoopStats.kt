@@ -0,0 +1,17 @@
+package dev.deviceai
+
+/**
+ * Counters of the repetition-loop guard ([SttConfig.stopRepetitionLoops]).
+ */
+data class SttLoopStats(
+    /**
+     * Decoder passes since initStt: one per 30 s window, per decoder and
+     * per temperature fallback.
+     */
+    val decodes: Long,
+
+    /**
+     * Passes ended early because the decoder was repeating itself.
+     */
+    val loopsStopped: Long
+)
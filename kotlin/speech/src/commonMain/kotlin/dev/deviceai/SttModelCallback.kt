@@ -0,0 +1,13 @@
+package dev.deviceai
+
+/**
+ * Completion callback of [SpeechBridge.loadSttModel].
+ */
+fun interface SttModelCallback {
+    /**
+     * Called on the background loader thread once [modelPath] is resident
+     * ([success] true) or failed to load. It may call [SpeechBridge.initStt]
+     * or [SpeechBridge.shutdownStt]; loads still queued are then dropped.
+     */
+    fun onModelLoaded(modelPath: String, success: Boolean)
+}
@@ -0,0 +1,71 @@
+package dev.deviceai
+
+/**
+ * Per-request overrides of the decode settings given to [SpeechBridge.initStt].
+ *
+ * These only change how a request is decoded, so switching language or
+ * translation per call costs nothing. A request can also run on another
+ * resident model (see [SpeechBridge.loadSttModel]) without re-initializing.
+ * A null field keeps the init value.
+ */
+data class SttOptions(
+    /**
+     * Language code (ISO 639-1), e.g. "en", "es", or "auto" for detection.
+     */
+    val language: String? = null,
+
+    /**
+     * Translate non-English speech to English.
+     */
+    val translateToEnglish: Boolean? = null,
+
+    /**
+     * Produce a single segment (faster for short utterances).
+     */
+    val singleSegment: Boolean? = null,
+
+    /**
+     * Don't condition on text from earlier windows.
+     */
+    val noContext: Boolean? = null,
+
+    /**
+     * Path of the model to run this request on. It is loaded on first use
+     * (on the calling thread) and stays resident within
+     * [SttConfig.modelMemoryBudgetBytes]. Null uses the active model.
+     */
+    val modelPath: String? = null,
+
+    /**
+     * Deadline for the decode in milliseconds. When it is hit, decoding
+     * stops and the segments produced so far are returned with
+     * [TranscriptionResult.isPartial] set. For a submitted job it counts
+     * from when the job starts running. Not applied to streaming sessions.
+     * Null means no deadline.
+     */
+    val timeoutMs: Long? = null,
+
+    /**
+     * For multi-channel WAV files (e.g. call recordings with the agent on
+     * one channel and the customer on the other): transcribe every channel
+     * separately, concurrently on up to [SttConfig.statePoolSize] states,
+     * instead of downmixing them. Segments then carry their
+     * [Segment.channel] and are ordered by start time. Applies to
+     * [SpeechBridge.transcribe], [SpeechBridge.transcribeDetailed] and
+     * [SpeechBridge.submitTranscription]; null or false downmixes.
+     */
+    val splitChannels: Boolean? = null
+) {
+    /**
+     * Boolean overrides packed for the native bridge: a "set" bit and a
+     * value bit per field (matches STT_OPT_* in stt_options.h).
+     */
+    internal fun packedFlags(): Int =
+        pack(translateToEnglish, 0) or pack(singleSegment, 2) or pack(noContext, 4) or pack(splitChannels, 6)
+
+    private fun pack(value: Boolean?, shift: Int): Int = when (value) {
+        null -> 0
+        false -> 1 shl shift
+        true -> 3 shl shift
+    }
+}
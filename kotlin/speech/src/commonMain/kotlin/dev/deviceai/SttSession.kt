@@ -0,0 +1,46 @@
+package dev.deviceai
+
+/**
+ * Incremental speech-to-text session for live audio.
+ *
+ * Push microphone audio as it is captured. The native side keeps only the
+ * not-yet-committed tail and re-decodes it every few hundred ms; words that
+ * two consecutive decodes agree on are committed, so
+ * [SttStream.onPartialResult] follows the speaker closely instead of waiting
+ * for the whole utterance.
+ *
+ * Opened with a final model ([SpeechBridge.openSttSession]), the session is
+ * a cascade: partials come from the session's (small) model, and [flush]
+ * re-decodes the whole utterance on the final (larger) model, with the
+ * streaming text as its prompt, before delivering it. Utterances longer than
+ * two minutes keep the streaming result.
+ *
+ * Callbacks are invoked on the thread calling [pushAudio] / [flush].
+ */
+interface SttSession {
+    /**
+     * Append audio to the session.
+     *
+     * @param samples Audio samples (16kHz, mono, normalized -1.0 to 1.0)
+     */
+    fun pushAudio(samples: FloatArray)
+
+    /**
+     * Finish the current utterance and deliver it via [SttStream.onFinalResult].
+     * The session stays open for the next utterance.
+     */
+    fun flush()
+
+    /**
+     * Decode timings of this session, partial and final paths separately.
+     */
+    fun stats(): SttSessionStats
+
+    /**
+     * Release native resources. The session cannot be used afterwards.
+     * Safe to call from any thread: a [pushAudio] or [flush] running
+     * elsewhere finishes first, and no callback fires once this returns.
+     * May be called from the session's own callbacks.
+     */
+    fun close()
+}
@@ -0,0 +1,28 @@
+package dev.deviceai
+
+/**
+ * Decode timings of one [SttSession] since it was opened, split by path so
+ * a cascade's two models can be compared.
+ */
+data class SttSessionStats(
+    /**
+     * Re-decodes of the live tail on the session's model (these drive
+     * [SttStream.onPartialResult]).
+     */
+    val partialDecodes: Long,
+
+    /**
+     * Total time spent in those decodes, in milliseconds.
+     */
+    val partialDecodeMs: Long,
+
+    /**
+     * Utterances re-decoded on the final model (cascade sessions only).
+     */
+    val finalPasses: Long,
+
+    /**
+     * Total time spent in final passes, in milliseconds.
+     */
+    val finalPassMs: Long
+)
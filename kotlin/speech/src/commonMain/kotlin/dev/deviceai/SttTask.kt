@@ -0,0 +1,25 @@
+package dev.deviceai
+
+/**
+ * One decode of a clip in [SpeechBridge.transcribeAudioTasks].
+ *
+ * All tasks share the clip's encoder pass; only the decoder runs per task.
+ * A null field falls back to the request's [SttOptions].
+ */
+data class SttTask(
+    /**
+     * Language code (ISO 639-1), or "auto" for detection (done once, shared
+     * by every "auto" task).
+     */
+    val language: String? = null,
+
+    /**
+     * Translate to English instead of transcribing.
+     */
+    val translateToEnglish: Boolean? = null,
+
+    /**
+     * Text the decoder is conditioned on (vocabulary, spelling, style).
+     */
+    val prompt: String? = null
+)
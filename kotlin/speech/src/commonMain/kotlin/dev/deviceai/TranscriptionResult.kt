@@ -22,7 +22,21 @@ data class TranscriptionResult(
     /**
      * Total audio duration in milliseconds.
      */
-    val durationMs: Long
+    val durationMs: Long,
+
+    /**
+     * True if decoding stopped early, on cancellation or at
+     * [SttOptions.timeoutMs]; [text] and [segments] hold what was decoded
+     * up to that point.
+     */
+    val isPartial: Boolean = false,
+
+    /**
+     * Why a batch input produced no transcription (it could not be read or
+     * decoded); null otherwise. An empty [text] without an error means the
+     * input had no speech.
+     */
+    val error: String? = null
 )
 
 /**
@@ -42,5 +56,26 @@ data class Segment(
     /**
      * End time in milliseconds from audio start.
      */
-    val endMs: Long
+    val endMs: Long,
+
+    /**
+     * Source channel (0-based) when the file was transcribed with
+     * [SttOptions.splitChannels]; -1 when all channels were mixed.
+     */
+    val channel: Int = -1
+)
+
+/**
+ * A candidate language from language identification.
+ */
+data class LanguageProbability(
+    /**
+     * Whisper language code, e.g. "en" or "de".
+     */
+    val language: String,
+
+    /**
+     * Probability in 0.0..1.0.
+     */
+    val probability: Float
 )
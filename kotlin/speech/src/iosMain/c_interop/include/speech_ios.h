@@ -12,6 +12,22 @@ extern "C" {
 //                            STT API
 // ═══════════════════════════════════════════════════════════════
 
+/**
+ * Per-request overrides of the decode parameters given to speech_stt_init.
+ * Pass NULL to any function taking options to use the init values.
+ */
+typedef struct speech_stt_options {
+    const char *language;   /* NULL or "": keep */
+    int translate;          /* -1: keep, 0 / 1: override */
+    int single_segment;     /* -1: keep, 0 / 1: override */
+    int no_context;         /* -1: keep, 0 / 1: override */
+    const char *model;      /* NULL or "": active model, else a model path (loaded on demand) */
+    int64_t timeout_ms;     /* <= 0: no deadline; else decoding stops after this long and the
+                               result so far is returned with "partial":true (not for sessions) */
+    int split_channels;     /* 1: transcribe each channel of a multi-channel WAV file separately,
+                               segments tagged with "channel"; -1 / 0: downmix */
+} speech_stt_options;
+
 /**
  * Initialize the STT engine with a Whisper model.
  *
@@ -21,38 +37,113 @@ extern "C" {
  * @param max_threads Number of CPU threads for inference
  * @param use_gpu Use GPU acceleration if available (Metal)
  * @param use_vad Enable voice activity detection
+ * @param state_pool_size Number of decoder states sharing the model (max concurrent transcriptions)
+ * @param threads_per_state CPU threads per pooled state (0 = max_threads / state_pool_size)
+ * @param persistent_state Allocate every pooled state during init
+ * @param long_form Split long files at pauses and transcribe the chunks concurrently on the pool
+ * @param warm_up Run a short dummy transcription on every pooled state during init
+ * @param pin_language With language "auto", detect the language once per file/session/call and keep it
+ * @param result_cache_bytes Memory budget of the speech_stt_transcribe_audio result cache (0 = off)
+ * @param result_cache_path File the result cache is loaded from and saved to (NULL or "" = memory only)
+ * @param model_budget_bytes Total model file size kept resident; least recently used models beyond it
+ *                           are unloaded (0 = keep only the active model)
+ * @param stop_repetition_loops End a decoder window as soon as it starts repeating the same tokens
+ * @param commands Default command phrases for speech_stt_recognize_command, or NULL
+ * @param n_commands Number of command phrases
  * @return true if initialization succeeded
  */
 bool speech_stt_init(const char *model_path, const char *language,
-                     bool translate, int max_threads, bool use_gpu, bool use_vad);
+                     bool translate, int max_threads, bool use_gpu, bool use_vad,
+                     int state_pool_size, int threads_per_state,
+                     bool persistent_state, bool long_form, bool warm_up,
+                     bool pin_language, int64_t result_cache_bytes,
+                     const char *result_cache_path, int64_t model_budget_bytes,
+                     bool stop_repetition_loops,
+                     const char *const *commands, int n_commands);
 
 /**
  * Transcribe an audio file to text.
  *
- * @param audio_path Path to WAV file (16kHz, mono, 16-bit PCM)
+ * @param audio_path Path to a WAV (8/16/24/32-bit PCM or float) or FLAC file, any rate and channel count
+ * @param options Per-request overrides, or NULL
  * @return Transcribed text (caller must free with speech_free_string)
  */
-char *speech_stt_transcribe(const char *audio_path);
+char *speech_stt_transcribe(const char *audio_path, const speech_stt_options *options);
 
 /**
  * Transcribe with detailed results including timestamps.
  *
  * @param audio_path Path to WAV file
+ * @param options Per-request overrides, or NULL
  * @return JSON string with transcription result (caller must free)
  */
-char *speech_stt_transcribe_detailed(const char *audio_path);
+char *speech_stt_transcribe_detailed(const char *audio_path, const speech_stt_options *options);
 
 /**
  * Transcribe raw PCM audio samples.
  *
  * @param samples Float array of audio samples (16kHz, mono, normalized -1.0 to 1.0)
  * @param n_samples Number of samples
+ * @param options Per-request overrides, or NULL
  * @return Transcribed text (caller must free with speech_free_string)
  */
-char *speech_stt_transcribe_audio(const float *samples, int n_samples);
+char *speech_stt_transcribe_audio(const float *samples, int n_samples,
+                                  const speech_stt_options *options);
+
+/**
+ * Identify the spoken language from the first few seconds of audio.
+ *
+ * @param samples Float array of audio samples (16kHz, mono, normalized -1.0 to 1.0)
+ * @param n_samples Number of samples
+ * @param top_n Number of candidates to return
+ * @param options Per-request overrides, or NULL: the model to identify with
+ *                and the deadline (cancellable with speech_stt_cancel)
+ * @return JSON array [{"language":"en","probability":0.93},...], most probable
+ *         first (caller must free with speech_free_string)
+ */
+char *speech_stt_detect_language(const float *samples, int n_samples, int top_n,
+                                 const speech_stt_options *options);
+
+/**
+ * Recognize one phrase of a closed command list.
+ *
+ * Decoding is restricted to the phrases and ends as soon as the decoded
+ * prefix fits a single one. Audio that is no command (or has no speech, with
+ * VAD) yields -1.
+ *
+ * @param samples Float array of audio samples (16kHz, mono, normalized -1.0 to 1.0)
+ * @param n_samples Number of samples
+ * @param commands Phrases for this call, or NULL for the ones given at init
+ * @param n_commands Number of phrases
+ * @param options Per-request overrides, or NULL
+ * @return Index of the recognized phrase, or -1
+ */
+int speech_stt_recognize_command(const float *samples, int n_samples,
+                                 const char *const *commands, int n_commands,
+                                 const speech_stt_options *options);
+
+/**
+ * Read the result cache counters.
+ *
+ * @param out_stats Receives 5 values: hits, misses, evictions, entries, bytes
+ */
+void speech_stt_cache_stats(int64_t *out_stats);
+
+/**
+ * Read the repetition-loop counters (since init).
+ *
+ * @param out_stats Receives 2 values: decoder passes, passes ended early on a loop
+ */
+void speech_stt_loop_stats(int64_t *out_stats);
 
 /**
- * Cancel ongoing transcription.
+ * Drop every cached result (the counters are kept).
+ */
+void speech_stt_cache_clear(void);
+
+/**
+ * Cancel ongoing transcriptions and every queued or running job.
+ * Transcriptions started afterwards are unaffected.
  */
 void speech_stt_cancel(void);
 
@@ -67,21 +158,267 @@ typedef void (*stt_on_final)(const char *json_result, void *user);
 typedef void (*stt_on_error)(const char *message, void *user);
 
 /**
- * Stream transcription with real-time callbacks.
+ * Transcribe a complete clip, reporting it segment by segment.
+ *
+ * Not incremental: the whole buffer is decoded in one pass, then on_partial
+ * receives the accumulated text after each segment and on_final the result.
+ * For live audio use speech_stt_session_open.
  *
  * @param samples Audio samples to transcribe
  * @param n_samples Number of samples
- * @param on_partial Callback for partial results
+ * @param options Per-request overrides, or NULL
+ * @param on_partial Callback with the text so far, once per segment
  * @param on_final Callback for final result (JSON)
  * @param on_error Callback for errors
  * @param user User data passed to callbacks
  */
 void speech_stt_transcribe_stream(const float *samples, int n_samples,
+                                   const speech_stt_options *options,
                                    stt_on_partial on_partial,
                                    stt_on_final on_final,
                                    stt_on_error on_error,
                                    void *user);
 
+/**
+ * Opaque handle for an incremental STT session. Not a pointer to memory:
+ * once closed, calls with it do nothing.
+ */
+typedef struct speech_stt_session speech_stt_session;
+
+/**
+ * Open an incremental transcription session for live audio.
+ *
+ * Callbacks fire on the thread calling push/flush. on_partial receives the
+ * committed text plus the still-tentative tail; on_final receives the JSON
+ * result of an utterance when speech_stt_session_flush is called.
+ *
+ * With final_model_path set the session is a cascade: partials come from the
+ * session's model, and each flushed utterance is re-decoded on the final
+ * model (loaded on demand), with the streaming text as its prompt.
+ *
+ * @param options Per-session overrides, or NULL
+ * @param final_model_path Model for the final pass, or NULL for none
+ * @return Session handle, or NULL if STT is not initialized or the final model cannot be loaded
+ */
+speech_stt_session *speech_stt_session_open(const speech_stt_options *options,
+                                            const char *final_model_path,
+                                            stt_on_partial on_partial,
+                                            stt_on_final on_final,
+                                            stt_on_error on_error,
+                                            void *user);
+
+/**
+ * Append audio to a session and re-decode the tail when enough new audio arrived.
+ *
+ * @param samples Audio samples (16kHz, mono, normalized -1.0 to 1.0)
+ * @param n_samples Number of samples
+ */
+void speech_stt_session_push(speech_stt_session *session, const float *samples, int n_samples);
+
+/**
+ * Finish the current utterance and deliver it via on_final.
+ * The session remains open for the next utterance.
+ */
+void speech_stt_session_flush(speech_stt_session *session);
+
+/**
+ * Close a session and release its resources. Safe from any thread: a push
+ * or flush running elsewhere finishes first, and no callback fires once
+ * this returns. May be called from the session's own callbacks.
+ */
+void speech_stt_session_close(speech_stt_session *session);
+
+/**
+ * Read a session's decode timings (since it opened).
+ *
+ * @param out_stats Receives 4 values: partial decodes, their total ms,
+ *                  final passes, their total ms
+ */
+void speech_stt_session_stats(speech_stt_session *session, int64_t *out_stats);
+
+/**
+ * Opaque handle for an always-on listener. Like a session handle, not a
+ * pointer to memory: once closed, calls with it do nothing.
+ */
+typedef struct speech_stt_listener speech_stt_listener;
+
+// Listener callbacks; times are ms of audio since listening started
+typedef void (*stt_on_speech_start)(int64_t time_ms, void *user);
+typedef void (*stt_on_utterance)(const char *json_result, void *user);
+
+/**
+ * Start always-on listening. Pushed audio goes into a lock-free ring; a
+ * listener thread endpoints it (energy against a tracked noise floor) and
+ * runs whisper only on completed utterances, with a short pre-roll.
+ *
+ * Callbacks fire on the listener thread. on_utterance receives the JSON
+ * result of each utterance, segment times counted from the start of
+ * listening; utterances that decode to no text are not reported.
+ *
+ * @param options Overrides applied to every utterance (a timeout applies per utterance), or NULL
+ * @param pre_roll_ms Audio kept from before speech was detected
+ * @param end_silence_ms Silence that ends an utterance
+ * @param min_speech_ms Shorter sounds are ignored
+ * @param max_utterance_ms Longer speech is delivered in pieces of this length
+ * @return Listener handle, or NULL if STT is not initialized
+ */
+speech_stt_listener *speech_stt_listener_open(const speech_stt_options *options,
+                                              int pre_roll_ms,
+                                              int end_silence_ms,
+                                              int min_speech_ms,
+                                              int max_utterance_ms,
+                                              stt_on_speech_start on_speech_start,
+                                              stt_on_utterance on_utterance,
+                                              stt_on_error on_error,
+                                              void *user);
+
+/**
+ * Queue audio for the listener. Never blocks or allocates, so it may be
+ * called from the audio thread; audio that does not fit is dropped.
+ *
+ * @param samples Audio samples (16kHz, mono, normalized -1.0 to 1.0)
+ * @param n_samples Number of samples
+ */
+void speech_stt_listener_push(speech_stt_listener *listener, const float *samples, int n_samples);
+
+/**
+ * Stop listening and release the listener. Unprocessed audio is discarded
+ * and a decode in progress is cancelled. Must not be called from a
+ * listener callback.
+ */
+void speech_stt_listener_close(speech_stt_listener *listener);
+
+// Batch callback: one call per input, in input order
+typedef void (*stt_on_batch_result)(int index, const char *json_result, void *user);
+
+/**
+ * Transcribe many independent clips in one call.
+ *
+ * Clips are spread over the state pool and short clips share a decode window.
+ * on_result is called once per clip, in input order, after all clips finish.
+ * A clip that could not be decoded gets an "error" field in its result.
+ *
+ * @param clips Audio buffers (16kHz, mono, normalized -1.0 to 1.0)
+ * @param clip_lengths Number of samples in each buffer
+ * @param n_clips Number of clips
+ * @param options Overrides applied to every clip, or NULL
+ * @param on_result Callback receiving each clip's JSON result
+ * @param user User data passed to the callback
+ */
+void speech_stt_transcribe_batch(const float *const *clips, const int *clip_lengths, int n_clips,
+                                 const speech_stt_options *options,
+                                 stt_on_batch_result on_result, void *user);
+
+/**
+ * Transcribe many WAV files in one call. Same delivery as speech_stt_transcribe_batch;
+ * a file that cannot be read or decoded yields an empty result with an "error" field.
+ */
+void speech_stt_transcribe_batch_files(const char *const *audio_paths, int n_paths,
+                                       const speech_stt_options *options,
+                                       stt_on_batch_result on_result, void *user);
+
+// One decode of a shared encoder pass (see speech_stt_transcribe_audio_tasks)
+typedef struct speech_stt_task {
+    const char *language;  // NULL: options' language; "auto": detected
+    int translate;         // -1: options' setting, 0: transcribe, 1: translate to English
+    const char *prompt;    // text the decoder is conditioned on, or NULL
+} speech_stt_task;
+
+/**
+ * Decode one clip several ways (e.g. transcription and English translation)
+ * from a single encoder pass per 30 s window.
+ *
+ * Decoding is greedy and without timestamps: each window yields one segment
+ * per task. on_result is called once per task, in task order, with the
+ * task's JSON result.
+ *
+ * @param samples Audio buffer (16kHz, mono, normalized -1.0 to 1.0)
+ * @param n_samples Number of samples
+ * @param tasks Decodes to run
+ * @param n_tasks Number of tasks
+ * @param options Defaults for every task (model, language, translate, timeout), or NULL
+ * @param on_result Callback receiving each task's JSON result
+ * @param user User data passed to the callback
+ */
+void speech_stt_transcribe_audio_tasks(const float *samples, int n_samples,
+                                       const speech_stt_task *tasks, int n_tasks,
+                                       const speech_stt_options *options,
+                                       stt_on_batch_result on_result, void *user);
+
+// Job callbacks: exactly one is called per submitted job, on a worker thread
+typedef void (*stt_on_job_result)(int64_t job_id, const char *json_result, void *user);
+typedef void (*stt_on_job_error)(int64_t job_id, const char *message, void *user);
+
+/* Job priorities: queued interactive jobs start before normal, normal before background */
+#define SPEECH_STT_PRIORITY_INTERACTIVE 0
+#define SPEECH_STT_PRIORITY_NORMAL      1
+#define SPEECH_STT_PRIORITY_BACKGROUND  2
+
+/**
+ * Queue a WAV file for transcription and return immediately.
+ *
+ * Jobs run on native workers (one per pooled state). With more than one
+ * worker, background jobs never occupy the last one.
+ *
+ * @param audio_path Path to WAV file
+ * @param priority SPEECH_STT_PRIORITY_*
+ * @param options Per-request overrides, or NULL
+ * @param on_result Receives the JSON result
+ * @param on_error Receives the error message ("Cancelled" if the job was cancelled)
+ * @param user User data passed to the callbacks
+ * @return Job id, or 0 if STT is not initialized (no callback is called)
+ */
+int64_t speech_stt_submit_transcription(const char *audio_path, int priority,
+                                        const speech_stt_options *options,
+                                        stt_on_job_result on_result, stt_on_job_error on_error,
+                                        void *user);
+
+/**
+ * Queue raw PCM audio for transcription. The samples are copied.
+ * Same delivery as speech_stt_submit_transcription.
+ */
+int64_t speech_stt_submit_transcription_audio(const float *samples, int n_samples, int priority,
+                                              const speech_stt_options *options,
+                                              stt_on_job_result on_result, stt_on_job_error on_error,
+                                              void *user);
+
+/**
+ * Cancel one job: a queued job is dropped, a running one stops as soon as possible.
+ * speech_stt_cancel cancels every job.
+ *
+ * @return false if the job already finished
+ */
+bool speech_stt_cancel_job(int64_t job_id);
+
+// Model load callback, called on the background loader thread
+typedef void (*stt_on_model_loaded)(const char *model_path, bool ok, void *user);
+
+/**
+ * Load another model on a background thread while transcriptions continue.
+ * Loaded models stay resident within the budget given to speech_stt_init.
+ *
+ * @param model_path Path to the .bin model file
+ * @param activate Make it the active model (used when options->model is NULL) once loaded
+ * @param on_loaded Optional completion callback; not called if STT is shut down before the load starts
+ * @param user User data passed to the callback
+ * @return false if STT is not initialized
+ */
+bool speech_stt_load_model(const char *model_path, bool activate,
+                           stt_on_model_loaded on_loaded, void *user);
+
+/**
+ * Drop a resident model. Requests still using it finish first.
+ *
+ * @return false if the model is not resident or is the active model
+ */
+bool speech_stt_unload_model(const char *model_path);
+
+/**
+ * Paths of the resident models, most recently used first, one per line.
+ * Caller must free with speech_free_string.
+ */
+char *speech_stt_resident_models(void);
+
 // ═══════════════════════════════════════════════════════════════
 //                            TTS API
 // ═══════════════════════════════════════════════════════════════
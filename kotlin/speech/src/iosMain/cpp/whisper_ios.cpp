@@ -3,24 +3,69 @@
  */
 
 #include "../c_interop/include/speech_ios.h"
+#include "stt_abort.h"
+#include "stt_batch.h"
+#include "stt_buckets.h"
+#include "stt_cache.h"
+#include "stt_commands.h"
+#include "stt_file.h"
+#include "stt_handles.h"
+#include "stt_jobs.h"
+#include "stt_lang.h"
+#include "stt_listener.h"
+#include "stt_models.h"
+#include "stt_options.h"
+#include "stt_repeat.h"
+#include "stt_session.h"
+#include "stt_tasks.h"
+#include "vad.h"
+#include "whisper_state_pool.h"
 #include "whisper.h"
 
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <cstring>
-#include <fstream>
 #include <sstream>
 
 // ═══════════════════════════════════════════════════════════════
 //                          GLOBAL STATE
 // ═══════════════════════════════════════════════════════════════
 
-static struct whisper_context *g_ctx = nullptr;
 static struct whisper_full_params g_params;
-static std::mutex g_mutex;
-static std::atomic<bool> g_cancel_requested{false};
+static SttCancelEpoch g_cancel;  // see SttAbort; requests never reset it
+
+// Resident models; requests hold their SttModelRef while they run.
+static std::unique_ptr<SttModelRegistry> g_models;
+
+// Lifetime of g_models: shared for transcriptions, exclusive for init and
+// shutdown. Concurrency comes from leasing pooled states.
+static std::shared_mutex g_mutex;
+
+// Bumped on every init / shutdown (see speech_stt_session_*).
+static std::atomic<uint64_t> g_ctx_generation{0};
+
+// Workers for the speech_stt_submit_* API; one per pooled state.
+static std::unique_ptr<SttJobQueue> g_jobs;
+
+// Optional cache of transcribeAudio results, keyed by audio fingerprint and
+// cache_config() of the request.
+static std::unique_ptr<SttResultCache> g_result_cache;
+
+// Ends decoder repetition loops; installed into g_params when enabled. Never
+// destroyed, so params copied before a re-init stay valid.
+static SttRepeatGuard g_repeat_guard;
+
+// Init command phrases; their grammar is compiled per model path on first use.
+static std::vector<std::string> g_commands;
+static std::map<std::string, std::shared_ptr<const SttCommandGrammar>> g_command_grammars;
+static std::mutex g_command_mutex;
 
 // Configuration
 static std::string g_language = "en";
@@ -28,6 +73,10 @@ static std::atomic<bool> g_translate{false};
 static std::atomic<int> g_max_threads{4};
 static std::atomic<bool> g_use_gpu{true};
 static std::atomic<bool> g_use_vad{true};
+static std::atomic<int> g_pool_size{1};
+static std::atomic<int> g_threads_per_state{4};
+static std::atomic<bool> g_long_form{false};
+static std::atomic<bool> g_pin_language{false};
 
 // Debug logging
 static bool debug_enabled() {
@@ -54,97 +103,172 @@ static char *strdup_safe(const std::string &str) {
     return result;
 }
 
-static bool read_wav_file(const std::string &path, std::vector<float> &samples, int &sample_rate) {
-    std::ifstream file(path, std::ios::binary);
-    if (!file.is_open()) {
-        LOG_ERROR("Failed to open WAV file: %s", path.c_str());
-        return false;
-    }
+static SttOptions read_options(const speech_stt_options *options) {
+    SttOptions o;
+    if (options == nullptr) return o;
+    if (options->language != nullptr) o.language = options->language;
+    o.translate = options->translate;
+    o.single_segment = options->single_segment;
+    o.no_context = options->no_context;
+    if (options->model != nullptr) o.model = options->model;
+    o.timeout_ms = options->timeout_ms;
+    o.split_channels = options->split_channels;
+    return o;
+}
 
-    // Read WAV header
-    char riff[4];
-    file.read(riff, 4);
-    if (std::strncmp(riff, "RIFF", 4) != 0) {
-        LOG_ERROR("Invalid WAV file: missing RIFF header");
-        return false;
-    }
+// Active model, or the one the request names. Caller must hold g_mutex.
+static SttModelRef request_model(const SttOptions &options) {
+    return g_models ? g_models->get(options.model) : nullptr;
+}
 
-    file.seekg(4, std::ios::cur); // Skip file size
+static std::string cache_config(const SttModel &model, const struct whisper_full_params &params) {
+    return model.path + "|" + params.language + "|" + (params.translate ? "1" : "0") + "|" +
+           (params.single_segment ? "1" : "0") + "|" + (params.no_context ? "1" : "0");
+}
 
-    char wave[4];
-    file.read(wave, 4);
-    if (std::strncmp(wave, "WAVE", 4) != 0) {
-        LOG_ERROR("Invalid WAV file: missing WAVE header");
-        return false;
+// Destroyed after g_mutex is released: that waits for running jobs and
+// background loads, whose callbacks may call back into this API.
+struct RetiredEngine {
+    std::unique_ptr<SttModelRegistry> models;
+    std::unique_ptr<SttJobQueue> jobs;  // stopped first: jobs use the models
+};
+
+// Caller must hold g_mutex exclusively.
+static void release_engine_locked(RetiredEngine &retired) {
+    retired.models = std::move(g_models);
+    retired.jobs = std::move(g_jobs);
+    g_ctx_generation++;
+    g_command_grammars.clear();
+
+    if (g_result_cache) {
+        g_result_cache->save();
+        g_result_cache.reset();
     }
+}
 
-    // Find fmt and data chunks
-    while (file.good()) {
-        char chunk_id[4];
-        file.read(chunk_id, 4);
-
-        uint32_t chunk_size;
-        file.read(reinterpret_cast<char*>(&chunk_size), 4);
-
-        if (std::strncmp(chunk_id, "fmt ", 4) == 0) {
-            uint16_t audio_format;
-            file.read(reinterpret_cast<char*>(&audio_format), 2);
-
-            uint16_t num_channels;
-            file.read(reinterpret_cast<char*>(&num_channels), 2);
-
-            uint32_t sr;
-            file.read(reinterpret_cast<char*>(&sr), 4);
-            sample_rate = sr;
-
-            file.seekg(chunk_size - 8, std::ios::cur);
-        } else if (std::strncmp(chunk_id, "data", 4) == 0) {
-            std::vector<int16_t> pcm(chunk_size / 2);
-            file.read(reinterpret_cast<char*>(pcm.data()), chunk_size);
-
-            samples.resize(pcm.size());
-            for (size_t i = 0; i < pcm.size(); i++) {
-                samples[i] = static_cast<float>(pcm[i]) / 32768.0f;
-            }
-            break;
-        } else {
-            file.seekg(chunk_size, std::ios::cur);
+// Sequential on one leased state, across the whole pool in long-form mode,
+// or one channel per pooled state with `split_channels`; once `abort` fires
+// the text so far comes back as a partial result.
+// Caller must hold g_mutex.
+static bool transcribe_wav_file(const SttModel &model, WavReader &reader,
+                                const struct whisper_full_params &request_params, bool split_channels,
+                                const SttAbort *abort, SttResult &result) {
+    // Language pre-pass: identify the language once from the opening seconds
+    // and pin it, so windows neither re-detect it nor disagree about it.
+    struct whisper_full_params params = request_params;
+    WhisperStatePool::reset_for_reuse(params);  // pooled states: no prompt history from other calls
+    result.language = params.language;
+    std::string language;
+    if (g_pin_language && stt_language_is_auto(params.language)) {
+        WhisperStatePool::Lease lid = model.pool->acquire();
+        if (lid) language = stt_detect_wav_language(model.ctx, lid.state(), reader, g_use_vad, params.n_threads, abort);
+        if (!language.empty()) {
+            params.language = language.c_str();
+            result.language = language;
         }
     }
 
-    return !samples.empty();
+    if (split_channels && reader.channels() > 1) {
+        return stt_transcribe_wav_channels(model.ctx, *model.pool, params, reader, g_use_vad, result, abort);
+    }
+    if (g_long_form && model.pool->size() > 1) {
+        return stt_transcribe_wav_parallel(model.ctx, *model.pool, params, reader, g_use_vad, result, abort);
+    }
+    WhisperStatePool::Lease lease = model.pool->acquire();
+    return lease && stt_transcribe_wav(model.ctx, lease.state(), params, reader, g_use_vad, result, abort);
 }
 
-static bool resample_to_16k(const std::vector<float> &input, int input_rate, std::vector<float> &output) {
-    if (input_rate == WHISPER_SAMPLE_RATE) {
-        output = input;
-        return true;
+// Decodes a 16 kHz buffer, VAD-packed and answered from the result cache
+// when possible. `abort` stops a decode in progress; its partial result is
+// not cached. Caller must hold g_mutex. Returns false on failure; no speech
+// is an empty result.
+static bool transcribe_samples(const SttModel &model, const float *samples, size_t n_samples,
+                               const struct whisper_full_params &request_params,
+                               const SttAbort *abort, SttResult &transcript) {
+    transcript = SttResult();
+    transcript.language = request_params.language;
+    transcript.duration_ms = (int64_t)n_samples * 1000 / WHISPER_SAMPLE_RATE;
+
+    // With VAD on, only the packed speech regions reach the encoder
+    const float *audio = samples;
+    size_t n_audio = n_samples;
+    VadPacked packed;
+    if (g_use_vad) {
+        vad_pack(audio, n_audio, vad_detect(audio, n_audio), packed);
+        if (packed.empty()) return true;
+        audio = packed.samples();
+        n_audio = packed.n_samples();
     }
 
-    double ratio = static_cast<double>(WHISPER_SAMPLE_RATE) / input_rate;
-    size_t output_size = static_cast<size_t>(input.size() * ratio);
-    output.resize(output_size);
+    struct whisper_full_params params = request_params;
+    WhisperStatePool::reset_for_reuse(params);  // pooled states: no prompt history from other calls
+    if (abort != nullptr) abort->install(params);
+
+    // Repeated input: answer from the result cache without running the model
+    uint64_t fingerprint = 0;
+    std::string config;
+    if (g_result_cache) {
+        fingerprint = stt_audio_fingerprint(audio, n_audio);
+        config = cache_config(model, params);
+        SttResult cached;
+        if (g_result_cache->lookup(fingerprint, config, cached)) {
+            // Cached in packed-audio time; the duration stays this request's
+            transcript.text = std::move(cached.text);
+            transcript.segments = std::move(cached.segments);
+            transcript.language = std::move(cached.language);
+            if (g_use_vad) vad_remap(packed, transcript.segments);
+            LOG_DEBUG("[CACHE] hit");
+            return true;
+        }
+    }
 
-    for (size_t i = 0; i < output_size; i++) {
-        double src_idx = i / ratio;
-        size_t idx0 = static_cast<size_t>(src_idx);
-        size_t idx1 = std::min(idx0 + 1, input.size() - 1);
-        double frac = src_idx - idx0;
-        output[i] = static_cast<float>(input[idx0] * (1.0 - frac) + input[idx1] * frac);
+    WhisperStatePool::Lease lease = model.pool->acquire();
+    if (!lease) return false;
+
+    // Language pre-pass on the opening seconds, pinned for the decode
+    std::string language;
+    if (g_pin_language && stt_language_is_auto(params.language)) {
+        std::vector<SttLanguageProb> languages;
+        if (stt_detect_language(model.ctx, lease.state(), audio, n_audio, false,
+                                params.n_threads, 1, abort, languages) && !languages.empty()) {
+            language = languages[0].language;
+            params.language = language.c_str();
+        }
     }
 
-    return true;
+    if (!stt_decode_buffer(model.ctx, lease.state(), params, audio, n_audio, false, transcript.segments, abort)) {
+        return false;
+    }
+    transcript.partial = abort != nullptr && abort->stop();
+
+    for (const SttSegment &seg : transcript.segments) {
+        transcript.text += seg.text;
+    }
+        SttResult cached;
+        if (g_result_cache->lookup(fingerprint, config, cached)) {
+            // Cached in packed-audio time; the duration stays this request's
+            transcript.text = std::move(cached.text);
+            transcript.segments = std::move(cached.segments);
+            transcript.language = std::move(cached.language);
+            if (g_use_vad) vad_remap(packed, transcript.segments);
+            LOG_DEBUG("[CACHE] hit");
+            return true;
+        }
 }
 
 static std::string build_json_result(const std::string &text,
-                                      const std::vector<std::tuple<std::string, int64_t, int64_t>> &segments,
+                                      const std::vector<std::tuple<std::string, int64_t, int64_t, int>> &segments,
                                       const std::string &language,
-                                      int64_t durationMs) {
+                                      int64_t durationMs,
+                                      bool partial = false,
+                                      const std::string &error = "") {
     std::ostringstream json;
     json << "{";
     json << "\"text\":\"" << text << "\",";
     json << "\"language\":\"" << language << "\",";
     json << "\"durationMs\":" << durationMs << ",";
+    json << "\"partial\":" << (partial ? "true" : "false") << ",";
+    if (!error.empty()) json << "\"error\":\"" << error << "\",";
     json << "\"segments\":[";
 
     for (size_t i = 0; i < segments.size(); i++) {
@@ -153,6 +277,7 @@ static std::string build_json_result(const std::string &text,
         json << "\"text\":\"" << std::get<0>(segments[i]) << "\",";
         json << "\"startMs\":" << std::get<1>(segments[i]) << ",";
         json << "\"endMs\":" << std::get<2>(segments[i]);
+        if (std::get<3>(segments[i]) >= 0) json << ",\"channel\":" << std::get<3>(segments[i]);
         json << "}";
     }
 
@@ -165,192 +290,289 @@ static std::string build_json_result(const std::string &text,
 // ═══════════════════════════════════════════════════════════════
 
 bool speech_stt_init(const char *model_path, const char *language,
-                     bool translate, int max_threads, bool use_gpu, bool use_vad) {
+                     bool translate, int max_threads, bool use_gpu, bool use_vad,
+                     int state_pool_size, int threads_per_state,
+                     bool persistent_state, bool long_form, bool warm_up,
+                     bool pin_language, int64_t result_cache_bytes,
+                     const char *result_cache_path, int64_t model_budget_bytes,
+                     bool stop_repetition_loops,
+                     const char *const *commands, int n_commands) {
 
-    std::lock_guard<std::mutex> lock(g_mutex);
+    RetiredEngine retired;  // destroyed after the lock is released
+    std::unique_lock<std::shared_mutex> lock(g_mutex);
 
-    // Shutdown existing context
-    if (g_ctx != nullptr) {
-        whisper_free(g_ctx);
-        g_ctx = nullptr;
-    }
+    // Shutdown existing models (waits for in-flight transcriptions)
+    release_engine_locked(retired);
 
     g_language = language ? language : "en";
     g_translate = translate;
     g_max_threads = max_threads;
     g_use_gpu = use_gpu;
     g_use_vad = use_vad;
+    g_pool_size = std::max(1, state_pool_size);
+    g_threads_per_state = threads_per_state > 0
+        ? threads_per_state
+        : std::max(1, max_threads / g_pool_size);
+    g_long_form = long_form;
+    g_pin_language = pin_language;
+    g_commands.clear();
+    for (int i = 0; i < n_commands; i++) g_commands.push_back(commands[i] != nullptr ? commands[i] : "");
 
     LOG_DEBUG("Initializing Whisper with model: %s", model_path);
-
-    struct whisper_context_params ctx_params = whisper_context_default_params();
-    ctx_params.use_gpu = use_gpu;
-
-    g_ctx = whisper_init_from_file_with_params(model_path, ctx_params);
-    if (g_ctx == nullptr) {
-        LOG_ERROR("Failed to initialize Whisper model");
-        return false;
-    }
+    LOG_DEBUG("State pool: %d state(s) x %d thread(s)", (int)g_pool_size, (int)g_threads_per_state);
 
     g_params = whisper_full_default_params(WHISPER_SAMPLING_GREEDY);
     g_params.language = g_language.c_str();
     g_params.translate = translate;
-    g_params.n_threads = max_threads;
+    g_params.n_threads = g_threads_per_state;
     g_params.no_timestamps = false;
     g_params.print_special = false;
     g_params.print_progress = false;
     g_params.print_realtime = false;
     g_params.print_timestamps = false;
 
+    // Every model loaded from here on gets a pool shaped like this (no
+    // default state: all transcriptions run on pooled states), optionally
+    // preallocated and warmed up so its first request is not a cold start
+    SttModelLoadConfig load_config;
+    load_config.ctx_params.use_gpu = use_gpu;
+    load_config.pool_size = g_pool_size;
+    load_config.preallocate = persistent_state;
+    load_config.warm_up = warm_up;
+    load_config.warm_up_params = g_params;
+    g_models = std::make_unique<SttModelRegistry>((size_t)std::max<int64_t>(model_budget_bytes, 0), load_config);
+
+    // After the warm-up copy, so warm-up decodes do not show in the stats
+    g_repeat_guard.reset_stats();
+    if (stop_repetition_loops) g_repeat_guard.install(g_params);
+
+    long t_load = now_ms();
+    SttModelRef model = g_models->load(model_path);
+    if (!model) {
+        LOG_ERROR("Failed to initialize Whisper model");
+        g_models.reset();
+        return false;
+    }
+    g_models->set_active(model);
+    LOG_DEBUG("[LATENCY] model load: %ld ms", now_ms() - t_load);
+
+    g_jobs = std::make_unique<SttJobQueue>(g_pool_size);
+
+    if (result_cache_bytes > 0) {
+        g_result_cache = std::make_unique<SttResultCache>(
+            (size_t)result_cache_bytes, result_cache_path ? result_cache_path : "");
+    }
+
     LOG_DEBUG("Whisper model initialized successfully");
     return true;
 }
 
-char *speech_stt_transcribe(const char *audio_path) {
-    std::lock_guard<std::mutex> lock(g_mutex);
+char *speech_stt_transcribe(const char *audio_path, const speech_stt_options *options) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
 
-    if (g_ctx == nullptr) {
+    SttOptions request = read_options(options);
+    SttModelRef model = request_model(request);
+    if (!model) {
         LOG_ERROR("Whisper not initialized");
         return strdup_safe("");
     }
 
-    g_cancel_requested = false;
+    SttAbort abort(&g_cancel, request.timeout_ms);
 
-    std::vector<float> samples;
-    int sample_rate;
-    if (!read_wav_file(audio_path, samples, sample_rate)) {
+    WavReader reader;
+    if (!reader.open(audio_path)) {
         return strdup_safe("");
     }
 
-    std::vector<float> samples_16k;
-    resample_to_16k(samples, sample_rate, samples_16k);
-
-    if (whisper_full(g_ctx, g_params, samples_16k.data(), samples_16k.size()) != 0) {
+    SttResult transcript;
+    if (!transcribe_wav_file(*model, reader, request.apply(g_params), request.split_channels > 0, &abort,
+                             transcript)) {
         LOG_ERROR("Whisper inference failed");
         return strdup_safe("");
     }
-
-    std::string result;
-    int n_segments = whisper_full_n_segments(g_ctx);
-    for (int i = 0; i < n_segments; i++) {
-        const char *text = whisper_full_get_segment_text(g_ctx, i);
-        if (text) {
-            result += text;
-        }
-    }
+    const std::string &result = transcript.text;
 
     return strdup_safe(result);
 }
 
-char *speech_stt_transcribe_detailed(const char *audio_path) {
-    std::lock_guard<std::mutex> lock(g_mutex);
+char *speech_stt_transcribe_detailed(const char *audio_path, const speech_stt_options *options) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
 
-    if (g_ctx == nullptr) {
+    SttOptions request = read_options(options);
+    SttModelRef model = request_model(request);
+    if (!model) {
         LOG_ERROR("Whisper not initialized");
         return strdup_safe("{\"text\":\"\",\"segments\":[],\"language\":\"en\",\"durationMs\":0}");
     }
 
-    g_cancel_requested = false;
+    SttAbort abort(&g_cancel, request.timeout_ms);
 
-    std::vector<float> samples;
-    int sample_rate;
-    if (!read_wav_file(audio_path, samples, sample_rate)) {
+    WavReader reader;
+    if (!reader.open(audio_path)) {
         return strdup_safe("{\"text\":\"\",\"segments\":[],\"language\":\"en\",\"durationMs\":0}");
     }
 
-    std::vector<float> samples_16k;
-    resample_to_16k(samples, sample_rate, samples_16k);
-
-    if (whisper_full(g_ctx, g_params, samples_16k.data(), samples_16k.size()) != 0) {
+    SttResult transcript;
+    if (!transcribe_wav_file(*model, reader, request.apply(g_params), request.split_channels > 0, &abort,
+                             transcript)) {
         LOG_ERROR("Whisper inference failed");
         return strdup_safe("{\"text\":\"\",\"segments\":[],\"language\":\"en\",\"durationMs\":0}");
     }
 
-    std::string fullText;
-    std::vector<std::tuple<std::string, int64_t, int64_t>> segments;
-
-    int n_segments = whisper_full_n_segments(g_ctx);
-    for (int i = 0; i < n_segments; i++) {
-        const char *text = whisper_full_get_segment_text(g_ctx, i);
-        int64_t t0 = whisper_full_get_segment_t0(g_ctx, i) * 10;
-        int64_t t1 = whisper_full_get_segment_t1(g_ctx, i) * 10;
-
-        if (text) {
-            fullText += text;
-            segments.emplace_back(text, t0, t1);
-        }
+    const std::string &fullText = transcript.text;
+    std::vector<std::tuple<std::string, int64_t, int64_t, int>> segments;
+    for (const SttSegment &seg : transcript.segments) {
+        segments.emplace_back(seg.text, seg.t0_ms, seg.t1_ms, seg.channel);
     }
 
-    int64_t durationMs = samples_16k.size() * 1000 / WHISPER_SAMPLE_RATE;
-    std::string json = build_json_result(fullText, segments, g_language, durationMs);
+    int64_t durationMs = transcript.duration_ms;
+    std::string json = build_json_result(fullText, segments, transcript.language, durationMs, transcript.partial);
 
     return strdup_safe(json);
 }
 
-char *speech_stt_transcribe_audio(const float *samples, int n_samples) {
-    std::lock_guard<std::mutex> lock(g_mutex);
+char *speech_stt_transcribe_audio(const float *samples, int n_samples,
+                                  const speech_stt_options *options) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
 
-    if (g_ctx == nullptr) {
+    SttOptions request = read_options(options);
+    SttModelRef model = request_model(request);
+    if (!model) {
         LOG_ERROR("Whisper not initialized");
         return strdup_safe("");
     }
 
-    g_cancel_requested = false;
+    SttAbort abort(&g_cancel, request.timeout_ms);
 
-    if (whisper_full(g_ctx, g_params, samples, n_samples) != 0) {
+    SttResult transcript;
+    if (!transcribe_samples(*model, samples, (size_t)n_samples, request.apply(g_params), &abort, transcript)) {
         LOG_ERROR("Whisper inference failed");
         return strdup_safe("");
     }
+    return strdup_safe(transcript.text);
+}
 
-    std::string result;
-    int n_segments = whisper_full_n_segments(g_ctx);
-    for (int i = 0; i < n_segments; i++) {
-        const char *text = whisper_full_get_segment_text(g_ctx, i);
-        if (text) {
-            result += text;
-        }
+char *speech_stt_detect_language(const float *samples, int n_samples, int top_n,
+                                 const speech_stt_options *options) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    SttOptions request = read_options(options);
+    SttModelRef model = request_model(request);
+    if (!model) {
+        LOG_ERROR("Whisper not initialized");
+        return strdup_safe("[]");
     }
 
-    return strdup_safe(result);
+    SttAbort abort(&g_cancel, request.timeout_ms);
+    struct whisper_full_params params = request.apply(g_params);
+    std::vector<SttLanguageProb> languages;
+    WhisperStatePool::Lease lease = model->pool->acquire();
+    if (lease) {
+        stt_detect_language(model->ctx, lease.state(), samples, (size_t)n_samples, g_use_vad,
+                            params.n_threads, top_n, &abort, languages);
+    }
+
+    std::ostringstream json;
+    json << "[";
+    for (size_t i = 0; i < languages.size(); i++) {
+        if (i > 0) json << ",";
+        json << "{\"language\":\"" << languages[i].language << "\",";
+        json << "\"probability\":" << languages[i].probability << "}";
+    }
+    json << "]";
+    return strdup_safe(json.str());
+}
+
+// Caller must hold g_mutex.
+static std::shared_ptr<const SttCommandGrammar> init_command_grammar(const SttModel &model) {
+    std::lock_guard<std::mutex> lock(g_command_mutex);
+    std::shared_ptr<const SttCommandGrammar> &grammar = g_command_grammars[model.path];
+    if (!grammar) grammar = std::make_shared<SttCommandGrammar>(model.ctx, g_commands);
+    return grammar;
+}
+
+int speech_stt_recognize_command(const float *samples, int n_samples,
+                                 const char *const *commands, int n_commands,
+                                 const speech_stt_options *options) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    SttOptions request = read_options(options);
+    SttModelRef model = request_model(request);
+    if (!model) {
+        LOG_ERROR("Whisper not initialized");
+        return -1;
+    }
+
+    std::shared_ptr<const SttCommandGrammar> grammar;
+    if (commands != nullptr) {
+        std::vector<std::string> phrases;
+        for (int i = 0; i < n_commands; i++) phrases.push_back(commands[i] != nullptr ? commands[i] : "");
+        grammar = std::make_shared<SttCommandGrammar>(model->ctx, phrases);
+    } else {
+        grammar = init_command_grammar(*model);
+    }
+    if (grammar->size() == 0 || samples == nullptr) return -1;
+
+    SttAbort abort(&g_cancel, request.timeout_ms);
+
+    WhisperStatePool::Lease lease = model->pool->acquire();
+    int index = lease ? stt_recognize_command(model->ctx, lease.state(), request.apply(g_params), *grammar,
+                                              samples, (size_t)std::max(n_samples, 0), g_use_vad, &abort)
+                      : -2;
+    return index >= 0 ? index : -1;
 }
 
 void speech_stt_transcribe_stream(const float *samples, int n_samples,
+                                   const speech_stt_options *options,
                                    stt_on_partial on_partial,
                                    stt_on_final on_final,
                                    stt_on_error on_error,
                                    void *user) {
 
-    std::lock_guard<std::mutex> lock(g_mutex);
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
 
-    if (g_ctx == nullptr) {
+    SttOptions request = read_options(options);
+    SttModelRef model = request_model(request);
+    if (!model) {
         if (on_error) on_error("Whisper not initialized", user);
         return;
     }
 
-    g_cancel_requested = false;
+    SttAbort abort(&g_cancel, request.timeout_ms);
+
+    struct whisper_full_params params = request.apply(g_params);
+    params.audio_ctx = stt_bucket_audio_ctx(model->ctx, (size_t)std::max(n_samples, 0));
+    abort.install(params);
 
-    if (whisper_full(g_ctx, g_params, samples, n_samples) != 0) {
+    WhisperStatePool::Lease lease = model->pool->acquire();
+    bool ok = lease && (whisper_full_with_state(model->ctx, lease.state(), params, samples, n_samples) == 0 ||
+                        abort.expired());
+    if (abort.cancelled()) {
+        if (on_error) on_error("Cancelled", user);
+        return;
+    }
+    if (!ok) {
         if (on_error) on_error("Transcription failed", user);
         return;
     }
 
     std::string fullText;
-    std::vector<std::tuple<std::string, int64_t, int64_t>> segments;
+    std::vector<std::tuple<std::string, int64_t, int64_t, int>> segments;
 
-    int n_seg = whisper_full_n_segments(g_ctx);
+    int n_seg = whisper_full_n_segments_from_state(lease.state());
     for (int i = 0; i < n_seg; i++) {
-        if (g_cancel_requested) {
+        if (abort.cancelled()) {
             if (on_error) on_error("Cancelled", user);
             return;
         }
 
-        const char *text = whisper_full_get_segment_text(g_ctx, i);
-        int64_t t0 = whisper_full_get_segment_t0(g_ctx, i) * 10;
-        int64_t t1 = whisper_full_get_segment_t1(g_ctx, i) * 10;
+        const char *text = whisper_full_get_segment_text_from_state(lease.state(), i);
+        int64_t t0 = whisper_full_get_segment_t0_from_state(lease.state(), i) * 10;
+        int64_t t1 = whisper_full_get_segment_t1_from_state(lease.state(), i) * 10;
 
         if (text) {
             fullText += text;
-            segments.emplace_back(text, t0, t1);
+            segments.emplace_back(text, t0, t1, -1);
 
             if (on_partial) {
                 on_partial(fullText.c_str(), user);
@@ -359,25 +581,541 @@ void speech_stt_transcribe_stream(const float *samples, int n_samples,
     }
 
     int64_t durationMs = n_samples * 1000 / WHISPER_SAMPLE_RATE;
-    std::string json = build_json_result(fullText, segments, g_language, durationMs);
+    std::string json = build_json_result(fullText, segments, params.language, durationMs, abort.expired());
 
     if (on_final) {
         on_final(json.c_str(), user);
     }
 }
 
+void speech_stt_cache_stats(int64_t *out_stats) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    SttCacheStats stats;
+    if (g_result_cache) stats = g_result_cache->stats();
+    out_stats[0] = stats.hits;
+    out_stats[1] = stats.misses;
+    out_stats[2] = stats.evictions;
+    out_stats[3] = stats.entries;
+    out_stats[4] = stats.bytes;
+}
+
+void speech_stt_loop_stats(int64_t *out_stats) {
+    SttLoopStats stats = g_repeat_guard.stats();
+    out_stats[0] = stats.decodes;
+    out_stats[1] = stats.loops;
+}
+
+void speech_stt_cache_clear(void) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    if (g_result_cache) g_result_cache->clear();
+}
+
 void speech_stt_cancel(void) {
-    g_cancel_requested = true;
+    g_cancel.cancel();
+
+    // Every queued and running job too; see speech_stt_cancel_job for one
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+    if (g_jobs) g_jobs->cancel_all();
 }
 
 void speech_stt_shutdown(void) {
-    std::lock_guard<std::mutex> lock(g_mutex);
+    RetiredEngine retired;  // destroyed after the lock is released
+    std::unique_lock<std::shared_mutex> lock(g_mutex);
 
-    if (g_ctx != nullptr) {
+    if (g_models) {
         LOG_DEBUG("Shutting down Whisper");
-        whisper_free(g_ctx);
-        g_ctx = nullptr;
     }
+    release_engine_locked(retired);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                    STREAMING SESSIONS
+// ═══════════════════════════════════════════════════════════════
+
+// Behind a speech_stt_session handle (see stt_handles.h): the handle is an
+// id in g_sessions cast to the opaque pointer type, never dereferenced.
+struct IosSttSession {
+    SttModelRef model;  // kept alive while the session is open
+    SttModelRef final_model;  // cascade only
+    std::unique_ptr<SttSession> session;
+    SttSessionCallbacks callbacks;
+    uint64_t generation;
+    SttCallGate gate;  // push/flush/stats one at a time; close waits for them
+};
+
+static SttHandleTable<IosSttSession> g_sessions;
+
+static std::shared_ptr<IosSttSession> find_session(speech_stt_session *handle) {
+    return g_sessions.get((int64_t)(uintptr_t)handle);
+}
+
+// Caller must hold g_mutex.
+static bool session_context_valid(IosSttSession *s) {
+    if (g_models && s->generation == g_ctx_generation) return true;
+    if (s->callbacks.on_error) {
+        s->callbacks.on_error("STT was re-initialized or shut down; open a new session");
+    }
+    return false;
+}
+
+speech_stt_session *speech_stt_session_open(const speech_stt_options *options,
+                                            const char *final_model_path,
+                                            stt_on_partial on_partial,
+                                            stt_on_final on_final,
+                                            stt_on_error on_error,
+                                            void *user) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    SttOptions request = read_options(options);
+    SttModelRef model = request_model(request);
+    if (!model) {
+        LOG_ERROR("Whisper not initialized");
+        return nullptr;
+    }
+
+    SttModelRef final_model;
+    if (final_model_path != nullptr && final_model_path[0] != '\0') {
+        final_model = g_models->get(final_model_path);
+        if (!final_model) {
+            LOG_ERROR("[CASCADE] cannot load final model %s", final_model_path);
+            return nullptr;
+        }
+    }
+
+    SttSessionConfig session_config;
+    session_config.pin_language = g_pin_language;
+    struct whisper_full_params params = request.apply(g_params);
+    auto s = std::make_shared<IosSttSession>();
+    s->session.reset(new SttSession(model->ctx, params, params.language, session_config));
+    if (!s->session->ok()) return nullptr;
+
+    if (final_model) s->session->set_final_model(final_model->ctx, final_model->pool.get());
+
+    s->model = model;
+    s->final_model = final_model;
+    s->generation = g_ctx_generation.load();
+    // Nothing is reported once the session was closed (from its own callback)
+    IosSttSession *self = s.get();
+    s->callbacks.on_partial = [self, on_partial, user](const std::string &text) {
+        if (on_partial && !self->gate.closed()) on_partial(text.c_str(), user);
+    };
+    s->callbacks.on_final = [self, on_final, user](const SttResult &result) {
+        if (!on_final || self->gate.closed()) return;
+        std::vector<std::tuple<std::string, int64_t, int64_t, int>> segments;
+        for (const SttSegment &seg : result.segments) {
+            segments.emplace_back(seg.text, seg.t0_ms, seg.t1_ms, seg.channel);
+        }
+        std::string json = build_json_result(result.text, segments, result.language, result.duration_ms);
+        on_final(json.c_str(), user);
+    };
+    s->callbacks.on_error = [self, on_error, user](const std::string &message) {
+        if (on_error && !self->gate.closed()) on_error(message.c_str(), user);
+    };
+
+    int64_t id = g_sessions.add(std::move(s));
+    LOG_DEBUG("Streaming session %lld opened", (long long)id);
+    return reinterpret_cast<speech_stt_session *>((uintptr_t)id);
+}
+
+void speech_stt_session_push(speech_stt_session *session, const float *samples, int n_samples) {
+    std::shared_ptr<IosSttSession> s = find_session(session);
+    if (!s) return;
+    SttCallGate::Call call(s->gate);
+    if (!call) return;
+
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+    if (!session_context_valid(s.get())) return;
+
+    s->session->push(samples, n_samples, s->callbacks);
+}
+
+void speech_stt_session_flush(speech_stt_session *session) {
+    std::shared_ptr<IosSttSession> s = find_session(session);
+    if (!s) return;
+    SttCallGate::Call call(s->gate);
+    if (!call) return;
+
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+    if (!session_context_valid(s.get())) return;
+
+    s->session->flush(s->callbacks);
+}
+
+void speech_stt_session_close(speech_stt_session *session) {
+    std::shared_ptr<IosSttSession> s = g_sessions.remove((int64_t)(uintptr_t)session);
+    if (!s) return;
+
+    // Waits for a push/flush on another thread; the session is freed with
+    // the last reference (here, or when a push this is called from returns)
+    s->gate.close();
+    LOG_DEBUG("Streaming session %lld closed", (long long)(uintptr_t)session);
+}
+
+void speech_stt_session_stats(speech_stt_session *session, int64_t *out_stats) {
+    SttSessionStats stats;
+    std::shared_ptr<IosSttSession> s = find_session(session);
+    if (s) {
+        SttCallGate::Call call(s->gate);
+        if (call) stats = s->session->stats();
+    }
+    out_stats[0] = stats.partial_decodes;
+    out_stats[1] = stats.partial_ms;
+    out_stats[2] = stats.final_passes;
+    out_stats[3] = stats.final_ms;
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                    ALWAYS-ON LISTENING
+// ═══════════════════════════════════════════════════════════════
+
+// Behind a speech_stt_listener handle: an id in g_listeners, like sessions.
+struct IosSttListener {
+    SttOptions options;
+    uint64_t generation;
+    std::atomic<bool> closing{false};
+    std::unique_ptr<SttListener> listener;
+};
+
+static SttHandleTable<IosSttListener> g_listeners;
+
+// Returns the error message, or "" on success. Takes g_mutex (shared) for
+// the decode only, so callbacks may call back into the bridge.
+static std::string transcribe_utterance(IosSttListener *s, const std::vector<float> &audio, SttResult &result) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+    if (s->generation != g_ctx_generation) return "STT was re-initialized or shut down; start listening again";
+    SttModelRef model = request_model(s->options);
+    if (!model) return "Whisper not initialized";
+    SttAbort abort(&s->closing, &g_cancel, s->options.timeout_ms);  // per utterance
+    if (!transcribe_samples(*model, audio.data(), audio.size(), s->options.apply(g_params), &abort, result)) {
+        return "Transcription failed";
+    }
+    return "";
+}
+
+speech_stt_listener *speech_stt_listener_open(const speech_stt_options *options,
+                                              int pre_roll_ms,
+                                              int end_silence_ms,
+                                              int min_speech_ms,
+                                              int max_utterance_ms,
+                                              stt_on_speech_start on_speech_start,
+                                              stt_on_utterance on_utterance,
+                                              stt_on_error on_error,
+                                              void *user) {
+    auto s = std::make_shared<IosSttListener>();
+    s->options = read_options(options);
+    {
+        std::shared_lock<std::shared_mutex> lock(g_mutex);
+        if (!request_model(s->options)) {
+            LOG_ERROR("Whisper not initialized");
+            return nullptr;
+        }
+        s->generation = g_ctx_generation;
+    }
+
+    SttListenerConfig config;
+    config.pre_roll_ms = pre_roll_ms;
+    config.end_silence_ms = end_silence_ms;
+    config.min_speech_ms = min_speech_ms;
+    config.max_utterance_ms = max_utterance_ms;
+
+    SttListenerCallbacks callbacks;
+    callbacks.on_speech_start = [on_speech_start, user](int64_t start_ms) {
+        if (on_speech_start) on_speech_start(start_ms, user);
+    };
+    IosSttListener *self = s.get();  // outlives its listener thread
+    callbacks.on_utterance = [self, on_utterance, on_error, user](std::vector<float> &&audio, int64_t start_ms) {
+        SttResult result;
+        std::string error = transcribe_utterance(self, audio, result);
+        if (self->closing) return;
+        if (!error.empty()) {
+            if (on_error) on_error(error.c_str(), user);
+            return;
+        }
+        if (result.text.empty() || !on_utterance) return;
+
+        std::vector<std::tuple<std::string, int64_t, int64_t, int>> segments;
+        for (const SttSegment &seg : result.segments) {
+            segments.emplace_back(seg.text, seg.t0_ms + start_ms, seg.t1_ms + start_ms, seg.channel);
+        }
+        std::string json = build_json_result(result.text, segments, result.language, result.duration_ms,
+                                             result.partial);
+        on_utterance(json.c_str(), user);
+    };
+
+    s->listener.reset(new SttListener(config, std::move(callbacks)));
+    int64_t id = g_listeners.add(std::move(s));
+    LOG_DEBUG("Listener %lld opened", (long long)id);
+    return reinterpret_cast<speech_stt_listener *>((uintptr_t)id);
+}
+
+void speech_stt_listener_push(speech_stt_listener *listener, const float *samples, int n_samples) {
+    if (samples == nullptr || n_samples <= 0) return;
+    std::shared_ptr<IosSttListener> s = g_listeners.get((int64_t)(uintptr_t)listener);
+    if (!s) return;
+    s->listener->push(samples, (size_t)n_samples);
+}
+
+void speech_stt_listener_close(speech_stt_listener *listener) {
+    std::shared_ptr<IosSttListener> s = g_listeners.remove((int64_t)(uintptr_t)listener);
+    if (!s) return;
+
+    // Not under g_mutex: the listener thread may be waiting for it. A push
+    // still running on the audio thread keeps the listener alive until it
+    // returns; the stopped listener just ignores its audio.
+    s->closing = true;
+    s->listener->stop();
+    LOG_DEBUG("Listener %lld closed", (long long)(uintptr_t)listener);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                         BATCH
+// ═══════════════════════════════════════════════════════════════
+
+// `language` null: each result's own language.
+static void deliver_batch(std::vector<SttResult> &results, const char *language,
+                          stt_on_batch_result on_result, void *user) {
+    if (!on_result) return;
+    for (size_t i = 0; i < results.size(); i++) {
+        std::vector<std::tuple<std::string, int64_t, int64_t, int>> segments;
+        for (const SttSegment &seg : results[i].segments) {
+            segments.emplace_back(seg.text, seg.t0_ms, seg.t1_ms, seg.channel);
+        }
+        std::string json = build_json_result(results[i].text, segments,
+                                             language != nullptr ? language : results[i].language.c_str(),
+                                             results[i].duration_ms, results[i].partial, results[i].error);
+        on_result((int)i, json.c_str(), user);
+    }
+}
+
+void speech_stt_transcribe_batch(const float *const *clips, const int *clip_lengths, int n_clips,
+                                 const speech_stt_options *options,
+                                 stt_on_batch_result on_result, void *user) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    std::vector<SttResult> results((size_t)std::max(n_clips, 0));
+    SttOptions request = read_options(options);
+    SttModelRef model = request_model(request);
+    if (!model) {
+        LOG_ERROR("Whisper not initialized");
+        deliver_batch(results, "en", on_result, user);
+        return;
+    }
+
+    SttAbort abort(&g_cancel, request.timeout_ms);
+
+    std::vector<SttClip> views(results.size());
+    for (size_t i = 0; i < views.size(); i++) {
+        if (clips[i] != nullptr && clip_lengths[i] > 0) views[i] = {clips[i], (size_t)clip_lengths[i]};
+    }
+
+    struct whisper_full_params params = request.apply(g_params);
+    results = stt_transcribe_batch(model->ctx, *model->pool, params, views, g_use_vad, &abort);
+    deliver_batch(results, params.language, on_result, user);
+}
+
+void speech_stt_transcribe_batch_files(const char *const *audio_paths, int n_paths,
+                                       const speech_stt_options *options,
+                                       stt_on_batch_result on_result, void *user) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    std::vector<SttResult> results((size_t)std::max(n_paths, 0));
+    SttOptions request = read_options(options);
+    SttModelRef model = request_model(request);
+    if (!model) {
+        LOG_ERROR("Whisper not initialized");
+        deliver_batch(results, "en", on_result, user);
+        return;
+    }
+
+    SttAbort abort(&g_cancel, request.timeout_ms);
+
+    std::vector<std::string> paths(results.size());
+    for (size_t i = 0; i < paths.size(); i++) {
+        if (audio_paths[i] != nullptr) paths[i] = audio_paths[i];
+    }
+
+    struct whisper_full_params params = request.apply(g_params);
+    results = stt_transcribe_batch_files(model->ctx, *model->pool, params, paths, g_use_vad, &abort);
+    deliver_batch(results, params.language, on_result, user);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                ENCODE ONCE, DECODE MANY
+// ═══════════════════════════════════════════════════════════════
+
+void speech_stt_transcribe_audio_tasks(const float *samples, int n_samples,
+                                       const speech_stt_task *tasks, int n_tasks,
+                                       const speech_stt_options *options,
+                                       stt_on_batch_result on_result, void *user) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    std::vector<SttTask> decodes((size_t)std::max(n_tasks, 0));
+    for (size_t i = 0; i < decodes.size(); i++) {
+        if (tasks[i].language != nullptr) decodes[i].language = tasks[i].language;
+        decodes[i].translate = tasks[i].translate;
+        if (tasks[i].prompt != nullptr) decodes[i].prompt = tasks[i].prompt;
+    }
+
+    std::vector<SttResult> results(decodes.size());
+    SttOptions request = read_options(options);
+    SttModelRef model = request_model(request);
+    if (!model) {
+        LOG_ERROR("Whisper not initialized");
+        deliver_batch(results, "en", on_result, user);
+        return;
+    }
+
+    SttAbort abort(&g_cancel, request.timeout_ms);
+
+    struct whisper_full_params params = request.apply(g_params);
+    WhisperStatePool::Lease lease = model->pool->acquire();
+    bool ok = lease && samples != nullptr &&
+              stt_transcribe_tasks(model->ctx, lease.state(), params, samples, (size_t)std::max(n_samples, 0),
+                                   g_use_vad, decodes, results, &abort);
+    lease.release();
+    if (!ok) {
+        LOG_ERROR("[TASKS] transcription failed");
+        results.assign(decodes.size(), SttResult());
+        deliver_batch(results, params.language, on_result, user);
+        return;
+    }
+    deliver_batch(results, nullptr, on_result, user);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                      ASYNCHRONOUS JOBS
+// ═══════════════════════════════════════════════════════════════
+
+using JobBody = std::function<bool(const SttModel &model, const struct whisper_full_params &params,
+                                   const SttAbort &abort, SttResult &result)>;
+
+// Queues `body`; exactly one of on_result / on_error is called for the job,
+// on a worker thread and outside g_mutex.
+static int64_t submit_job(int priority, const speech_stt_options *options, JobBody body,
+                          stt_on_job_result on_result, stt_on_job_error on_error, void *user) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    if (!g_jobs) {
+        LOG_ERROR("Whisper not initialized");
+        return 0;
+    }
+
+    SttOptions request = read_options(options);
+    const uint64_t generation = g_ctx_generation;
+    auto report = [on_result, on_error, user](int64_t id, const SttResult &result, const std::string &error) {
+        if (error.empty()) {
+            if (!on_result) return;
+            std::vector<std::tuple<std::string, int64_t, int64_t, int>> segments;
+            for (const SttSegment &seg : result.segments) {
+                segments.emplace_back(seg.text, seg.t0_ms, seg.t1_ms, seg.channel);
+            }
+            std::string json = build_json_result(result.text, segments, result.language, result.duration_ms,
+                                                 result.partial);
+            on_result(id, json.c_str(), user);
+        } else if (on_error) {
+            on_error(id, error.c_str(), user);
+        }
+    };
+
+    auto p = (SttJobPriority)std::min(std::max(priority, (int)STT_PRIORITY_INTERACTIVE),
+                                      (int)STT_PRIORITY_BACKGROUND);
+    return g_jobs->submit(p,
+        [generation, request, body, report](int64_t id, const std::atomic<bool> &cancel) {
+            SttResult result;
+            std::string error;
+            {
+                std::shared_lock<std::shared_mutex> job_lock(g_mutex);
+                SttModelRef model;
+                if (generation != g_ctx_generation) {
+                    error = "STT was re-initialized or shut down";
+                } else if (!(model = request_model(request))) {
+                    error = "Whisper not initialized";
+                } else if (!body(*model, request.apply(g_params), SttAbort(&cancel, request.timeout_ms), result)) {
+                    error = cancel ? "Cancelled" : "Transcription failed";
+                } else if (cancel) {
+                    error = "Cancelled";
+                }
+            }
+            report(id, result, error);
+        },
+        [report](int64_t id) { report(id, SttResult(), "Cancelled"); });
+}
+
+int64_t speech_stt_submit_transcription(const char *audio_path, int priority,
+                                        const speech_stt_options *options,
+                                        stt_on_job_result on_result, stt_on_job_error on_error,
+                                        void *user) {
+    std::string path = audio_path ? audio_path : "";
+    bool split_channels = read_options(options).split_channels > 0;
+    return submit_job(priority, options,
+        [path, split_channels](const SttModel &model, const struct whisper_full_params &params,
+                               const SttAbort &abort, SttResult &result) {
+            WavReader reader;
+            return reader.open(path) && transcribe_wav_file(model, reader, params, split_channels, &abort, result);
+        },
+        on_result, on_error, user);
+}
+
+int64_t speech_stt_submit_transcription_audio(const float *samples, int n_samples, int priority,
+                                              const speech_stt_options *options,
+                                              stt_on_job_result on_result, stt_on_job_error on_error,
+                                              void *user) {
+    // Copied: the job outlives this call
+    auto audio = std::make_shared<std::vector<float>>(samples, samples + std::max(n_samples, 0));
+    return submit_job(priority, options,
+        [audio](const SttModel &model, const struct whisper_full_params &params,
+                const SttAbort &abort, SttResult &result) {
+            return transcribe_samples(model, audio->data(), audio->size(), params, &abort, result);
+        },
+        on_result, on_error, user);
+}
+
+bool speech_stt_cancel_job(int64_t job_id) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    return g_jobs && g_jobs->cancel(job_id);
+}
+
+// ═══════════════════════════════════════════════════════════════
+//                       MODEL REGISTRY
+// ═══════════════════════════════════════════════════════════════
+
+bool speech_stt_load_model(const char *model_path, bool activate,
+                           stt_on_model_loaded on_loaded, void *user) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    if (!g_models || model_path == nullptr) {
+        LOG_ERROR("Whisper not initialized");
+        return false;
+    }
+
+    SttModelRegistry::LoadCallback done;
+    if (on_loaded) {
+        done = [on_loaded, user](const std::string &path, bool ok) { on_loaded(path.c_str(), ok, user); };
+    }
+    g_models->load_async(model_path, activate, std::move(done));
+    return true;
+}
+
+bool speech_stt_unload_model(const char *model_path) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    return g_models && model_path != nullptr && g_models->unload(model_path);
+}
+
+char *speech_stt_resident_models(void) {
+    std::shared_lock<std::shared_mutex> lock(g_mutex);
+
+    std::string paths;
+    if (g_models) {
+        for (const std::string &path : g_models->resident()) {
+            if (!paths.empty()) paths += "\n";
+            paths += path;
+        }
+    }
+    return strdup_safe(paths);
 }
 
 void speech_free_string(char *ptr) {
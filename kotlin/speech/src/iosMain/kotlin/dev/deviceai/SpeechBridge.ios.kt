@@ -3,6 +3,7 @@ package dev.deviceai
 import androidx.compose.runtime.Composable
 import dev.deviceai.native.*
 import kotlinx.cinterop.*
+import kotlin.concurrent.AtomicReference
 import platform.Foundation.*
 
 /**
@@ -19,38 +20,171 @@ actual object SpeechBridge {
     //                    SPEECH-TO-TEXT (STT)
     // ══════════════════════════════════════════════════════════════
 
-    actual fun initStt(modelPath: String, config: SttConfig): Boolean {
-        return speech_stt_init(
+    // Phrases recognizeCommand falls back to, as given at init
+    private var initCommands: List<String> = emptyList()
+
+    actual fun initStt(modelPath: String, config: SttConfig): Boolean = memScoped {
+        val commands = allocArray<CPointerVar<ByteVar>>(config.commands.size)
+        config.commands.forEachIndexed { i, phrase -> commands[i] = phrase.cstr.ptr }
+        speech_stt_init(
             modelPath,
             config.language,
             config.translateToEnglish,
             config.maxThreads,
             config.useGpu,
-            config.useVad
-        )
+            config.useVad,
+            config.statePoolSize,
+            config.threadsPerState,
+            config.persistentState,
+            config.longForm,
+            config.warmUp,
+            config.pinDetectedLanguage,
+            config.resultCacheBytes,
+            config.resultCachePath,
+            config.modelMemoryBudgetBytes,
+            config.stopRepetitionLoops,
+            commands,
+            config.commands.size
+        ).also { if (it) initCommands = config.commands }
     }
 
-    actual fun transcribe(audioPath: String): String {
-        val result = speech_stt_transcribe(audioPath)
+    actual fun transcribe(audioPath: String, options: SttOptions): String {
+        val result = memScoped { speech_stt_transcribe(audioPath, nativeOptions(options)) }
         return result?.toKString()?.also { speech_free_string(result) } ?: ""
     }
 
-    actual fun transcribeDetailed(audioPath: String): TranscriptionResult {
-        val jsonResult = speech_stt_transcribe_detailed(audioPath)
+    actual fun transcribeDetailed(audioPath: String, options: SttOptions): TranscriptionResult {
+        val jsonResult = memScoped { speech_stt_transcribe_detailed(audioPath, nativeOptions(options)) }
         val jsonStr = jsonResult?.toKString()?.also { speech_free_string(jsonResult) } ?: "{}"
         return TranscriptionJsonParser.parse(jsonStr)
     }
 
-    actual fun transcribeAudio(samples: FloatArray): String {
+    actual fun transcribeAudio(samples: FloatArray, options: SttOptions): String {
+        if (samples.isEmpty()) return ""
+        val result = memScoped {
+            samples.usePinned { pinned ->
+                speech_stt_transcribe_audio(pinned.addressOf(0), samples.size, nativeOptions(options))
+            }
+        }
+        return result?.toKString()?.also { speech_free_string(result) } ?: ""
+    }
+
+    // Native copy of [options], valid for the enclosing memScoped block
+    private fun MemScope.nativeOptions(options: SttOptions): CPointer<speech_stt_options> {
+        val native = alloc<speech_stt_options>()
+        native.language = options.language?.cstr?.getPointer(this)
+        native.translate = options.translateToEnglish.toOverride()
+        native.single_segment = options.singleSegment.toOverride()
+        native.no_context = options.noContext.toOverride()
+        native.model = options.modelPath?.cstr?.getPointer(this)
+        native.timeout_ms = options.timeoutMs ?: 0L
+        native.split_channels = options.splitChannels.toOverride()
+        return native.ptr
+    }
+
+    private fun Boolean?.toOverride(): Int = when (this) {
+        null -> -1
+        false -> 0
+        true -> 1
+    }
+
+    actual fun detectLanguage(samples: FloatArray, topN: Int, options: SttOptions): List<LanguageProbability> {
+        if (samples.isEmpty()) return emptyList()
+        val result = memScoped {
+            samples.usePinned { pinned ->
+                speech_stt_detect_language(pinned.addressOf(0), samples.size, topN, nativeOptions(options))
+            }
+        }
+        val json = result?.toKString()?.also { speech_free_string(result) } ?: "[]"
+        return TranscriptionJsonParser.parseLanguages(json)
+    }
+
+    actual fun recognizeCommand(samples: FloatArray, commands: List<String>?, options: SttOptions): SttCommandMatch? {
+        if (samples.isEmpty()) return null
+        val phrases = commands ?: initCommands
+        val index = memScoped {
+            val nativeCommands = commands?.let { list ->
+                allocArray<CPointerVar<ByteVar>>(list.size).also { array ->
+                    list.forEachIndexed { i, phrase -> array[i] = phrase.cstr.ptr }
+                }
+            }
+            samples.usePinned { pinned ->
+                speech_stt_recognize_command(
+                    pinned.addressOf(0), samples.size, nativeCommands, commands?.size ?: 0, nativeOptions(options)
+                )
+            }
+        }
+        return phrases.getOrNull(index)?.let { SttCommandMatch(index, it) }
+    }
+
+    actual fun transcribeBatch(clips: List<FloatArray>, options: SttOptions): List<TranscriptionResult> {
+        val results = arrayOfNulls<TranscriptionResult>(clips.size)
+        val ref = StableRef.create(results)
+        memScoped {
+            val nativeClips = allocArray<CPointerVar<FloatVar>>(clips.size)
+            val lengths = allocArray<IntVar>(clips.size)
+            clips.forEachIndexed { i, clip ->
+                val nativeSamples = allocArray<FloatVar>(clip.size)
+                clip.forEachIndexed { index, value -> nativeSamples[index] = value }
+                nativeClips[i] = nativeSamples
+                lengths[i] = clip.size
+            }
+            speech_stt_transcribe_batch(
+                nativeClips, lengths, clips.size, nativeOptions(options),
+                batchResultCallback, ref.asCPointer()
+            )
+        }
+        ref.dispose()
+        return results.map { it ?: TranscriptionJsonParser.parse("{}") }
+    }
+
+    actual fun transcribeFilesBatch(audioPaths: List<String>, options: SttOptions): List<TranscriptionResult> {
+        val results = arrayOfNulls<TranscriptionResult>(audioPaths.size)
+        val ref = StableRef.create(results)
+        memScoped {
+            val nativePaths = allocArray<CPointerVar<ByteVar>>(audioPaths.size)
+            audioPaths.forEachIndexed { i, path -> nativePaths[i] = path.cstr.ptr }
+            speech_stt_transcribe_batch_files(
+                nativePaths, audioPaths.size, nativeOptions(options),
+                batchResultCallback, ref.asCPointer()
+            )
+        }
+        ref.dispose()
+        return results.map { it ?: TranscriptionJsonParser.parse("{}") }
+    }
+
+    actual fun transcribeAudioTasks(
+        samples: FloatArray,
+        tasks: List<SttTask>,
+        options: SttOptions
+    ): List<TranscriptionResult> {
+        val results = arrayOfNulls<TranscriptionResult>(tasks.size)
+        val ref = StableRef.create(results)
         memScoped {
             val nativeSamples = allocArray<FloatVar>(samples.size)
             samples.forEachIndexed { index, value -> nativeSamples[index] = value }
-            val result = speech_stt_transcribe_audio(nativeSamples, samples.size)
-            return result?.toKString()?.also { speech_free_string(result) } ?: ""
+            val nativeTasks = allocArray<speech_stt_task>(tasks.size)
+            tasks.forEachIndexed { i, task ->
+                nativeTasks[i].language = task.language?.cstr?.ptr
+                nativeTasks[i].translate = task.translateToEnglish?.let { if (it) 1 else 0 } ?: -1
+                nativeTasks[i].prompt = task.prompt?.cstr?.ptr
+            }
+            speech_stt_transcribe_audio_tasks(
+                nativeSamples, samples.size, nativeTasks, tasks.size, nativeOptions(options),
+                batchResultCallback, ref.asCPointer()
+            )
         }
+        ref.dispose()
+        return results.map { it ?: TranscriptionJsonParser.parse("{}") }
     }
 
-    actual fun transcribeStream(samples: FloatArray, callback: SttStream) {
+    private val batchResultCallback =
+        staticCFunction { index: Int, jsonResult: CPointer<ByteVar>?, userData: COpaquePointer? ->
+            val results = userData!!.asStableRef<Array<TranscriptionResult?>>().get()
+            results[index] = TranscriptionJsonParser.parse(jsonResult?.toKString() ?: "{}")
+        }
+
+    actual fun transcribeStream(samples: FloatArray, callback: SttStream, options: SttOptions) {
         memScoped {
             val nativeSamples = allocArray<FloatVar>(samples.size)
             samples.forEachIndexed { index, value -> nativeSamples[index] = value }
@@ -75,7 +209,7 @@ actual object SpeechBridge {
             }
 
             speech_stt_transcribe_stream(
-                nativeSamples, samples.size,
+                nativeSamples, samples.size, nativeOptions(options),
                 onPartial, onFinal, onError,
                 ref.asCPointer()
             )
@@ -84,6 +218,219 @@ actual object SpeechBridge {
         }
     }
 
+    actual fun openSttSession(callback: SttStream, options: SttOptions, finalModelPath: String?): SttSession? {
+        val ref = StableRef.create(callback)
+
+        val onPartial = staticCFunction { text: CPointer<ByteVar>?, userData: COpaquePointer? ->
+            val cb = userData!!.asStableRef<SttStream>().get()
+            cb.onPartialResult(text?.toKString() ?: "")
+        }
+
+        val onFinal = staticCFunction { jsonResult: CPointer<ByteVar>?, userData: COpaquePointer? ->
+            val cb = userData!!.asStableRef<SttStream>().get()
+            cb.onFinalResult(
+                TranscriptionJsonParser.parse(jsonResult?.toKString() ?: "{}")
+            )
+        }
+
+        val onError = staticCFunction { message: CPointer<ByteVar>?, userData: COpaquePointer? ->
+            val cb = userData!!.asStableRef<SttStream>().get()
+            cb.onError(message?.toKString() ?: "Unknown error")
+        }
+
+        val handle = memScoped {
+            speech_stt_session_open(
+                nativeOptions(options), finalModelPath, onPartial, onFinal, onError, ref.asCPointer()
+            )
+        }
+        if (handle == null) {
+            ref.dispose()
+            return null
+        }
+        return NativeSttSession(handle, ref)
+    }
+
+    // Cleared once by close(). A call racing the close may still pass the
+    // old handle down; native code ignores closed handles.
+    private class NativeSttSession(
+        handle: CPointer<speech_stt_session>,
+        private val ref: StableRef<SttStream>
+    ) : SttSession {
+        private val handle = AtomicReference<CPointer<speech_stt_session>?>(handle)
+
+        override fun pushAudio(samples: FloatArray) {
+            val h = handle.value ?: return
+            if (samples.isEmpty()) return
+            samples.usePinned { pinned ->
+                speech_stt_session_push(h, pinned.addressOf(0), samples.size)
+            }
+        }
+
+        override fun flush() {
+            handle.value?.let { speech_stt_session_flush(it) }
+        }
+
+        override fun stats(): SttSessionStats = memScoped {
+            val values = allocArray<LongVar>(4)
+            speech_stt_session_stats(handle.value, values)
+            SttSessionStats(values[0], values[1], values[2], values[3])
+        }
+
+        override fun close() {
+            val h = handle.getAndSet(null) ?: return
+            speech_stt_session_close(h)
+            ref.dispose()
+        }
+    }
+
+    actual fun startListening(
+        callback: SttListenerCallback,
+        options: SttOptions,
+        config: SttListenerConfig
+    ): SttListener? {
+        val ref = StableRef.create(callback)
+
+        val onSpeechStart = staticCFunction { timeMs: Long, userData: COpaquePointer? ->
+            val cb = userData!!.asStableRef<SttListenerCallback>().get()
+            cb.onSpeechStart(timeMs)
+        }
+
+        val onUtterance = staticCFunction { jsonResult: CPointer<ByteVar>?, userData: COpaquePointer? ->
+            val cb = userData!!.asStableRef<SttListenerCallback>().get()
+            cb.onUtterance(TranscriptionJsonParser.parse(jsonResult?.toKString() ?: "{}"))
+        }
+
+        val onError = staticCFunction { message: CPointer<ByteVar>?, userData: COpaquePointer? ->
+            val cb = userData!!.asStableRef<SttListenerCallback>().get()
+            cb.onError(message?.toKString() ?: "Unknown error")
+        }
+
+        val handle = memScoped {
+            speech_stt_listener_open(
+                nativeOptions(options),
+                config.preRollMs, config.endSilenceMs, config.minSpeechMs, config.maxUtteranceMs,
+                onSpeechStart, onUtterance, onError, ref.asCPointer()
+            )
+        }
+        if (handle == null) {
+            ref.dispose()
+            return null
+        }
+        return NativeSttListener(handle, ref)
+    }
+
+    // Cleared once by close(), like NativeSttSession's handle.
+    private class NativeSttListener(
+        handle: CPointer<speech_stt_listener>,
+        private val ref: StableRef<SttListenerCallback>
+    ) : SttListener {
+        private val handle = AtomicReference<CPointer<speech_stt_listener>?>(handle)
+
+        override fun pushAudio(samples: FloatArray) {
+            val h = handle.value ?: return
+            if (samples.isEmpty()) return
+            samples.usePinned { pinned ->
+                speech_stt_listener_push(h, pinned.addressOf(0), samples.size)
+            }
+        }
+
+        override fun close() {
+            val h = handle.getAndSet(null) ?: return
+            speech_stt_listener_close(h)
+            ref.dispose()
+        }
+    }
+
+    actual fun submitTranscription(
+        audioPath: String,
+        priority: SttPriority,
+        options: SttOptions,
+        callback: SttJobCallback
+    ): Long = submitJob(callback) { onResult, onError, user ->
+        memScoped {
+            speech_stt_submit_transcription(
+                audioPath, priority.ordinal, nativeOptions(options), onResult, onError, user
+            )
+        }
+    }
+
+    actual fun submitTranscriptionAudio(
+        samples: FloatArray,
+        priority: SttPriority,
+        options: SttOptions,
+        callback: SttJobCallback
+    ): Long = submitJob(callback) { onResult, onError, user ->
+        memScoped {
+            samples.usePinned { pinned ->
+                speech_stt_submit_transcription_audio(
+                    if (samples.isEmpty()) null else pinned.addressOf(0), samples.size, priority.ordinal,
+                    nativeOptions(options), onResult, onError, user
+                )
+            }
+        }
+    }
+
+    actual fun cancelSttJob(jobId: Long): Boolean = speech_stt_cancel_job(jobId)
+
+    // The callback ref is released by whichever native callback reports the job
+    private fun submitJob(
+        callback: SttJobCallback,
+        submit: (stt_on_job_result, stt_on_job_error, COpaquePointer) -> Long
+    ): Long {
+        val ref = StableRef.create(callback)
+        val onResult = staticCFunction { jobId: Long, jsonResult: CPointer<ByteVar>?, userData: COpaquePointer? ->
+            val cbRef = userData!!.asStableRef<SttJobCallback>()
+            cbRef.get().onResult(jobId, TranscriptionJsonParser.parse(jsonResult?.toKString() ?: "{}"))
+            cbRef.dispose()
+        }
+        val onError = staticCFunction { jobId: Long, message: CPointer<ByteVar>?, userData: COpaquePointer? ->
+            val cbRef = userData!!.asStableRef<SttJobCallback>()
+            cbRef.get().onError(jobId, message?.toKString() ?: "Unknown error")
+            cbRef.dispose()
+        }
+        val jobId = submit(onResult, onError, ref.asCPointer())
+        if (jobId == 0L) ref.dispose()
+        return jobId
+    }
+
+    actual fun getSttCacheStats(): SttCacheStats = memScoped {
+        val values = allocArray<LongVar>(5)
+        speech_stt_cache_stats(values)
+        SttCacheStats(values[0], values[1], values[2], values[3], values[4])
+    }
+
+    actual fun clearSttCache() = speech_stt_cache_clear()
+
+    actual fun getSttLoopStats(): SttLoopStats = memScoped {
+        val values = allocArray<LongVar>(2)
+        speech_stt_loop_stats(values)
+        SttLoopStats(values[0], values[1])
+    }
+
+    actual fun loadSttModel(modelPath: String, activate: Boolean, callback: SttModelCallback?): Boolean {
+        if (callback == null) return speech_stt_load_model(modelPath, activate, null, null)
+
+        // Released by the completion callback
+        val ref = StableRef.create(callback)
+        val onLoaded = staticCFunction { path: CPointer<ByteVar>?, ok: Boolean, userData: COpaquePointer? ->
+            val cbRef = userData!!.asStableRef<SttModelCallback>()
+            cbRef.get().onModelLoaded(path?.toKString() ?: "", ok)
+            cbRef.dispose()
+        }
+        val queued = speech_stt_load_model(modelPath, activate, onLoaded, ref.asCPointer())
+        if (!queued) ref.dispose()
+        return queued
+    }
+
+    actual fun unloadSttModel(modelPath: String): Boolean = speech_stt_unload_model(modelPath)
+
+    actual fun residentSttModels(): List<String> {
+        val result = speech_stt_resident_models() ?: return emptyList()
+        val paths = result.toKString()
+        speech_free_string(result)
+        return if (paths.isEmpty()) emptyList() else paths.split('\n')
+    }
+
     actual fun cancelStt() = speech_stt_cancel()
 
     actual fun shutdownStt() = speech_stt_shutdown()
@@ -7,9 +7,10 @@ package dev.deviceai
  *
  * Expected JSON format:
  * ```json
- * {"text":"...", "language":"en", "durationMs":1234,
+ * {"text":"...", "language":"en", "durationMs":1234, "partial":false,
  *  "segments":[{"text":"...","startMs":0,"endMs":500}]}
  * ```
+ * Segments of a per-channel transcription also carry `"channel":0`.
  */
 internal object TranscriptionJsonParser {
 
@@ -18,19 +19,42 @@ internal object TranscriptionJsonParser {
             val text       = extractString(json, "text") ?: ""
             val language   = extractString(json, "language") ?: "en"
             val durationMs = extractLong(json, "durationMs") ?: 0L
+            val partial    = extractBoolean(json, "partial") ?: false
+            val error      = extractString(json, "error")
             val segments   = parseSegments(json)
-            TranscriptionResult(text, segments, language, durationMs)
+            TranscriptionResult(text, segments, language, durationMs, partial, error)
         } catch (_: Exception) {
             TranscriptionResult("", emptyList(), "en", 0L)
         }
     }
 
+    /**
+     * Parses a language identification result:
+     * `[{"language":"en","probability":0.93}, ...]`
+     */
+    fun parseLanguages(json: String): List<LanguageProbability> = buildList {
+        Regex(
+            "\\{[^}]*\"language\"\\s*:\\s*\"([^\"]*)\"[^}]*" +
+                "\"probability\"\\s*:\\s*([0-9.eE+-]+)[^}]*\\}"
+        ).findAll(json).forEach { match ->
+            add(
+                LanguageProbability(
+                    language    = match.groupValues.getOrNull(1) ?: "",
+                    probability = match.groupValues.getOrNull(2)?.toFloatOrNull() ?: 0f
+                )
+            )
+        }
+    }
+
     private fun extractString(json: String, key: String): String? =
         Regex("\"$key\"\\s*:\\s*\"([^\"]*)\"").find(json)?.groupValues?.getOrNull(1)
 
     private fun extractLong(json: String, key: String): Long? =
         Regex("\"$key\"\\s*:\\s*(\\d+)").find(json)?.groupValues?.getOrNull(1)?.toLongOrNull()
 
+    private fun extractBoolean(json: String, key: String): Boolean? =
+        Regex("\"$key\"\\s*:\\s*(true|false)").find(json)?.groupValues?.getOrNull(1)?.toBoolean()
+
     private fun parseSegments(json: String): List<Segment> {
         val segmentsMatch = Regex("\"segments\"\\s*:\\s*\\[([^\\]]*)\\]").find(json)
             ?: return emptyList()
@@ -45,7 +69,8 @@ internal object TranscriptionJsonParser {
                     Segment(
                         text    = match.groupValues.getOrNull(1) ?: "",
                         startMs = match.groupValues.getOrNull(2)?.toLongOrNull() ?: 0L,
-                        endMs   = match.groupValues.getOrNull(3)?.toLongOrNull() ?: 0L
+                        endMs   = match.groupValues.getOrNull(3)?.toLongOrNull() ?: 0L,
+                        channel = extractLong(match.value, "channel")?.toInt() ?: -1
                     )
                 )
             }